@@ -5,14 +5,128 @@
  * @author Michael Albers
  */
 
+#include <algorithm>
+#include <cctype>
+#include <stdexcept>
+
 #include "ActionSymbol.h"
 
+constexpr uint32_t ActionSymbol::NUMBER_ROUTINES;
+constexpr ActionSymbol::Argument ActionSymbol::LHS_ARGUMENT;
+
+namespace
+{
+  /**
+   * Name (lower case) and number of arguments of a routine.
+   */
+  class RoutineDefinition
+  {
+    public:
+
+    /** Routine name, lower case. */
+    const char *myName;
+
+    /** Number of arguments the routine takes. */
+    uint32_t myNumberArguments;
+  };
+
+  /** Every routine, in Routine order. */
+  const RoutineDefinition ROUTINES[] = {
+    {"assign", 2},
+    {"copy", 2},
+    {"createscope", 0},
+    {"destroyscope", 0},
+    {"finish", 0},
+    {"geninfix", 4},
+    {"processid", 1},
+    {"processliteral", 1},
+    {"processop", 1},
+    {"readid", 1},
+    {"start", 0},
+    {"writeexpr", 1},
+  };
+
+  static_assert(sizeof(ROUTINES) / sizeof(ROUTINES[0]) ==
+                ActionSymbol::NUMBER_ROUTINES,
+                "Every routine needs a definition.");
+}
+
 //*******************************************************
 // ActionSymbol::ActionSymbol
 //*******************************************************
 ActionSymbol::ActionSymbol(const std::string &theName) :
   Symbol(theName)
 {
+  // #Routine or #Routine(arg,arg,...)
+  auto lParenPosition = theName.find('(');
+  std::string routineName{theName.substr(1, lParenPosition - 1)};
+  std::transform(routineName.begin(), routineName.end(),
+                 routineName.begin(), ::tolower);
+
+  uint32_t routine = 0;
+  while (routine < NUMBER_ROUTINES &&
+         routineName != ROUTINES[routine].myName)
+  {
+    ++routine;
+  }
+  if (NUMBER_ROUTINES == routine)
+  {
+    throw std::runtime_error{"Action symbol '" + theName +
+        "' calls an unknown semantic routine."};
+  }
+  myRoutine = static_cast<Routine>(routine);
+
+  if (lParenPosition != std::string::npos)
+  {
+    auto rParenPosition = theName.find(')', lParenPosition);
+    std::string argumentString{theName.substr(
+        lParenPosition+1, rParenPosition-lParenPosition-1)};
+
+    std::string::size_type tokenStart = 0;
+    while (tokenStart <= argumentString.size())
+    {
+      auto position = std::min(argumentString.find(',', tokenStart),
+                               argumentString.size());
+      std::string argument{argumentString.substr(tokenStart,
+                                                 position-tokenStart)};
+      tokenStart = position + 1;
+
+      if ("$$" == argument)
+      {
+        myArguments.push_back(LHS_ARGUMENT);
+      }
+      else if (argument.size() > 1 && argument.size() < 10 &&
+               '$' == argument[0] &&
+               std::all_of(argument.begin() + 1, argument.end(),
+                           ::isdigit) &&
+               std::stoul(argument.substr(1)) > 0)
+      {
+        myArguments.push_back(std::stoul(argument.substr(1)));
+      }
+      else
+      {
+        throw std::runtime_error{"Action symbol '" + theName +
+            "' has an invalid argument '" + argument +
+            "', expected $$ or $1, $2, ..."};
+      }
+    }
+  }
+
+  if (myArguments.size() != ROUTINES[routine].myNumberArguments)
+  {
+    throw std::runtime_error{"Action symbol '" + theName + "' has " +
+        std::to_string(myArguments.size()) + " argument(s), the routine " +
+        "takes " + std::to_string(ROUTINES[routine].myNumberArguments) + "."};
+  }
+}
+
+//*******************************************************
+// ActionSymbol::getArguments
+//*******************************************************
+const std::vector<ActionSymbol::Argument>& ActionSymbol::getArguments()
+  const noexcept
+{
+  return myArguments;
 }
 
 //*******************************************************
@@ -22,3 +136,11 @@ bool ActionSymbol::getDerivesLambda() const noexcept
 {
   return false;
 }
+
+//*******************************************************
+// ActionSymbol::getRoutine
+//*******************************************************
+ActionSymbol::Routine ActionSymbol::getRoutine() const noexcept
+{
+  return myRoutine;
+}
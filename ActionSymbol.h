@@ -8,12 +8,21 @@
  * @author Michael Albers
  */
 
+#include <cstdint>
+#include <string>
+#include <vector>
+
 #include "Symbol.h"
 
 /**
  * Class for a action symbol in a grammer. An action symbol represents a
  * call to a semantic function. Not a symbol in the traditional grammar
  * sense.
+ *
+ * The text of the symbol, "#Routine($1,$$)", is decoded once when the
+ * symbol is created: the routine name into a Routine and each argument
+ * into an Argument, so executing it (see SemanticRoutines) needs no string
+ * handling.
  */
 class ActionSymbol : public Symbol
 {
@@ -22,6 +31,39 @@ class ActionSymbol : public Symbol
   // ************************************************************
   public:
 
+  /**
+   * Semantic routines an action symbol can call. Names are matched ignoring
+   * case.
+   */
+  enum class Routine : uint8_t
+  {
+    Assign,
+    Copy,
+    CreateScope,
+    DestroyScope,
+    Finish,
+    GenInfix,
+    ProcessId,
+    ProcessLiteral,
+    ProcessOp,
+    ReadId,
+    Start,
+    WriteExpr
+  };
+
+  /** Number of Routine values. */
+  static constexpr uint32_t NUMBER_ROUTINES =
+    static_cast<uint32_t>(Routine::WriteExpr) + 1;
+
+  /**
+   * Routine argument: a semantic stack offset, LHS_ARGUMENT for "$$" or N
+   * for "$N" (see SemanticStack::getRecordFromArgument).
+   */
+  using Argument = uint32_t;
+
+  /** Argument value of "$$". */
+  static constexpr Argument LHS_ARGUMENT = 0;
+
   /**
    * Default constructor.
    */
@@ -38,10 +80,13 @@ class ActionSymbol : public Symbol
   ActionSymbol(ActionSymbol &&) = default;
 
   /**
-   * Constructor.
+   * Constructor. Decodes the routine and arguments from the name.
    *
    * @param theName
    *          symbol name
+   * @throws std::runtime_error
+   *          if the routine is unknown, or the arguments are malformed or
+   *          not what the routine takes
    */
   ActionSymbol(const std::string &theName);
 
@@ -57,6 +102,20 @@ class ActionSymbol : public Symbol
    */
   virtual bool getDerivesLambda() const noexcept override;
 
+  /**
+   * Returns the routine arguments, in order.
+   *
+   * @return arguments
+   */
+  const std::vector<Argument>& getArguments() const noexcept;
+
+  /**
+   * Returns the routine the symbol calls.
+   *
+   * @return routine
+   */
+  Routine getRoutine() const noexcept;
+
   /**
    * Copy assignment operator.
    */
@@ -76,6 +135,12 @@ class ActionSymbol : public Symbol
   // Private
   // ************************************************************
   private:
+
+  /** Routine arguments, in order. */
+  std::vector<Argument> myArguments;
+
+  /** Routine the symbol calls. */
+  Routine myRoutine;
 };
 
 #endif
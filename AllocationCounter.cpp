@@ -0,0 +1,59 @@
+/**
+ * @file AllocationCounter.cpp
+ * @brief Counts the heap allocations of a program
+ *
+ * Linked into a program, replaces the global operator new with one that
+ * counts its calls, and prints the count to standard error as the program
+ * exits:
+ *
+ *   allocations: N
+ *
+ * The bench-alloc Makefile target links it with the compiler's objects.
+ * It uses nothing from the compiler, so it can be linked with the objects
+ * of an older revision to compare against it.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+  /** Number of calls to operator new. */
+  unsigned long long theAllocations = 0;
+
+  /**
+   * Prints theAllocations when destroyed, at exit.
+   */
+  struct AllocationPrinter
+  {
+    ~AllocationPrinter()
+    {
+      std::fprintf(stderr, "allocations: %llu\n", theAllocations);
+    }
+  } thePrinter;
+}
+
+//*******************************************************
+// operator new
+//*******************************************************
+void* operator new(std::size_t theSize)
+{
+  ++theAllocations;
+  auto memory = std::malloc(0 == theSize ? 1 : theSize);
+  if (nullptr == memory)
+  {
+    throw std::bad_alloc();
+  }
+  return memory;
+}
+
+//*******************************************************
+// operator delete
+//*******************************************************
+void operator delete(void *theMemory) noexcept
+{
+  std::free(theMemory);
+}
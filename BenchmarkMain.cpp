@@ -0,0 +1,547 @@
+/**
+ * @file BenchmarkMain.cpp
+ * @brief Entry point of the benchmarks of the compiler's parts
+ *
+ * Each benchmark runs a part of the compiler in process, on the grammars
+ * and sources given, and prints a table of its measurements. Times are the
+ * best of RUNS runs. The bench-* Makefile targets run them on generated
+ * inputs, see SyntheticInputGenerator.
+ *
+ * @author Michael Albers
+ */
+
+#include <sys/resource.h>
+#include <sys/stat.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "ErrorWarningTracker.h"
+#include "Grammar.h"
+#include "GrammarAnalyzer.h"
+#include "ParseTracer.h"
+#include "Parser.h"
+#include "PredictTable.h"
+#include "Scanner.h"
+#include "ScannerTable.h"
+#include "SemanticRoutines.h"
+#include "SemanticStack.h"
+#include "SymbolRegistry.h"
+#include "SymbolTable.h"
+#include "Token.h"
+
+namespace
+{
+  /** Number of times each measurement is taken. */
+  constexpr uint32_t RUNS = 3;
+
+  /** Clock the benchmarks are timed with. */
+  using Clock = std::chrono::steady_clock;
+
+  /**
+   * Returns the time since the given start.
+   *
+   * @param theStart
+   *          start time
+   * @return milliseconds since theStart
+   */
+  double getMilliseconds(Clock::time_point theStart)
+  {
+    return std::chrono::duration<double, std::milli>(
+      Clock::now() - theStart).count();
+  }
+
+  /**
+   * Records when the parser has the first token.
+   */
+  class FirstTokenTimer : public ParseTracer
+  {
+    public:
+
+    void action(const ActionSymbol&) override {}
+
+    void begin(const Token&) override
+    {
+      myFirstToken = Clock::now();
+    }
+
+    void beginStep(const Token&) override {}
+
+    void endOfProduction(const SemanticStack::Frame&) override {}
+
+    void endStep(const Token&) override {}
+
+    void finish() override {}
+
+    void match(const Token&) override {}
+
+    void predict(uint32_t, const SemanticStack::Frame&, bool) override {}
+
+    void skip(Symbol::Index) override {}
+
+    void start() override {}
+
+    /** Time the first token was scanned. */
+    Clock::time_point myFirstToken;
+  };
+
+  /**
+   * Compiles a source, as the compiler does without options, and prints a
+   * row of benchmarkCompile's table. Must run in its own process, so the
+   * peak memory is the compile's alone.
+   *
+   * @param theGrammarFile
+   *          grammar to compile with
+   * @param theSourceFile
+   *          source to compile
+   */
+  void compile(const std::string &theGrammarFile,
+               const std::string &theSourceFile)
+  {
+    ErrorWarningTracker ewTracker(theSourceFile);
+    ScannerTable scannerTable;
+    Grammar grammar(theGrammarFile, ewTracker, scannerTable);
+    GrammarAnalyzer grammarAnalyzer(grammar);
+    PredictTable predictTable(grammar);
+
+    auto start = Clock::now();
+    Scanner scanner(theSourceFile, scannerTable, ewTracker, false);
+    SemanticStack semanticStack;
+    SymbolTable symbolTable;
+    SemanticRoutines semanticRoutines("/dev/null", semanticStack,
+                                      symbolTable, ewTracker);
+    FirstTokenTimer timer;
+    Parser parser(scanner, grammar, predictTable, semanticStack,
+                  semanticRoutines, ewTracker, &timer);
+    auto parseMilliseconds = getMilliseconds(start);
+
+    struct stat sourceStat;
+    struct rusage usage;
+    if (0 != ::stat(theSourceFile.c_str(), &sourceStat) ||
+        0 != ::getrusage(RUSAGE_SELF, &usage))
+    {
+      throw std::runtime_error("Failed to measure '" + theSourceFile + "'.");
+    }
+
+    std::cout << std::left << std::setw(36) << theSourceFile << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10)
+              << sourceStat.st_size / 1e6 << std::setw(16)
+              << std::chrono::duration<double, std::milli>(
+                timer.myFirstToken - start).count()
+              << std::setw(12) << parseMilliseconds << std::setw(14)
+              << usage.ru_maxrss / 1e3 << std::endl;
+  }
+
+  /**
+   * Compiles each source in a child process, and prints the time the
+   * parser waits for the first token, the time to parse and the peak
+   * memory. Times start once the grammar has been analyzed.
+   *
+   * @param theGrammarFile
+   *          grammar to compile with
+   * @param theSourceFiles
+   *          sources to compile
+   * @throws std::runtime_error
+   *          if a compile fails
+   */
+  void benchmarkCompile(const std::string &theGrammarFile,
+                        const std::vector<std::string> &theSourceFiles)
+  {
+    std::cout << std::left << std::setw(36) << "source" << std::right
+              << std::setw(10) << "MB" << std::setw(16) << "first token ms"
+              << std::setw(12) << "parse ms" << std::setw(14) << "peak RSS MB"
+              << std::endl;
+    for (const auto &sourceFile : theSourceFiles)
+    {
+      auto child = ::fork();
+      if (0 == child)
+      {
+        try
+        {
+          compile(theGrammarFile, sourceFile);
+        }
+        catch (const std::exception &exception)
+        {
+          std::cerr << exception.what() << std::endl;
+          std::exit(1);
+        }
+        std::exit(0);
+      }
+
+      int status = 0;
+      if (child < 0 || ::waitpid(child, &status, 0) != child ||
+          ! WIFEXITED(status) || 0 != WEXITSTATUS(status))
+      {
+        throw std::runtime_error("Failed to compile '" + sourceFile + "'.");
+      }
+    }
+  }
+
+  /**
+   * Scans a source with the generated scanner of a scanner table and with
+   * the table itself, side by side, checking they scan the same tokens.
+   *
+   * @param theSourceFile
+   *          source to scan
+   * @param theScannerTable
+   *          table of the grammar to scan with
+   * @return number of tokens
+   * @throws std::runtime_error
+   *          if the scanners' tokens differ
+   */
+  uint64_t compareScanners(const std::string &theSourceFile,
+                           ScannerTable &theScannerTable)
+  {
+    ErrorWarningTracker tableEWTracker(theSourceFile, true);
+    ErrorWarningTracker directEWTracker(theSourceFile, true);
+    Scanner tableScanner(theSourceFile, theScannerTable, tableEWTracker,
+                         false, false);
+    Scanner directScanner(theSourceFile, theScannerTable, directEWTracker,
+                          false, true);
+    uint64_t numberTokens = 0;
+    while (true)
+    {
+      auto tableToken = tableScanner.scan();
+      auto directToken = directScanner.scan();
+      ++numberTokens;
+      if (tableToken.getTerminalIndex() != directToken.getTerminalIndex() ||
+          tableToken.getToken() != directToken.getToken() ||
+          tableToken.getLine() != directToken.getLine() ||
+          tableToken.getColumn() != directToken.getColumn())
+      {
+        throw std::runtime_error(
+          theSourceFile + ": token " + std::to_string(numberTokens) +
+          " of the generated scanner differs from the scanner table's.");
+      }
+      if (tableToken.getTerminal() == theScannerTable.getEOF().get())
+      {
+        return numberTokens;
+      }
+    }
+  }
+
+  /**
+   * Scans a source to the end.
+   *
+   * @param theSourceFile
+   *          source to scan
+   * @param theScannerTable
+   *          table of the grammar to scan with
+   * @param theUseDirectScanner
+   *          scan with the generated scanner of the table, if there is one
+   * @return time to scan, in milliseconds
+   */
+  double scan(const std::string &theSourceFile, ScannerTable &theScannerTable,
+              bool theUseDirectScanner)
+  {
+    ErrorWarningTracker ewTracker(theSourceFile, true);
+    auto start = Clock::now();
+    Scanner scanner(theSourceFile, theScannerTable, ewTracker, false,
+                    theUseDirectScanner);
+    while (scanner.scan().getTerminal() != theScannerTable.getEOF().get())
+    {
+    }
+    return getMilliseconds(start);
+  }
+
+  /**
+   * Compares the generated scanner of a grammar with its scanner table:
+   * checks both scan the same tokens from each source, then prints their
+   * throughput.
+   *
+   * @param theGrammarFile
+   *          grammar to scan with
+   * @param theSourceFiles
+   *          sources to scan
+   * @throws std::runtime_error
+   *          if the scanners' tokens differ
+   */
+  void benchmarkScan(const std::string &theGrammarFile,
+                     const std::vector<std::string> &theSourceFiles)
+  {
+    ErrorWarningTracker ewTracker(theGrammarFile);
+    ScannerTable scannerTable;
+    Grammar grammar(theGrammarFile, ewTracker, scannerTable);
+
+    std::cout << std::left << std::setw(36) << "source" << std::right
+              << std::setw(10) << "MB" << std::setw(12) << "tokens"
+              << std::setw(12) << "table MB/s" << std::setw(13)
+              << "direct MB/s" << std::endl;
+    for (const auto &sourceFile : theSourceFiles)
+    {
+      auto numberTokens = compareScanners(sourceFile, scannerTable);
+
+      auto tableBest = std::numeric_limits<double>::max();
+      auto directBest = std::numeric_limits<double>::max();
+      for (uint32_t run = 0; run < RUNS; ++run)
+      {
+        tableBest = std::min(tableBest,
+                             scan(sourceFile, scannerTable, false));
+        directBest = std::min(directBest,
+                              scan(sourceFile, scannerTable, true));
+      }
+
+      struct stat sourceStat;
+      if (0 != ::stat(sourceFile.c_str(), &sourceStat))
+      {
+        throw std::runtime_error("Failed to stat '" + sourceFile + "'.");
+      }
+      double megabytes = sourceStat.st_size / 1e6;
+      std::cout << std::left << std::setw(36) << sourceFile << std::right
+                << std::fixed << std::setprecision(2) << std::setw(10)
+                << megabytes << std::setw(12) << numberTokens
+                << std::setw(12) << megabytes * 1e3 / tableBest
+                << std::setw(13) << megabytes * 1e3 / directBest
+                << std::endl;
+    }
+  }
+
+  /**
+   * Times closing a grammar's first and follow sets over the includes
+   * relation (see GrammarAnalyzer::getClosureTime).
+   *
+   * @param theGrammarFile
+   *          grammar to analyze
+   * @param theMode
+   *          how the analyzer propagates sets
+   * @return best time, in milliseconds
+   */
+  double timeClosure(const std::string &theGrammarFile,
+                     GrammarAnalyzer::Mode theMode)
+  {
+    auto best = std::numeric_limits<double>::max();
+    for (uint32_t run = 0; run < RUNS; ++run)
+    {
+      ErrorWarningTracker ewTracker(theGrammarFile);
+      ScannerTable scannerTable;
+      Grammar grammar(theGrammarFile, ewTracker, scannerTable);
+
+      GrammarAnalyzer grammarAnalyzer(grammar, theMode);
+      best = std::min(best, std::chrono::duration<double, std::milli>(
+                        grammarAnalyzer.getClosureTime()).count());
+    }
+    return best;
+  }
+
+  /**
+   * Compares the analyzer's modes (see GrammarAnalyzer::Mode) on the part
+   * of the analysis they differ in, closing the first and follow sets. The
+   * digraph mode does one set union per edge of the includes relation, so
+   * its time per production only grows with the width of the sets (the
+   * number of terminals).
+   *
+   * @param theGrammarFiles
+   *          grammars to analyze
+   */
+  void benchmarkAnalysis(const std::vector<std::string> &theGrammarFiles)
+  {
+    std::cout << std::left << std::setw(28) << "grammar" << std::right
+              << std::setw(12) << "productions" << std::setw(13)
+              << "worklist ms" << std::setw(12) << "digraph ms"
+              << std::setw(15) << "digraph ns/p" << std::endl;
+    for (const auto &grammarFile : theGrammarFiles)
+    {
+      uint32_t numberProductions;
+      {
+        ErrorWarningTracker ewTracker(grammarFile);
+        ScannerTable scannerTable;
+        Grammar grammar(grammarFile, ewTracker, scannerTable);
+        numberProductions = grammar.getProductions().size();
+      }
+
+      auto digraph = timeClosure(grammarFile, GrammarAnalyzer::Mode::Digraph);
+      std::cout << std::left << std::setw(28) << grammarFile << std::right
+                << std::setw(12) << numberProductions << std::fixed
+                << std::setprecision(2) << std::setw(13)
+                << timeClosure(grammarFile, GrammarAnalyzer::Mode::Worklist)
+                << std::setw(12) << digraph << std::setprecision(1)
+                << std::setw(15) << digraph * 1e6 / numberProductions
+                << std::endl;
+    }
+  }
+
+  /**
+   * Times looking up every entry of a predict table.
+   *
+   * @param thePredictTable
+   *          table to look up
+   * @param theSymbols
+   *          symbols of the table's grammar
+   * @return best time per lookup, in nanoseconds
+   */
+  double timeLookups(const PredictTable &thePredictTable,
+                     const SymbolRegistry &theSymbols)
+  {
+    static constexpr uint32_t PASSES = 100;
+
+    auto nonTerminalBegin =
+      theSymbols.getBegin(SymbolRegistry::Kind::NonTerminal);
+    auto nonTerminalEnd = theSymbols.getEnd(SymbolRegistry::Kind::NonTerminal);
+    auto numberTerminals = theSymbols.getEnd(SymbolRegistry::Kind::Terminal);
+    double lookups = static_cast<double>(PASSES) *
+      (nonTerminalEnd - nonTerminalBegin) * numberTerminals;
+
+    auto best = std::numeric_limits<double>::max();
+    volatile uint32_t sink = 0;
+    for (uint32_t run = 0; run < RUNS; ++run)
+    {
+      uint32_t sum = 0;
+      auto start = Clock::now();
+      for (uint32_t pass = 0; pass < PASSES; ++pass)
+      {
+        for (auto nonTerminal = nonTerminalBegin;
+             nonTerminal < nonTerminalEnd; ++nonTerminal)
+        {
+          for (Symbol::Index terminal = 0; terminal < numberTerminals;
+               ++terminal)
+          {
+            sum += thePredictTable.getProductionNumber(nonTerminal, terminal);
+          }
+        }
+      }
+      best = std::min(best, getMilliseconds(start) * 1e6 / lookups);
+      sink = sum;
+    }
+    static_cast<void>(sink);
+    return best;
+  }
+
+  /**
+   * Compares the predict table's representations (see
+   * PredictTable::Representation): checks every entry is the same in both,
+   * then prints their sizes and lookup times.
+   *
+   * @param theGrammarFiles
+   *          grammars to build tables of
+   * @throws std::runtime_error
+   *          if an entry differs
+   */
+  void benchmarkPredict(const std::vector<std::string> &theGrammarFiles)
+  {
+    std::cout << std::left << std::setw(36) << "grammar" << std::right
+              << std::setw(12) << "dense B" << std::setw(14)
+              << "compressed B" << std::setw(12) << "dense ns"
+              << std::setw(15) << "compressed ns" << std::setw(12)
+              << "default" << std::endl;
+    for (const auto &grammarFile : theGrammarFiles)
+    {
+      ErrorWarningTracker ewTracker(grammarFile);
+      ScannerTable scannerTable;
+      Grammar grammar(grammarFile, ewTracker, scannerTable);
+      GrammarAnalyzer grammarAnalyzer(grammar);
+      PredictTable dense(grammar, PredictTable::Representation::Dense);
+      PredictTable compressed(grammar,
+                              PredictTable::Representation::Compressed);
+      PredictTable chosen(grammar);
+
+      const auto &symbols = grammar.getSymbolRegistry();
+      for (auto nonTerminal =
+             symbols.getBegin(SymbolRegistry::Kind::NonTerminal);
+           nonTerminal < symbols.getEnd(SymbolRegistry::Kind::NonTerminal);
+           ++nonTerminal)
+      {
+        // One past the terminals is the terminal of a lexical error.
+        for (Symbol::Index terminal = 0;
+             terminal <= symbols.getEnd(SymbolRegistry::Kind::Terminal);
+             ++terminal)
+        {
+          if (dense.getProductionNumber(nonTerminal, terminal) !=
+              compressed.getProductionNumber(nonTerminal, terminal))
+          {
+            throw std::runtime_error(
+              grammarFile + ": compressed predict table differs at " +
+              symbols.getName(nonTerminal) + ", " +
+              std::to_string(terminal) + ".");
+          }
+        }
+      }
+
+      std::cout << std::left << std::setw(36) << grammarFile << std::right
+                << std::setw(12) << dense.getSize() << std::setw(14)
+                << compressed.getSize() << std::fixed
+                << std::setprecision(2) << std::setw(12)
+                << timeLookups(dense, symbols) << std::setw(15)
+                << timeLookups(compressed, symbols) << std::setw(12)
+                << (PredictTable::Representation::Dense ==
+                    chosen.getRepresentation() ? "dense" : "compressed")
+                << std::endl;
+    }
+  }
+}
+
+static void usage(char *theProgramName);
+
+int main(int argc, char **argv)
+{
+  try
+  {
+    if (argc < 3)
+    {
+      throw std::runtime_error("No benchmark and/or input files provided.");
+    }
+
+    std::string benchmark(argv[1]);
+    std::vector<std::string> files(argv + 2, argv + argc);
+
+    if ("analysis" == benchmark)
+    {
+      benchmarkAnalysis(files);
+    }
+    else if ("compile" == benchmark)
+    {
+      benchmarkCompile(files.front(),
+                       std::vector<std::string>(files.begin() + 1,
+                                                files.end()));
+    }
+    else if ("predict" == benchmark)
+    {
+      benchmarkPredict(files);
+    }
+    else if ("scan" == benchmark)
+    {
+      benchmarkScan(files.front(),
+                    std::vector<std::string>(files.begin() + 1,
+                                             files.end()));
+    }
+    else
+    {
+      throw std::runtime_error("Unknown benchmark '" + benchmark + "'.");
+    }
+  }
+  catch (const std::exception &exception)
+  {
+    if (std::string(exception.what()).size() > 0)
+    {
+      std::cerr << argv[0] << ": error: " << exception.what() << std::endl;
+    }
+    usage(argv[0]);
+    return 1;
+  }
+
+  return 0;
+}
+
+void usage(char *theProgramName)
+{
+  std::cerr << "Usage: " << theProgramName
+            << " [benchmark] [input files...]" << std::endl
+            << " Benchmarks:" << std::endl
+            << " analysis [grammar files...]  time closing the first and"
+            << " follow sets with each GrammarAnalyzer mode" << std::endl
+            << " compile [grammar file] [source files...]  time to the"
+            << " first token, parse time and peak memory of compiling each"
+            << " source" << std::endl
+            << " predict [grammar files...]  compare the predict table's"
+            << " representations" << std::endl
+            << " scan [grammar file] [source files...]  compare the"
+            << " grammar's generated scanner with its scanner table"
+            << std::endl;
+}
@@ -0,0 +1,106 @@
+/**
+ * @file BitSet.cpp
+ * @brief Implementation of BitSet class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+
+#include "BitSet.h"
+
+constexpr uint32_t BitSet::WORD_BITS;
+
+//*******************************************************
+// BitSet::BitSet
+//*******************************************************
+BitSet::BitSet(uint32_t theSize) :
+  mySize(theSize),
+  myWords((theSize + WORD_BITS - 1) / WORD_BITS, 0)
+{
+}
+
+//*******************************************************
+// BitSet::clear
+//*******************************************************
+void BitSet::clear() noexcept
+{
+  std::fill(myWords.begin(), myWords.end(), 0);
+}
+
+//*******************************************************
+// BitSet::contains
+//*******************************************************
+bool BitSet::contains(uint32_t theBit) const noexcept
+{
+  return (myWords[theBit / WORD_BITS] >> (theBit % WORD_BITS)) & 1;
+}
+
+//*******************************************************
+// BitSet::erase
+//*******************************************************
+void BitSet::erase(uint32_t theBit) noexcept
+{
+  myWords[theBit / WORD_BITS] &= ~(Word{1} << (theBit % WORD_BITS));
+}
+
+//*******************************************************
+// BitSet::getSize
+//*******************************************************
+uint32_t BitSet::getSize() const noexcept
+{
+  return mySize;
+}
+
+//*******************************************************
+// BitSet::insert
+//*******************************************************
+bool BitSet::insert(uint32_t theBit) noexcept
+{
+  auto &word = myWords[theBit / WORD_BITS];
+  auto mask = Word{1} << (theBit % WORD_BITS);
+  bool inserted = (word & mask) == 0;
+  word |= mask;
+  return inserted;
+}
+
+//*******************************************************
+// BitSet::insert
+//*******************************************************
+bool BitSet::insert(const BitSet &theOther) noexcept
+{
+  // No early exit, so the loop vectorizes.
+  Word changed = 0;
+  Word *words = myWords.data();
+  const Word *otherWords = theOther.myWords.data();
+  auto numberWords = myWords.size();
+  for (decltype(numberWords) ii = 0; ii < numberWords; ++ii)
+  {
+    changed |= otherWords[ii] & ~words[ii];
+    words[ii] |= otherWords[ii];
+  }
+  return changed != 0;
+}
+
+//*******************************************************
+// BitSet::next
+//*******************************************************
+uint32_t BitSet::next(uint32_t theBit) const noexcept
+{
+  if (theBit >= mySize)
+  {
+    return mySize;
+  }
+
+  auto wordIndex = theBit / WORD_BITS;
+  auto word = myWords[wordIndex] & (~Word{0} << (theBit % WORD_BITS));
+  while (0 == word)
+  {
+    if (++wordIndex == myWords.size())
+    {
+      return mySize;
+    }
+    word = myWords[wordIndex];
+  }
+  return wordIndex * WORD_BITS + __builtin_ctzll(word);
+}
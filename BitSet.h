@@ -0,0 +1,146 @@
+#ifndef BITSET_H
+#define BITSET_H
+
+/**
+ * @file BitSet.h
+ * @brief Fixed size set of small integers.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <vector>
+
+/**
+ * Set of the integers [0, size), stored one bit per integer. Used by
+ * GrammarAnalyzer to hold first/follow/predict sets over symbol indices
+ * (see Symbol::getIndex), where a union is a handful of word-wise ORs
+ * instead of a tree insert per symbol.
+ */
+class BitSet
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor. Creates an empty set of size 0.
+   */
+  BitSet() = default;
+
+  /**
+   * Copy constructor
+   */
+  BitSet(const BitSet&) = default;
+
+  /**
+   * Move constructor
+   */
+  BitSet(BitSet&&) = default;
+
+  /**
+   * Constructor. Creates an empty set.
+   *
+   * @param theSize
+   *          number of integers the set can hold
+   */
+  BitSet(uint32_t theSize);
+
+  /**
+   * Destructor
+   */
+  ~BitSet() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  BitSet& operator=(const BitSet&) = default;
+
+  /**
+   * Move assignment operator
+   */
+  BitSet& operator=(BitSet&&) = default;
+
+  /**
+   * Removes all integers from the set.
+   */
+  void clear() noexcept;
+
+  /**
+   * Returns true if the given integer is in the set.
+   *
+   * @param theBit
+   *          integer to check, less than getSize()
+   * @return true if theBit is in the set
+   */
+  bool contains(uint32_t theBit) const noexcept;
+
+  /**
+   * Removes the given integer from the set.
+   *
+   * @param theBit
+   *          integer to remove, less than getSize()
+   */
+  void erase(uint32_t theBit) noexcept;
+
+  /**
+   * Returns the size the set was created with.
+   *
+   * @return number of integers the set can hold
+   */
+  uint32_t getSize() const noexcept;
+
+  /**
+   * Adds the given integer to the set.
+   *
+   * @param theBit
+   *          integer to add, less than getSize()
+   * @return true if theBit wasn't already in the set
+   */
+  bool insert(uint32_t theBit) noexcept;
+
+  /**
+   * Adds the contents of the given set to this set.
+   *
+   * @param theOther
+   *          set to add, the same size as this set
+   * @return true if this set changed
+   */
+  bool insert(const BitSet &theOther) noexcept;
+
+  /**
+   * Returns the first integer in the set which is at least the given one.
+   * Iterate over a set with:
+   *   for (auto ii = set.next(0); ii < set.getSize(); ii = set.next(ii+1))
+   *
+   * @param theBit
+   *          integer to start at
+   * @return next integer in the set, getSize() if there is none
+   */
+  uint32_t next(uint32_t theBit) const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Storage unit. */
+  using Word = uint64_t;
+
+  /** Number of bits in a Word. */
+  static constexpr uint32_t WORD_BITS = 64;
+
+  /** Number of integers the set can hold. */
+  uint32_t mySize = 0;
+
+  /** The set, bit N of word M is integer M*WORD_BITS + N. */
+  std::vector<Word> myWords;
+};
+
+#endif
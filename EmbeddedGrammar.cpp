@@ -0,0 +1,54 @@
+/**
+ * @file EmbeddedGrammar.cpp
+ * @brief Implementation of EmbeddedGrammar class
+ *
+ * @author Michael Albers
+ */
+
+#include "EmbeddedGrammar.h"
+
+//*******************************************************
+// EmbeddedGrammar::find
+//*******************************************************
+const EmbeddedGrammar* EmbeddedGrammar::find(const std::string &theName)
+  noexcept
+{
+  const auto &grammars = getGrammars();
+  auto grammar = grammars.find(theName);
+  return grammar == grammars.end() ? nullptr : grammar->second;
+}
+
+//*******************************************************
+// EmbeddedGrammar::getGrammars
+//*******************************************************
+std::map<std::string, const EmbeddedGrammar*>& EmbeddedGrammar::getGrammars()
+  noexcept
+{
+  // Function local so it exists before the generated code registers with it
+  // during static initialization.
+  static std::map<std::string, const EmbeddedGrammar*> grammars;
+  return grammars;
+}
+
+//*******************************************************
+// EmbeddedGrammar::getNames
+//*******************************************************
+std::vector<std::string> EmbeddedGrammar::getNames()
+{
+  std::vector<std::string> names;
+  for (const auto &grammar : getGrammars())
+  {
+    names.push_back(grammar.first);
+  }
+  return names;
+}
+
+//*******************************************************
+// EmbeddedGrammar::registerGrammar
+//*******************************************************
+bool EmbeddedGrammar::registerGrammar(const EmbeddedGrammar &theGrammar)
+  noexcept
+{
+  getGrammars()[theGrammar.myName] = &theGrammar;
+  return true;
+}
@@ -0,0 +1,96 @@
+#ifndef EMBEDDEDGRAMMAR_H
+#define EMBEDDEDGRAMMAR_H
+
+/**
+ * @file EmbeddedGrammar.h
+ * @brief Defines a grammar compiled into the program.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "PredictTable.h"
+#include "ScannerTable.h"
+
+/**
+ * A grammar whose analyzed tables are compiled into the program, so it can
+ * be used without reading or analyzing the grammar file. The scanner and
+ * predict tables are typed constexpr arrays written by
+ * GrammarTablesGenerator, which the ScannerTable and PredictTable point at
+ * without copying (see ScannerTable::Tables and PredictTable::Tables), so
+ * they are read-only data shared by every process running the program. The
+ * symbols and productions are the payload of a GrammarCache, loaded through
+ * GrammarCache::Reader like a cache file.
+ *
+ * The generated source of each grammar in EMBEDDED_GRAMMARS (see the
+ * Makefile) registers its grammar during static initialization.
+ */
+class EmbeddedGrammar
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Returns the embedded grammar with the given name.
+   *
+   * @param theName
+   *          grammar name
+   * @return grammar, null if there is no such grammar
+   */
+  static const EmbeddedGrammar* find(const std::string &theName) noexcept;
+
+  /**
+   * Returns the names of the embedded grammars.
+   *
+   * @return grammar names
+   */
+  static std::vector<std::string> getNames();
+
+  /**
+   * Registers an embedded grammar. Called during static initialization by
+   * the generated code.
+   *
+   * @param theGrammar
+   *          grammar to register, must outlive the program
+   * @return true
+   */
+  static bool registerGrammar(const EmbeddedGrammar &theGrammar) noexcept;
+
+  /** Name of the grammar, the grammar file name without its extension. */
+  const char *myName;
+
+  /** Grammar file the tables were generated from. */
+  const char *myGrammarFile;
+
+  /** GrammarCache payload of the symbols and productions. */
+  const char *myTables;
+
+  /** Size of myTables, in bytes. */
+  uint32_t mySize;
+
+  /** Scanner table arrays. */
+  ScannerTable::Tables myScannerTables;
+
+  /** Predict table arrays. */
+  PredictTable::Tables myPredictTables;
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Returns the registered grammars, by name.
+   *
+   * @return registered grammars
+   */
+  static std::map<std::string, const EmbeddedGrammar*>& getGrammars() noexcept;
+};
+
+#endif
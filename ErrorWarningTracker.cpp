@@ -12,11 +12,30 @@
 //*******************************************************
 // ErrorWarningTracker::ErrorWarningTracker
 //*******************************************************
-ErrorWarningTracker::ErrorWarningTracker(const std::string &theFile) :
-  myFile(theFile)
+ErrorWarningTracker::ErrorWarningTracker(const std::string &theFile,
+                                         bool theQuiet) :
+  myFile(theFile),
+  myQuiet(theQuiet)
 {
 }
 
+//*******************************************************
+// ErrorWarningTracker::getErrors
+//*******************************************************
+const std::vector<ErrorWarningTracker::Error>&
+ErrorWarningTracker::getErrors() const noexcept
+{
+  return myErrors;
+}
+
+//*******************************************************
+// ErrorWarningTracker::getFile
+//*******************************************************
+const std::string& ErrorWarningTracker::getFile() const noexcept
+{
+  return myFile;
+}
+
 //*******************************************************
 // ErrorWarningTracker::hasError
 //*******************************************************
@@ -31,9 +50,7 @@ bool ErrorWarningTracker::hasError() const noexcept
 void ErrorWarningTracker::reportError(const std::string &theError)
   noexcept
 {
-  myHasError = true;
-
-  std::cerr << myFile << ": error: " << theError << std::endl;
+  reportError(0, 0, theError);
 }
 
 //*******************************************************
@@ -43,9 +60,19 @@ void ErrorWarningTracker::reportError(uint32_t theLine, uint32_t theColumn,
                                       const std::string &theError) noexcept
 {
   myHasError = true;
+  myErrors.push_back(Error{theLine, theColumn, theError});
+
+  if (myQuiet)
+  {
+    return;
+  }
 
-  std::cerr << myFile << ":" << theLine << ":" << theColumn << ": error: "
-            << theError << std::endl;
+  std::cerr << myFile;
+  if (theLine > 0)
+  {
+    std::cerr << ":" << theLine << ":" << theColumn;
+  }
+  std::cerr << ": error: " << theError << std::endl;
 }
 
 //*******************************************************
@@ -54,5 +81,8 @@ void ErrorWarningTracker::reportError(uint32_t theLine, uint32_t theColumn,
 void ErrorWarningTracker::reportWarning(const std::string &theWarning)
   noexcept
 {
-  std::cerr << myFile << ": warning: " << theWarning << std::endl;
+  if (! myQuiet)
+  {
+    std::cerr << myFile << ": warning: " << theWarning << std::endl;
+  }
 }
@@ -8,7 +8,9 @@
  * @author Michael Albers
  */
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 /**
  * This class handles compiler errors and warnings. It should be used to report
@@ -21,6 +23,23 @@ class ErrorWarningTracker
   // ************************************************************
   public:
 
+  /**
+   * An error reported through the tracker.
+   */
+  class Error
+  {
+    public:
+
+    /** Line of the error, 0 if it was reported without a location. */
+    uint32_t myLine;
+
+    /** Column of the error, 0 if it was reported without a location. */
+    uint32_t myColumn;
+
+    /** Error message. */
+    std::string myMessage;
+  };
+
   /**
    * Default constructor.
    */
@@ -41,8 +60,10 @@ class ErrorWarningTracker
    *
    * @param theFile
    *          file being compiled
+   * @param theQuiet
+   *          if true, errors and warnings are tracked but not printed
    */
-  ErrorWarningTracker(const std::string &theFile);
+  ErrorWarningTracker(const std::string &theFile, bool theQuiet = false);
 
   /**
    * Destructor
@@ -59,6 +80,20 @@ class ErrorWarningTracker
    */
   ErrorWarningTracker& operator=(ErrorWarningTracker &&) = default;
 
+  /**
+   * Returns the errors reported so far, in the order reported.
+   *
+   * @return reported errors
+   */
+  const std::vector<Error>& getErrors() const noexcept;
+
+  /**
+   * Returns the file being compiled.
+   *
+   * @return file name
+   */
+  const std::string& getFile() const noexcept;
+
   /**
    * Returns if the file has an error.
    *
@@ -105,11 +140,17 @@ class ErrorWarningTracker
   // ************************************************************
   private:
 
+  /** Errors reported so far. */
+  std::vector<Error> myErrors;
+
   /** File being compiled. */
   const std::string myFile;
 
   /** Does the program have an error? */
   bool myHasError = false;
+
+  /** Are errors and warnings not printed? */
+  bool myQuiet;
 };
 
 #endif
@@ -9,6 +9,7 @@
 #include <cstdlib>
 #include <cstring>
 #include <iomanip>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -43,15 +44,45 @@ Grammar::Grammar(const std::string &theFileName,
     throw std::runtime_error{error.str()};
   }
 
+  // The same hash GrammarCache checks its cache against.
+  std::string contents{std::istreambuf_iterator<char>(myFile),
+                       std::istreambuf_iterator<char>()};
+  myHash = GrammarCache::hash(contents.data(), contents.size());
+  myFile.clear();
+  myFile.seekg(0);
+
   populateGrammar();
 }
 
+//*******************************************************
+// Grammar::Grammar
+//*******************************************************
+Grammar::Grammar(const std::string &theFileName,
+                 ErrorWarningTracker &theEWTracker,
+                 ScannerTable &theScannerTable,
+                 GrammarCache::Reader &theReader,
+                 const ScannerTable::Tables *theScannerTables) :
+  myEWTracker(theEWTracker),
+  myFileName(theFileName),
+  myScannerTable(theScannerTable)
+{
+  loadGrammar(theReader, theScannerTables);
+}
+
+//*******************************************************
+// Grammar::getHash
+//*******************************************************
+uint64_t Grammar::getHash() const noexcept
+{
+  return myHash;
+}
+
 //*******************************************************
 // Grammar::getNonTerminalSymbols
 //*******************************************************
 Symbol::SymbolSet Grammar::getNonTerminalSymbols() const noexcept
 {
-  return myNonTerminalSymbols;
+  return mySymbolRegistry.getSymbols(SymbolRegistry::Kind::NonTerminal);
 }
 
 //*******************************************************
@@ -80,31 +111,153 @@ std::shared_ptr<Symbol> Grammar::getStartSymbol() const noexcept
   return myStartSymbol;
 }
 
+//*******************************************************
+// Grammar::getSymbolRegistry
+//*******************************************************
+const SymbolRegistry& Grammar::getSymbolRegistry() const noexcept
+{
+  return mySymbolRegistry;
+}
+
 //*******************************************************
 // Grammar::getTerminalSymbols
 //*******************************************************
 Symbol::SymbolSet Grammar::getTerminalSymbols() const noexcept
 {
-  return myTerminalSymbols;
+  return mySymbolRegistry.getSymbols(SymbolRegistry::Kind::Terminal);
+}
+
+//*******************************************************
+// Grammar::loadGrammar
+//*******************************************************
+void Grammar::loadGrammar(GrammarCache::Reader &theReader,
+                          const ScannerTable::Tables *theScannerTables)
+{
+  // Same order as populateGrammar, see save.
+  myHash = theReader.read<uint64_t>();
+
+  auto numberTerminals = theReader.read<uint32_t>();
+  for (auto ii = 0u; ii < numberTerminals; ++ii)
+  {
+    auto terminalId = theReader.read<TerminalSymbol::Id>();
+    if (terminalId > ScannerTable::PackedEntry::MAX_TERMINAL_ID)
+    {
+      throw std::runtime_error{"Grammar cache is corrupt."};
+    }
+    auto terminalName = theReader.readString();
+    auto reservedWord = theReader.readString();
+    auto terminal = std::make_shared<TerminalSymbol>(
+      terminalName, terminalId, reservedWord);
+
+    mySymbolRegistry.add(terminal, SymbolRegistry::Kind::Terminal);
+    myScannerTable.addTerminal(terminal);
+  }
+  mySymbolRegistry.add(myScannerTable.getEOF(),
+                       SymbolRegistry::Kind::Terminal);
+  mySymbolRegistry.add(Lambda::getInstance(), SymbolRegistry::Kind::Lambda);
+
+  if (nullptr == theScannerTables)
+  {
+    myScannerTable.load(theReader);
+  }
+  else
+  {
+    myScannerTable.load(*theScannerTables);
+  }
+
+  auto numberNonTerminals = theReader.read<uint32_t>();
+  for (auto ii = 0u; ii < numberNonTerminals; ++ii)
+  {
+    makeNonTerminal(theReader.readString());
+  }
+
+  auto numberActions = theReader.read<uint32_t>();
+  for (auto ii = 0u; ii < numberActions; ++ii)
+  {
+    auto name = theReader.readString();
+    auto &action = myActionSymbols[name];
+    action.reset(new ActionSymbol(name));
+    mySymbolRegistry.add(action, SymbolRegistry::Kind::Action);
+  }
+
+  auto getSymbol = [&](Symbol::Index theIndex)
+  {
+    if (theIndex >= mySymbolRegistry.getNumberSymbols())
+    {
+      throw std::runtime_error{"Grammar cache is corrupt."};
+    }
+    return mySymbolRegistry.getSymbol(theIndex);
+  };
+  auto getNonTerminal = [&](Symbol::Index theIndex)
+  {
+    if (theIndex < mySymbolRegistry.getBegin(
+          SymbolRegistry::Kind::NonTerminal) ||
+        theIndex >= mySymbolRegistry.getEnd(
+          SymbolRegistry::Kind::NonTerminal))
+    {
+      throw std::runtime_error{"Grammar cache is corrupt."};
+    }
+    return mySymbolRegistry.getSymbol(theIndex);
+  };
+
+  auto numberProductions = theReader.read<uint32_t>();
+  std::vector<Symbol::Index> rhs;
+  for (auto productionNumber = 1u; productionNumber <= numberProductions;
+       ++productionNumber)
+  {
+    auto lhsSymbol = getNonTerminal(theReader.read<Symbol::Index>());
+    std::shared_ptr<Production> production{
+      new Production(lhsSymbol, productionNumber)};
+    myProductions.push_back(production);
+
+    theReader.read(rhs);
+    uint32_t numberGrammarSymbols = 0;
+    for (auto symbol : rhs)
+    {
+      production->addRHSSymbol(getSymbol(symbol));
+      if (mySymbolRegistry.getKind(symbol) != SymbolRegistry::Kind::Action)
+      {
+        ++numberGrammarSymbols;
+      }
+    }
+
+    // The semantic stack only has a record for each grammar symbol.
+    for (auto symbol : rhs)
+    {
+      if (mySymbolRegistry.getKind(symbol) == SymbolRegistry::Kind::Action)
+      {
+        auto action = std::static_pointer_cast<ActionSymbol>(
+          mySymbolRegistry.getSymbol(symbol));
+        for (auto argument : action->getArguments())
+        {
+          if (ActionSymbol::LHS_ARGUMENT != argument &&
+              argument > numberGrammarSymbols)
+          {
+            throw std::runtime_error{"Grammar cache is corrupt."};
+          }
+        }
+      }
+    }
+  }
+
+  myStartSymbol = getNonTerminal(theReader.read<Symbol::Index>());
 }
 
 //*******************************************************
 // Grammar::makeNonTerminal
 //*******************************************************
 std::shared_ptr<Symbol> Grammar::makeNonTerminal(
-  const std::string &theSymbol) noexcept
+  const std::string &theSymbol)
 {
-  std::shared_ptr<Symbol> nonTerminal(new NonTerminalSymbol(theSymbol));
-
-  Symbol::SymbolSet::iterator nonTerminalIter =
-    myNonTerminalSymbols.find(nonTerminal);
-  if (nonTerminalIter == myNonTerminalSymbols.end())
+  auto index = mySymbolRegistry.find(theSymbol);
+  if (Symbol::NO_INDEX != index)
   {
-    myNonTerminalSymbols.insert(nonTerminal);
-    return nonTerminal;
+    return mySymbolRegistry.getSymbol(index);
   }
 
-  return *nonTerminalIter;
+  std::shared_ptr<Symbol> nonTerminal(new NonTerminalSymbol(theSymbol));
+  mySymbolRegistry.add(nonTerminal, SymbolRegistry::Kind::NonTerminal);
+  return nonTerminal;
 }
 
 //*******************************************************
@@ -119,7 +272,22 @@ std::shared_ptr<Symbol> Grammar::makeSymbol(
   }
   else if ('#' == theSymbol[0])
   {
-    return std::shared_ptr<Symbol>(new ActionSymbol(theSymbol));
+    auto &action = myActionSymbols[theSymbol];
+    if (action.get() == nullptr)
+    {
+      try
+      {
+        action.reset(new ActionSymbol(theSymbol));
+      }
+      catch (const std::exception &exception)
+      {
+        myActionSymbols.erase(theSymbol);
+        std::ostringstream error;
+        error << exception.what() << " (line " << myLineNumber << ")";
+        throw std::runtime_error{error.str()};
+      }
+    }
+    return action;
   }
   else
   {
@@ -129,12 +297,11 @@ std::shared_ptr<Symbol> Grammar::makeSymbol(
     }
     else
     {
-      for (auto terminal : myTerminalSymbols)
+      auto index = mySymbolRegistry.find(theSymbol);
+      if (Symbol::NO_INDEX != index &&
+          mySymbolRegistry.getKind(index) == SymbolRegistry::Kind::Terminal)
       {
-        if (terminal->getName() == theSymbol)
-        {
-          return terminal;
-        }
+        return mySymbolRegistry.getSymbol(index);
       }
     }
 
@@ -241,6 +408,11 @@ void Grammar::readProductions()
 
     ++productionNumber;
   }
+
+  for (const auto &action : myActionSymbols)
+  {
+    mySymbolRegistry.add(action.second, SymbolRegistry::Kind::Action);
+  }
 }
 
 //*******************************************************
@@ -297,6 +469,8 @@ void Grammar::readScannerTable()
 
     ++stateNumber;
   }
+
+  myScannerTable.finalize();
 }
 
 //*******************************************************
@@ -306,13 +480,11 @@ void Grammar::readStartSymbol()
 {
   std::string startSymbol;
   readLine(startSymbol);
-  for (auto symbol : myNonTerminalSymbols)
+  auto index = mySymbolRegistry.find(startSymbol);
+  if (Symbol::NO_INDEX != index &&
+      mySymbolRegistry.getKind(index) == SymbolRegistry::Kind::NonTerminal)
   {
-    if (symbol->getName() == startSymbol)
-    {
-      myStartSymbol = symbol;
-      break;
-    }
+    myStartSymbol = mySymbolRegistry.getSymbol(index);
   }
 
   if (myStartSymbol.get() == nullptr)
@@ -345,12 +517,69 @@ void Grammar::readTerminals()
     auto terminal = std::make_shared<TerminalSymbol>(
       terminalName, terminalId, reservedWord);
 
-    myTerminalSymbols.insert(terminal);
+    mySymbolRegistry.add(terminal, SymbolRegistry::Kind::Terminal);
     myScannerTable.addTerminal(terminal);
   }
 
   // Add built-in EOF terminal (don't add "NoTerminal")
-  myTerminalSymbols.insert(myScannerTable.getEOF());
+  mySymbolRegistry.add(myScannerTable.getEOF(),
+                       SymbolRegistry::Kind::Terminal);
+  mySymbolRegistry.add(Lambda::getInstance(), SymbolRegistry::Kind::Lambda);
+}
+
+//*******************************************************
+// Grammar::save
+//*******************************************************
+void Grammar::save(GrammarCache::Writer &theWriter,
+                   bool theScannerTable) const
+{
+  theWriter.write(myHash);
+
+  // EOF and lambda are built in, so aren't written.
+  auto terminalsEnd = mySymbolRegistry.getEnd(SymbolRegistry::Kind::Terminal);
+  auto terminalsBegin =
+    mySymbolRegistry.getBegin(SymbolRegistry::Kind::Terminal);
+  theWriter.write<uint32_t>(terminalsEnd - terminalsBegin - 1);
+  for (auto index = terminalsBegin; index < terminalsEnd - 1; ++index)
+  {
+    auto terminal = dynamic_cast<const TerminalSymbol*>(
+      mySymbolRegistry.getSymbol(index).get());
+    theWriter.write(terminal->getId());
+    theWriter.write(terminal->getName());
+    theWriter.write(terminal->getReservedWord());
+  }
+
+  if (theScannerTable)
+  {
+    myScannerTable.save(theWriter);
+  }
+
+  for (auto kind : {SymbolRegistry::Kind::NonTerminal,
+                    SymbolRegistry::Kind::Action})
+  {
+    auto begin = mySymbolRegistry.getBegin(kind);
+    auto end = mySymbolRegistry.getEnd(kind);
+    theWriter.write<uint32_t>(end - begin);
+    for (auto index = begin; index < end; ++index)
+    {
+      theWriter.write(mySymbolRegistry.getName(index));
+    }
+  }
+
+  theWriter.write<uint32_t>(myProductions.size());
+  std::vector<Symbol::Index> rhs;
+  for (const auto &production : myProductions)
+  {
+    theWriter.write(production->getLHS()->getIndex());
+    rhs.clear();
+    for (const auto &symbol : production->getRHS())
+    {
+      rhs.push_back(mySymbolRegistry.getIndex(*symbol));
+    }
+    theWriter.write(rhs);
+  }
+
+  theWriter.write(myStartSymbol->getIndex());
 }
 
 //*******************************************************
@@ -378,7 +607,7 @@ std::ostream& operator<<(std::ostream &theOS,
   TerminalSymbol::ourLongPrint = true;
   theOS << "Terminal Symbols" << std::endl
         << "----------------" << std::endl;
-  for (auto symbol : theGrammar.myTerminalSymbols)
+  for (auto symbol : Symbol::sortByName(theGrammar.getTerminalSymbols()))
   {
     theOS << *symbol << std::endl;
   }
@@ -387,10 +616,13 @@ std::ostream& operator<<(std::ostream &theOS,
 
   theOS << "Non-Terminal Symbols" << std::endl
         << "--------------------" << std::endl;
-  for (auto symbol : theGrammar.myNonTerminalSymbols)
+  for (auto symbol : Symbol::sortByName(theGrammar.getNonTerminalSymbols()))
   {
     theOS << *symbol << std::endl;
   }
+  theOS << std::endl;
+
+  theOS << theGrammar.myScannerTable;
 
   return theOS;
 }
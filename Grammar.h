@@ -14,8 +14,10 @@
 #include <ostream>
 #include <string>
 
+#include "GrammarCache.h"
 #include "ScannerTable.h"
 #include "Symbol.h"
+#include "SymbolRegistry.h"
 
 class ErrorWarningTracker;
 class Production;
@@ -116,6 +118,31 @@ class Grammar
           ErrorWarningTracker &theEWTracker,
           ScannerTable &theScannerTable);
 
+  /**
+   * Constructor. Loads the grammar from a cache written by save instead of
+   * reading the grammar file.
+   *
+   * @param theFileName
+   *          name of the file containing grammar information, only used for
+   *          printing
+   * @param theEWTracker
+   *          error/warning tracker
+   * @param theScannerTable
+   *          scanner table to populate
+   * @param theReader
+   *          cache reader, positioned where save wrote the grammar
+   * @param theScannerTables
+   *          if not null, the scanner table points at these tables, and the
+   *          grammar was saved without its scanner table
+   * @throws std::runtime_error
+   *          if the cache is truncated or corrupt
+   */
+  Grammar(const std::string &theFileName,
+          ErrorWarningTracker &theEWTracker,
+          ScannerTable &theScannerTable,
+          GrammarCache::Reader &theReader,
+          const ScannerTable::Tables *theScannerTables = nullptr);
+
   /**
    * Destructor
    */
@@ -143,6 +170,14 @@ class Grammar
   friend std::ostream& operator<<(std::ostream &theOS,
                                   const Grammar &theGrammar) noexcept;
 
+  /**
+   * Returns the hash of the contents of the grammar file (see
+   * GrammarCache::hash), which identifies the grammar.
+   *
+   * @return grammar file hash
+   */
+  uint64_t getHash() const noexcept;
+
   /**
    * Returns the set of non-terminal symbols.
    *
@@ -174,6 +209,13 @@ class Grammar
    */
   std::shared_ptr<Symbol> getStartSymbol() const noexcept;
 
+  /**
+   * Returns the registry of this grammar's symbols.
+   *
+   * @return symbol registry
+   */
+  const SymbolRegistry& getSymbolRegistry() const noexcept;
+
   /**
    * Returns the set of terminal symbols.
    *
@@ -181,6 +223,18 @@ class Grammar
    */
   Symbol::SymbolSet getTerminalSymbols() const noexcept;
 
+  /**
+   * Writes the grammar, including its scanner table, to a cache.
+   *
+   * @param theWriter
+   *          cache writer
+   * @param theScannerTable
+   *          if false, the scanner table is left out, for a grammar whose
+   *          scanner tables are embedded (see EmbeddedGrammar)
+   */
+  void save(GrammarCache::Writer &theWriter,
+            bool theScannerTable = true) const;
+
   // ************************************************************
   // Protected
   // ************************************************************
@@ -201,8 +255,7 @@ class Grammar
    *          non-terminal symbol
    * @return Symbol
    */
-  std::shared_ptr<Symbol> makeNonTerminal(
-    const std::string &theSymbol) noexcept;
+  std::shared_ptr<Symbol> makeNonTerminal(const std::string &theSymbol);
 
   /**
    * Creates a Symbol object from the given symbol string.
@@ -213,6 +266,17 @@ class Grammar
    */
   std::shared_ptr<Symbol> makeSymbol(const std::string &theSymbol);
 
+  /**
+   * Populates this object from a cache written by save.
+   *
+   * @param theReader
+   *          cache reader
+   * @param theScannerTables
+   *          if not null, tables for the scanner table to point at
+   */
+  void loadGrammar(GrammarCache::Reader &theReader,
+                   const ScannerTable::Tables *theScannerTables);
+
   /**
    * Reads the grammar file and populates this object from the contents
    * of said file.
@@ -264,20 +328,26 @@ class Grammar
   /** File stream for reading grammar definition file. */
   std::ifstream myFile;
 
+  /** See getHash. */
+  uint64_t myHash = 0;
+
   /** Scanner table */
   ScannerTable &myScannerTable;
 
   /*
    * Grammar elements: Symbols (terminal & non-terminal), and productions.
    */
-  /** Set of all non-terminal symbols in the productions. */
-  Symbol::SymbolSet myNonTerminalSymbols;
+  /**
+   * Action symbols by name. These are registered once all productions
+   * are read, after the non-terminals.
+   */
+  std::map<std::string, std::shared_ptr<Symbol>> myActionSymbols;
 
   /** Grammar start symbol. */
   std::shared_ptr<Symbol> myStartSymbol;
 
-  /** Set of all terminal symbols in the productions. */
-  Symbol::SymbolSet myTerminalSymbols;
+  /** All symbols of the grammar. */
+  SymbolRegistry mySymbolRegistry;
 
   /** All productions */
   std::vector<std::shared_ptr<Production>> myProductions;
@@ -5,6 +5,7 @@
  * @author Michael Albers
  */
 
+#include <algorithm>
 #include <cerrno>
 #include <iostream>
 
@@ -17,19 +18,30 @@
 //*******************************************************
 // GrammarAnalyzer::GrammarAnalyzer
 //*******************************************************
-GrammarAnalyzer::GrammarAnalyzer(Grammar &theGrammar) :
+GrammarAnalyzer::GrammarAnalyzer(Grammar &theGrammar, Mode theMode) :
   myGrammar(theGrammar),
+  myMode(theMode),
   myNonTerminalSymbols(myGrammar.getNonTerminalSymbols()),
   myProductions(myGrammar.getProductions()),
+  mySymbolRegistry(myGrammar.getSymbolRegistry()),
   myTerminalSymbols(myGrammar.getTerminalSymbols())
 {
   mySymbols.insert(myNonTerminalSymbols.begin(), myNonTerminalSymbols.end());
   mySymbols.insert(myTerminalSymbols.begin(), myTerminalSymbols.end());
 
+  // Sets hold terminals and lambda, which SymbolRegistry numbers from 0.
+  myLambda = mySymbolRegistry.getLambda();
+  mySetSize = myLambda + 1;
+  myNonTerminalBegin = mySymbolRegistry.getBegin(
+    SymbolRegistry::Kind::NonTerminal);
+
+  readProductions();
   calculateDerivesLambda();
   fillFirstSets();
+  fillSuffixes();
   fillFollowSets();
   generatePredictSets();
+  storeSets();
 }
 
 //*******************************************************
@@ -37,241 +49,440 @@ GrammarAnalyzer::GrammarAnalyzer(Grammar &theGrammar) :
 //*******************************************************
 void GrammarAnalyzer::calculateDerivesLambda() noexcept
 {
-  bool anyChanges = false;
-  do
+  // Count the symbols of each RHS not yet known to derive lambda. A
+  // production whose count drops to 0 derives lambda, as does its LHS.
+  std::vector<uint32_t> remaining(myRHS.size());
+  NonTerminalLists occurrences(myNonTerminalSymbols.size());
+  std::vector<uint32_t> worklist;
+  myDerivesLambda.assign(myNonTerminalSymbols.size(), false);
+
+  auto derivesLambda = [&](uint32_t theProduction)
+  {
+    auto lhs = getNonTerminal(
+      myProductions[theProduction]->getLHS()->getIndex());
+    if (! myDerivesLambda[lhs])
+    {
+      myDerivesLambda[lhs] = true;
+      worklist.push_back(lhs);
+    }
+  };
+
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
   {
-    anyChanges = false;
-    for (auto production : myProductions)
+    remaining[production] = myRHS[production].size();
+    for (auto symbol : myRHS[production])
     {
-      bool rhsDerivesLambda = true;
-      auto rhs = production->getRHS();
-      for (auto rhsSymbol : rhs)
+      if (isNonTerminal(symbol))
       {
-        rhsDerivesLambda &= rhsSymbol->getDerivesLambda();
+        occurrences[getNonTerminal(symbol)].push_back(production);
       }
+    }
+    if (0 == remaining[production])
+    {
+      derivesLambda(production);
+    }
+  }
 
-      auto lhs = production->getLHS();
-      if (rhsDerivesLambda && ! lhs->getDerivesLambda())
+  while (! worklist.empty())
+  {
+    auto nonTerminal = worklist.back();
+    worklist.pop_back();
+    for (auto production : occurrences[nonTerminal])
+    {
+      if (0 == --remaining[production])
       {
-        anyChanges = true;
-        lhs->setDerivesLambda(true);
+        derivesLambda(production);
       }
     }
   }
-  while (anyChanges);
 }
 
 //*******************************************************
-// GrammarAnalyzer::computeFirst
+// GrammarAnalyzer::closeSets
 //*******************************************************
-Symbol::SymbolSet GrammarAnalyzer::computeFirst(
-  const Symbol::SymbolList &theSymbols) const noexcept
+void GrammarAnalyzer::closeSets(std::vector<BitSet> &theSets,
+                                const NonTerminalLists &theIncludes) noexcept
 {
-  Symbol::SymbolSet firstSet;
-
-  auto lambda = Lambda::getInstance();
-
-  auto numberSymbols = theSymbols.size();
-  if (theSymbols.size() == 0)
+  auto start = std::chrono::steady_clock::now();
+  if (Mode::Digraph == myMode)
   {
-    firstSet.insert(lambda);
+    digraph(theSets, theIncludes);
   }
   else
   {
-    Symbol::SymbolSet symbolFirstSet;
-    Symbol::SymbolList::size_type ii = 0;
-    bool symbolSetContainsLambda = true;
-    for (; ii < numberSymbols && symbolSetContainsLambda; ++ii)
+    propagate(theSets, theIncludes);
+  }
+  myClosureTime += std::chrono::steady_clock::now() - start;
+}
+
+//*******************************************************
+// GrammarAnalyzer::digraph
+//*******************************************************
+void GrammarAnalyzer::digraph(std::vector<BitSet> &theSets,
+                              const NonTerminalLists &theIncludes) noexcept
+{
+  // DeRemer & Pennello's digraph algorithm: a depth first search (iterative,
+  // as non-terminal chains can be long) which finds the strongly connected
+  // components of the includes relation as Tarjan's algorithm does. A
+  // set is final once the search leaves it, and every member of a
+  // component gets the set of the component's root.
+  static constexpr uint32_t DONE = UINT32_MAX;
+
+  struct Frame
+  {
+    uint32_t myNonTerminal;
+    uint32_t myNextInclude;
+    uint32_t myDepth;
+  };
+
+  std::vector<uint32_t> depth(theSets.size(), 0); // 0 is unvisited
+  std::vector<uint32_t> componentStack;
+  std::vector<Frame> searchStack;
+
+  auto visit = [&](uint32_t theNonTerminal)
+  {
+    componentStack.push_back(theNonTerminal);
+    depth[theNonTerminal] = componentStack.size();
+    searchStack.push_back(Frame{theNonTerminal, 0,
+                                depth[theNonTerminal]});
+  };
+
+  for (uint32_t start = 0; start < theSets.size(); ++start)
+  {
+    if (0 != depth[start])
+    {
+      continue;
+    }
+
+    visit(start);
+    while (! searchStack.empty())
     {
-      if (! isGrammarSymbol(theSymbols[ii]))
+      auto &frame = searchStack.back();
+      auto nonTerminal = frame.myNonTerminal;
+      const auto &includes = theIncludes[nonTerminal];
+
+      if (frame.myNextInclude < includes.size())
       {
+        auto included = includes[frame.myNextInclude++];
+        if (0 == depth[included])
+        {
+          visit(included);
+        }
+        else
+        {
+          depth[nonTerminal] = std::min(depth[nonTerminal], depth[included]);
+          theSets[nonTerminal].insert(theSets[included]);
+        }
         continue;
       }
 
-      symbolFirstSet = theSymbols[ii]->getFirstSet();
-      firstSet.insert(symbolFirstSet.begin(), symbolFirstSet.end());
-      firstSet.erase(lambda);
-      symbolSetContainsLambda = containsLambda(symbolFirstSet);
-    }
+      // All includes done. The root of a component is the member visited
+      // first, the one which reaches nothing lower on componentStack.
+      if (depth[nonTerminal] == frame.myDepth)
+      {
+        uint32_t member;
+        do
+        {
+          member = componentStack.back();
+          componentStack.pop_back();
+          depth[member] = DONE;
+          if (member != nonTerminal)
+          {
+            theSets[member] = theSets[nonTerminal];
+          }
+        } while (member != nonTerminal);
+      }
 
-    if (ii == numberSymbols && symbolSetContainsLambda)
-    {
-      firstSet.insert(lambda);
+      searchStack.pop_back();
+      if (! searchStack.empty())
+      {
+        auto parent = searchStack.back().myNonTerminal;
+        depth[parent] = std::min(depth[parent], depth[nonTerminal]);
+        theSets[parent].insert(theSets[nonTerminal]);
+      }
     }
   }
-  return firstSet;
 }
 
 //*******************************************************
-// GrammarAnalyzer::containsLambda
+// GrammarAnalyzer::fillFirstSets
 //*******************************************************
-bool GrammarAnalyzer::containsLambda(const Symbol::SymbolSet &theSymbols)
-  noexcept
+void GrammarAnalyzer::fillFirstSets() noexcept
 {
-  return theSymbols.find(Lambda::getInstance()) != theSymbols.end();
+  myFirstSets.assign(myNonTerminalSymbols.size(), BitSet(mySetSize));
+  NonTerminalLists includes(myNonTerminalSymbols.size());
+
+  // First(LHS) has each leading terminal of the RHS and includes the first
+  // set of each leading non-terminal (the leading symbols being those up to
+  // and including the first which doesn't derive lambda).
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
+  {
+    auto lhs = getNonTerminal(
+      myProductions[production]->getLHS()->getIndex());
+    for (auto symbol : myRHS[production])
+    {
+      if (! isNonTerminal(symbol))
+      {
+        myFirstSets[lhs].insert(symbol);
+        break;
+      }
+
+      auto nonTerminal = getNonTerminal(symbol);
+      includes[lhs].push_back(nonTerminal);
+      if (! myDerivesLambda[nonTerminal])
+      {
+        break;
+      }
+    }
+  }
+
+  closeSets(myFirstSets, includes);
 }
 
 //*******************************************************
-// GrammarAnalyzer::fillFirstSets
+// GrammarAnalyzer::fillFollowSets
 //*******************************************************
-void GrammarAnalyzer::fillFirstSets() noexcept
+void GrammarAnalyzer::fillFollowSets() noexcept
 {
-  // This loop assumes the first sets haven't been changed from the empty
-  // set yet. (Code provided in class has an else case to set the first
-  // set to the empty list.)
-  for (auto nonTerminal : myNonTerminalSymbols)
+  myFollowSets.assign(myNonTerminalSymbols.size(), BitSet(mySetSize));
+  NonTerminalLists includes(myNonTerminalSymbols.size());
+
+  myFollowSets[getNonTerminal(myGrammar.getStartSymbol()->getIndex())].insert(
+    myLambda);
+
+  // Follow(symbol) has the first set of what follows it, and includes
+  // Follow(LHS) if what follows derives lambda.
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
   {
-    if (nonTerminal->getDerivesLambda())
+    auto lhs = getNonTerminal(
+      myProductions[production]->getLHS()->getIndex());
+    const auto &rhs = myRHS[production];
+    for (uint32_t position = 0; position < rhs.size(); ++position)
     {
-      nonTerminal->addToFirstSet(Lambda::getInstance());
+      if (isNonTerminal(rhs[position]))
+      {
+        auto nonTerminal = getNonTerminal(rhs[position]);
+        auto suffix = getSuffix(production, position + 1);
+        myFollowSets[nonTerminal].insert(mySuffixFirstSets[suffix]);
+        if (mySuffixDerivesLambda[suffix])
+        {
+          includes[nonTerminal].push_back(lhs);
+        }
+      }
     }
   }
 
-  for (auto terminal : myTerminalSymbols)
-  {
-    terminal->addToFirstSet(terminal);
-  }
+  closeSets(myFollowSets, includes);
+}
 
-  for (auto production : myProductions)
+//*******************************************************
+// GrammarAnalyzer::fillSuffixes
+//*******************************************************
+void GrammarAnalyzer::fillSuffixes() noexcept
+{
+  mySuffixes.resize(myRHS.size());
+  uint32_t numberSuffixes = 0;
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
   {
-    auto rhs = production->getRHS();
-    uint32_t index = 0;
-    for (; index < rhs.size() && false == isGrammarSymbol(rhs[index]); ++index);
-    if (typeid(*rhs[index]) == typeid(TerminalSymbol))
-    {
-      production->getLHS()->addToFirstSet(rhs[index]);
-    }
+    mySuffixes[production] = numberSuffixes;
+    numberSuffixes += myRHS[production].size() + 1;
   }
+  mySuffixFirstSets.assign(numberSuffixes, BitSet(mySetSize));
+  mySuffixDerivesLambda.assign(numberSuffixes, true);
 
-  bool anyChanges = true;
-  while (anyChanges)
+  // Each suffix is its first symbol plus, if that symbol derives lambda,
+  // the suffix after it. The empty suffix at the end derives lambda.
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
   {
-    anyChanges = false;
-    for (auto production : myProductions)
+    const auto &rhs = myRHS[production];
+    for (auto position = rhs.size(); position-- > 0; )
     {
-      auto previousSize = production->getLHS()->getFirstSet().size();
-      Symbol::SymbolSet rhsFirstSet{computeFirst(production->getRHS())};
-
-      for (auto symbol : rhsFirstSet)
+      auto suffix = getSuffix(production, position);
+      auto &first = mySuffixFirstSets[suffix];
+      if (! isNonTerminal(rhs[position]))
       {
-        production->getLHS()->addToFirstSet(symbol);
+        first.insert(rhs[position]);
+        mySuffixDerivesLambda[suffix] = false;
+        continue;
       }
 
-      auto afterSize = production->getLHS()->getFirstSet().size();
-
-      if (! anyChanges)
+      auto nonTerminal = getNonTerminal(rhs[position]);
+      first.insert(myFirstSets[nonTerminal]);
+      if (myDerivesLambda[nonTerminal])
+      {
+        first.insert(mySuffixFirstSets[suffix + 1]);
+        mySuffixDerivesLambda[suffix] = mySuffixDerivesLambda[suffix + 1];
+      }
+      else
       {
-        anyChanges = (previousSize != afterSize);
+        mySuffixDerivesLambda[suffix] = false;
       }
     }
   }
 }
 
 //*******************************************************
-// GrammarAnalyzer::fillFollowSets
+// GrammarAnalyzer::generatePredictSets
 //*******************************************************
-void GrammarAnalyzer::fillFollowSets() noexcept
+void GrammarAnalyzer::generatePredictSets() noexcept
 {
-  // Quite the hack, but really no other way to do it.
-  auto s = dynamic_cast<NonTerminalSymbol*>(myGrammar.getStartSymbol().get());
-  s->addToFollowSet(Lambda::getInstance());
-
-  bool anyChanges = true;
-  while (anyChanges)
+  // Predict is First(RHS), plus Follow(LHS) if the RHS derives lambda.
+  myPredictSets.assign(myRHS.size(), BitSet(mySetSize));
+  for (uint32_t production = 0; production < myRHS.size(); ++production)
   {
-    anyChanges = false;
-    for (auto production : myProductions)
+    auto &predictSet = myPredictSets[production];
+    auto suffix = getSuffix(production, 0);
+    predictSet.insert(mySuffixFirstSets[suffix]);
+    if (mySuffixDerivesLambda[suffix])
     {
-      auto rhs = production->getRHS();
-      for (uint32_t rhsIndex = 0; rhsIndex < rhs.size(); ++rhsIndex)
-      {
-        std::shared_ptr<Symbol> rhsSymbol = rhs[rhsIndex];
-        if (typeid(*rhsSymbol) == typeid(NonTerminalSymbol))
-        {
-          NonTerminalSymbol *nonTerminal =
-            dynamic_cast<NonTerminalSymbol*>(rhsSymbol.get());
+      predictSet.insert(myFollowSets[getNonTerminal(
+        myProductions[production]->getLHS()->getIndex())]);
+    }
+    predictSet.erase(myLambda);
+  }
+}
 
-          auto previousSize = nonTerminal->getFollowSet().size();
+//*******************************************************
+// GrammarAnalyzer::getClosureTime
+//*******************************************************
+std::chrono::nanoseconds GrammarAnalyzer::getClosureTime() const noexcept
+{
+  return myClosureTime;
+}
 
-          Symbol::SymbolList remainingRhs;
-          for (auto jj = rhsIndex + 1; jj < rhs.size(); ++jj)
-          {
-            if (isGrammarSymbol(rhs[jj]))
-            {
-              remainingRhs.push_back(rhs[jj]);
-            }
-          }
+//*******************************************************
+// GrammarAnalyzer::getNonTerminal
+//*******************************************************
+uint32_t GrammarAnalyzer::getNonTerminal(Symbol::Index theSymbol)
+  const noexcept
+{
+  return theSymbol - myNonTerminalBegin;
+}
 
-          Symbol::SymbolSet firstSetOfRemaining{computeFirst(remainingRhs)};
+//*******************************************************
+// GrammarAnalyzer::isGrammarSymbol
+//*******************************************************
+bool GrammarAnalyzer::isGrammarSymbol(std::shared_ptr<Symbol> theSymbol)
+  noexcept
+{
+  auto *pointer = theSymbol.get();
+  return (typeid(*pointer) == typeid(TerminalSymbol) ||
+          typeid(*pointer) == typeid(NonTerminalSymbol) ||
+          typeid(*pointer) == typeid(Lambda));
+}
 
-          auto lambdaIter = firstSetOfRemaining.find(Lambda::getInstance());
-          bool hasLambda = lambdaIter != firstSetOfRemaining.end();
+//*******************************************************
+// GrammarAnalyzer::getSymbols
+//*******************************************************
+Symbol::SymbolSet GrammarAnalyzer::getSymbols(const BitSet &theSet) const
+{
+  // Bits are in index order, so each insert goes at the end.
+  Symbol::SymbolSet symbols;
+  for (auto ii = theSet.next(0); ii < theSet.getSize();
+       ii = theSet.next(ii + 1))
+  {
+    symbols.insert(symbols.end(), mySymbolRegistry.getSymbol(ii));
+  }
+  return symbols;
+}
 
-          if (hasLambda)
-          {
-            firstSetOfRemaining.erase(lambdaIter);
-          }
+//*******************************************************
+// GrammarAnalyzer::getSuffix
+//*******************************************************
+uint32_t GrammarAnalyzer::getSuffix(uint32_t theProduction,
+                                    uint32_t thePosition) const noexcept
+{
+  return mySuffixes[theProduction] + thePosition;
+}
 
-          for (auto s : firstSetOfRemaining)
-          {
-            nonTerminal->addToFollowSet(s);
-          }
+//*******************************************************
+// GrammarAnalyzer::isNonTerminal
+//*******************************************************
+bool GrammarAnalyzer::isNonTerminal(Symbol::Index theSymbol) const noexcept
+{
+  return theSymbol >= myNonTerminalBegin;
+}
 
-          if (hasLambda)
-          {
-            NonTerminalSymbol *lhs =
-              dynamic_cast<NonTerminalSymbol*>(production->getLHS().get());
-            for (auto symbol : lhs->getFollowSet())
-            {
-              nonTerminal->addToFollowSet(symbol);
-            }
-          }
+//*******************************************************
+// GrammarAnalyzer::propagate
+//*******************************************************
+void GrammarAnalyzer::propagate(std::vector<BitSet> &theSets,
+                                const NonTerminalLists &theIncludes)
+  noexcept
+{
+  NonTerminalLists includedBy(theSets.size());
+  for (uint32_t nonTerminal = 0; nonTerminal < theIncludes.size();
+       ++nonTerminal)
+  {
+    for (auto included : theIncludes[nonTerminal])
+    {
+      includedBy[included].push_back(nonTerminal);
+    }
+  }
 
-          auto afterSize = nonTerminal->getFollowSet().size();
+  std::vector<uint32_t> worklist(theSets.size());
+  std::vector<bool> queued(theSets.size(), true);
+  for (uint32_t ii = 0; ii < worklist.size(); ++ii)
+  {
+    worklist[ii] = worklist.size() - 1 - ii;
+  }
 
-          if (! anyChanges)
-          {
-            anyChanges = (previousSize != afterSize);
-          }
-        }
+  while (! worklist.empty())
+  {
+    auto nonTerminal = worklist.back();
+    worklist.pop_back();
+    queued[nonTerminal] = false;
+    for (auto including : includedBy[nonTerminal])
+    {
+      if (theSets[including].insert(theSets[nonTerminal]) &&
+          ! queued[including])
+      {
+        queued[including] = true;
+        worklist.push_back(including);
       }
-    }  
+    }
   }
 }
 
 //*******************************************************
-// GrammarAnalyzer::generatePredictSets
+// GrammarAnalyzer::readProductions
 //*******************************************************
-void GrammarAnalyzer::generatePredictSets() noexcept
+void GrammarAnalyzer::readProductions() noexcept
 {
-  for (auto production : myProductions)
+  // Only terminals and non-terminals matter, lambda is an empty RHS.
+  auto nonTerminalEnd = mySymbolRegistry.getEnd(
+    SymbolRegistry::Kind::NonTerminal);
+  myRHS.resize(myProductions.size());
+  for (uint32_t production = 0; production < myProductions.size();
+       ++production)
   {
-    Symbol::SymbolSet predictSet{computeFirst(production->getRHS())};
-    if (containsLambda(predictSet))
-    {
-      auto lhsPtr = production->getLHS();
-      NonTerminalSymbol *lhs = dynamic_cast<NonTerminalSymbol*>(lhsPtr.get());
-      Symbol::SymbolSet followSet{lhs->getFollowSet()};
-      predictSet.insert(followSet.begin(), followSet.end());
-    }
-    predictSet.erase(Lambda::getInstance());
-    for (auto symbol : predictSet)
+    for (const auto &symbol : myProductions[production]->getRHS())
     {
-      production->addToPredictSet(symbol);
+      auto index = mySymbolRegistry.getIndex(*symbol);
+      if (index != myLambda && index < nonTerminalEnd)
+      {
+        myRHS[production].push_back(index);
+      }
     }
   }
 }
 
 //*******************************************************
-// GrammarAnalyzer::isGrammarSymbol
+// GrammarAnalyzer::storeSets
 //*******************************************************
-bool GrammarAnalyzer::isGrammarSymbol(std::shared_ptr<Symbol> theSymbol)
-  noexcept
+void GrammarAnalyzer::storeSets() noexcept
 {
-  auto *pointer = theSymbol.get();
-  return (typeid(*pointer) == typeid(TerminalSymbol) ||
-          typeid(*pointer) == typeid(NonTerminalSymbol) ||
-          typeid(*pointer) == typeid(Lambda));
+  for (auto symbol : myNonTerminalSymbols)
+  {
+    symbol->setDerivesLambda(
+      myDerivesLambda[getNonTerminal(symbol->getIndex())]);
+  }
+
+  for (uint32_t production = 0; production < myProductions.size();
+       ++production)
+  {
+    myProductions[production]->setPredictSet(myPredictSets[production]);
+  }
 }
 
 //*******************************************************
@@ -285,19 +496,34 @@ std::ostream& operator<<(std::ostream &theOS,
 
   theOS << "First Sets" << std::endl
         << "----------" << std::endl;
-  for (auto symbol : theAnalyzer.mySymbols)
+  for (auto symbol : Symbol::sortByName(theAnalyzer.mySymbols))
   {
-    theOS << symbol->getName() << " = " << symbol->getFirstSet() << std::endl;
+    Symbol::SymbolSet firstSet;
+    auto index = symbol->getIndex();
+    if (! theAnalyzer.isNonTerminal(index))
+    {
+      firstSet.insert(symbol);
+    }
+    else
+    {
+      auto nonTerminal = theAnalyzer.getNonTerminal(index);
+      firstSet = theAnalyzer.getSymbols(theAnalyzer.myFirstSets[nonTerminal]);
+      if (theAnalyzer.myDerivesLambda[nonTerminal])
+      {
+        firstSet.insert(Lambda::getInstance());
+      }
+    }
+    theOS << symbol->getName() << " = " << firstSet << std::endl;
   }
   theOS << std::endl;
 
   theOS << "Follow Sets" << std::endl
         << "----------" << std::endl;
-  for (auto symbol : theAnalyzer.myNonTerminalSymbols)
+  for (auto symbol : Symbol::sortByName(theAnalyzer.myNonTerminalSymbols))
   {
-    NonTerminalSymbol *nonTerminal = dynamic_cast<NonTerminalSymbol*>(
-      symbol.get());
-    theOS << nonTerminal->getName() << " = " << nonTerminal->getFollowSet()
+    auto nonTerminal = theAnalyzer.getNonTerminal(symbol->getIndex());
+    theOS << symbol->getName() << " = "
+          << theAnalyzer.getSymbols(theAnalyzer.myFollowSets[nonTerminal])
           << std::endl;
   }
   theOS << std::endl;
@@ -306,7 +532,8 @@ std::ostream& operator<<(std::ostream &theOS,
         << "------------" << std::endl;
   for (auto production : theAnalyzer.myProductions)
   {
-    theOS << *production << " = " << production->getPredictSet() << std::endl;
+    theOS << *production << " = "
+          << theAnalyzer.getSymbols(production->getPredictSet()) << std::endl;
   }
   theOS << std::endl;
 
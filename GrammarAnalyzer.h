@@ -8,20 +8,28 @@
  * @author Michael Albers
  */
 
+#include <chrono>
 #include <fstream>
 #include <memory>
 #include <set>
 #include <string>
 #include <vector>
 
+#include "BitSet.h"
 #include "Grammar.h"
 #include "NonTerminalSymbol.h"
 #include "Symbol.h"
+#include "SymbolRegistry.h"
 
 class Production;
 
 /**
  * This class accepts a Grammar and populates the first/follow/predict sets.
+ *
+ * First and follow sets are each built from what the productions add
+ * directly, plus an "includes" relation between non-terminals (first(A)
+ * includes first(B) for A -> B ..., follow(B) includes follow(A) for
+ * A -> ... B). How the relation is closed over is chosen by Mode.
  */
 class GrammarAnalyzer
 {
@@ -30,6 +38,20 @@ class GrammarAnalyzer
   // ************************************************************
   public:
 
+  /** How sets are propagated along the includes relation. */
+  enum class Mode
+  {
+    /** Revisit sets through a worklist until none change. */
+    Worklist,
+
+    /**
+     * Condense the relation into strongly connected components and
+     * compute each set once, in topological order (DeRemer & Pennello's
+     * digraph algorithm). Linear in the size of the relation.
+     */
+    Digraph
+  };
+
   /**
    * Default constructor
    */
@@ -51,8 +73,10 @@ class GrammarAnalyzer
    *
    * @param theGrammar
    *          grammar object to populate
+   * @param theMode
+   *          how to propagate sets
    */
-  GrammarAnalyzer(Grammar &theGrammar);
+  GrammarAnalyzer(Grammar &theGrammar, Mode theMode = Mode::Worklist);
 
   /**
    * Destructor
@@ -81,6 +105,14 @@ class GrammarAnalyzer
   friend std::ostream& operator<<(std::ostream &theOS,
                                   const GrammarAnalyzer &theAnalyzer);
 
+  /**
+   * Returns the time spent closing the first and follow sets over the
+   * includes relation, the part of the analysis Mode chooses how to do.
+   *
+   * @return closure time
+   */
+  std::chrono::nanoseconds getClosureTime() const noexcept;
+
   /**
    * Returns true if the given symbol is an actual grammar symbol
    * (i.e., non-ActionSymbol and the like)
@@ -101,31 +133,42 @@ class GrammarAnalyzer
   // ************************************************************
   private:
 
+  /** Indices of symbols, in order. */
+  using IndexList = std::vector<Symbol::Index>;
+
+  /** Lists of non-terminals (see getNonTerminal), in order. */
+  using NonTerminalLists = std::vector<std::vector<uint32_t>>;
+
   /**
-   * Determines which of the non-terminal symbols derives lambda
+   * Closes the given sets over the includes relation, according to myMode.
+   *
+   * @param theSets
+   *          sets, by non-terminal
+   * @param theIncludes
+   *          theIncludes[N] are the non-terminals whose set the set of
+   *          non-terminal N includes
    */
-  void calculateDerivesLambda() noexcept;
+  void closeSets(std::vector<BitSet> &theSets,
+                 const NonTerminalLists &theIncludes) noexcept;
 
   /**
-   * Returns the first set of the provided set of ordered symbols.
+   * Closes the given sets over the includes relation for Mode::Digraph.
    *
-   * @param list of symbols
-   * @return first set.
+   * @param theSets
+   *          sets, by non-terminal
+   * @param theIncludes
+   *          see closeSets
    */
-  Symbol::SymbolSet computeFirst(const Symbol::SymbolList &theSymbols)
-    const noexcept;
+  static void digraph(std::vector<BitSet> &theSets,
+                      const NonTerminalLists &theIncludes) noexcept;
 
   /**
-   * Checks if lambda is in the given set of symbols.
-   *
-   * @param theSymbols
-   *          set of symbols to check
-   * @return true if lambda is in the set, false otherwise.
+   * Determines which of the non-terminal symbols derives lambda
    */
-  static bool containsLambda(const Symbol::SymbolSet &theSymbols) noexcept;
+  void calculateDerivesLambda() noexcept;
 
   /**
-   * Fills the first sets for all symbols.
+   * Fills the first sets for all non-terminal symbols.
    */
   void fillFirstSets() noexcept;
 
@@ -134,23 +177,150 @@ class GrammarAnalyzer
    */
   void fillFollowSets() noexcept;
 
+  /**
+   * Fills mySuffixFirstSets and mySuffixDerivesLambda. First sets must be
+   * filled.
+   */
+  void fillSuffixes() noexcept;
+
   /**
    * Generates the predict sets for each production.
    */
   void generatePredictSets() noexcept;
 
+  /**
+   * Returns the position of the given non-terminal among the non-terminals,
+   * which is what myFirstSets and the like are indexed by.
+   *
+   * @param theSymbol
+   *          index of a non-terminal symbol
+   * @return non-terminal number
+   */
+  uint32_t getNonTerminal(Symbol::Index theSymbol) const noexcept;
+
+  /**
+   * Returns the position of the given RHS suffix in mySuffixFirstSets and
+   * mySuffixDerivesLambda.
+   *
+   * @param theProduction
+   *          production number - 1
+   * @param thePosition
+   *          position in myRHS of the first symbol of the suffix, the RHS
+   *          size for the empty suffix
+   * @return suffix number
+   */
+  uint32_t getSuffix(uint32_t theProduction, uint32_t thePosition)
+    const noexcept;
+
+  /**
+   * Returns the symbols in the given set.
+   *
+   * @param theSet
+   *          set of symbol indices
+   * @return symbols
+   */
+  Symbol::SymbolSet getSymbols(const BitSet &theSet) const;
+
+  /**
+   * Returns true if the given symbol is a non-terminal.
+   *
+   * @param theSymbol
+   *          index of the symbol to check
+   * @return true for a non-terminal
+   */
+  bool isNonTerminal(Symbol::Index theSymbol) const noexcept;
+
+  /**
+   * Closes the given sets over the includes relation for Mode::Worklist.
+   * Adds each set to the sets which include it, until no set changes.
+   * Only sets which change are revisited, rather than sweeping over every
+   * set until nothing changes.
+   *
+   * @param theSets
+   *          sets, by non-terminal
+   * @param theIncludes
+   *          see closeSets
+   */
+  static void propagate(std::vector<BitSet> &theSets,
+                        const NonTerminalLists &theIncludes) noexcept;
+
+  /**
+   * Reads the productions into myRHS.
+   */
+  void readProductions() noexcept;
+
+  /**
+   * Stores which non-terminals derive lambda in the grammar's symbols, and
+   * the predict sets in its productions. First and follow sets are only
+   * printed (see operator<<), so are kept here as they are.
+   */
+  void storeSets() noexcept;
+
   /** Grammar definition. */
   Grammar &myGrammar;
 
+  /** Time spent in closeSets. */
+  std::chrono::nanoseconds myClosureTime{0};
+
+  /** Does each non-terminal derive lambda, by non-terminal. */
+  std::vector<bool> myDerivesLambda;
+
+  /** First sets, without lambda (see myDerivesLambda), by non-terminal. */
+  std::vector<BitSet> myFirstSets;
+
+  /** Follow sets, by non-terminal. */
+  std::vector<BitSet> myFollowSets;
+
+  /** Index of lambda, which follows the terminals. */
+  Symbol::Index myLambda;
+
+  /** How sets are propagated. */
+  Mode myMode;
+
+  /** Index of the first non-terminal. */
+  Symbol::Index myNonTerminalBegin;
+
   /** Set of all non-terminal symbols in the productions. */
   Symbol::SymbolSet myNonTerminalSymbols;
 
+  /** Predict sets, by production number - 1. */
+  std::vector<BitSet> myPredictSets;
+
   /** All productions */
   std::vector<std::shared_ptr<Production>> myProductions;
 
+  /**
+   * Terminal and non-terminal symbols of the RHS of each production, by
+   * production number - 1.
+   */
+  std::vector<IndexList> myRHS;
+
+  /**
+   * Size of the sets, which hold terminals and lambda: [0, myLambda].
+   */
+  uint32_t mySetSize;
+
+  /**
+   * Does each suffix of each RHS (see getSuffix) derive lambda. The
+   * suffixes of production P are RHS[I..] for I in [0, size of RHS].
+   */
+  std::vector<bool> mySuffixDerivesLambda;
+
+  /**
+   * Position of the first suffix of each production (see getSuffix), by
+   * production number - 1.
+   */
+  std::vector<uint32_t> mySuffixes;
+
+  /** First set, without lambda, of each suffix (see getSuffix). */
+  std::vector<BitSet> mySuffixFirstSets;
+
   /** Set of all symbols in the productions . */
   Symbol::SymbolSet mySymbols;
 
+  /** Grammar symbol names and kinds. */
+  const SymbolRegistry &mySymbolRegistry;
+
   /** Set of all terminal symbols in the productions. */
   Symbol::SymbolSet myTerminalSymbols;
 };
@@ -0,0 +1,226 @@
+/**
+ * @file GrammarCache.cpp
+ * @brief Implementation of GrammarCache class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "GrammarCache.h"
+
+constexpr uint64_t GrammarCache::HASH_BASIS;
+constexpr uint32_t GrammarCache::VERSION;
+const char GrammarCache::MAGIC[8] = {'U', 'C', 'G', 'R', 'A', 'M', 'M', 'R'};
+
+//*******************************************************
+// GrammarCache::GrammarCache
+//*******************************************************
+GrammarCache::GrammarCache(const std::string &theCacheFile,
+                           const std::string &theGrammarFile) :
+  myCacheFile(theCacheFile)
+{
+  std::ifstream grammarFile(theGrammarFile, std::ios::in | std::ios::binary);
+  if (! grammarFile.is_open())
+  {
+    auto localErrno = errno;
+    throw std::runtime_error("Failed to open grammar definition file '" +
+                             theGrammarFile + "': " +
+                             std::strerror(localErrno));
+  }
+
+  std::string contents{std::istreambuf_iterator<char>(grammarFile),
+                      std::istreambuf_iterator<char>()};
+  myGrammarHash = hash(contents.data(), contents.size());
+
+  map();
+}
+
+//*******************************************************
+// GrammarCache::~GrammarCache
+//*******************************************************
+GrammarCache::~GrammarCache()
+{
+  if (myMapping != nullptr)
+  {
+    ::munmap(myMapping, myMappingSize);
+  }
+}
+
+//*******************************************************
+// GrammarCache::getGrammarHash
+//*******************************************************
+uint64_t GrammarCache::getGrammarHash() const noexcept
+{
+  return myGrammarHash;
+}
+
+//*******************************************************
+// GrammarCache::getReader
+//*******************************************************
+GrammarCache::Reader GrammarCache::getReader() const noexcept
+{
+  auto begin = static_cast<const char*>(myMapping);
+  return Reader(begin + sizeof(Header), begin + myMappingSize);
+}
+
+//*******************************************************
+// GrammarCache::hash
+//*******************************************************
+uint64_t GrammarCache::hash(const char *theBytes, std::size_t theSize,
+                            uint64_t theHash) noexcept
+{
+  for (std::size_t ii = 0; ii < theSize; ++ii)
+  {
+    theHash ^= static_cast<unsigned char>(theBytes[ii]);
+    theHash *= 0x100000001b3ull;
+  }
+  return theHash;
+}
+
+//*******************************************************
+// GrammarCache::isValid
+//*******************************************************
+bool GrammarCache::isValid() const noexcept
+{
+  return myMapping != nullptr;
+}
+
+//*******************************************************
+// GrammarCache::map
+//*******************************************************
+void GrammarCache::map() noexcept
+{
+  int fileDescriptor = ::open(myCacheFile.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    return;
+  }
+
+  struct stat fileStatus;
+  if (::fstat(fileDescriptor, &fileStatus) == 0 &&
+      S_ISREG(fileStatus.st_mode) &&
+      static_cast<std::size_t>(fileStatus.st_size) >= sizeof(Header))
+  {
+    void *mapping = ::mmap(nullptr, fileStatus.st_size, PROT_READ,
+                           MAP_PRIVATE, fileDescriptor, 0);
+    if (MAP_FAILED != mapping)
+    {
+      Header header;
+      std::memcpy(&header, mapping, sizeof(header));
+      auto payload = static_cast<const char*>(mapping) + sizeof(Header);
+      if (std::memcmp(header.myMagic, MAGIC, sizeof(MAGIC)) == 0 &&
+          header.myVersion == VERSION &&
+          header.myGrammarHash == myGrammarHash &&
+          header.myPayloadSize == fileStatus.st_size - sizeof(Header) &&
+          header.myPayloadHash == hash(payload, header.myPayloadSize))
+      {
+        myMapping = mapping;
+        myMappingSize = fileStatus.st_size;
+      }
+      else
+      {
+        ::munmap(mapping, fileStatus.st_size);
+      }
+    }
+  }
+
+  // The mapping stays valid once the file is closed.
+  ::close(fileDescriptor);
+}
+
+//*******************************************************
+// GrammarCache::save
+//*******************************************************
+void GrammarCache::save(const Writer &theWriter) const
+{
+  Header header{};
+  std::memcpy(header.myMagic, MAGIC, sizeof(MAGIC));
+  header.myVersion = VERSION;
+  header.myGrammarHash = myGrammarHash;
+  header.myPayloadSize = theWriter.getBytes().size();
+  header.myPayloadHash = hash(theWriter.getBytes().data(),
+                              theWriter.getBytes().size());
+
+  // Write a private file and rename it over the cache, so nothing ever maps
+  // a partially written cache.
+  auto temporaryFile = myCacheFile + "." + std::to_string(::getpid());
+  std::ofstream file(temporaryFile,
+                     std::ios::out | std::ios::binary | std::ios::trunc);
+  file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  file.write(theWriter.getBytes().data(), theWriter.getBytes().size());
+  file.close();
+  auto localErrno = errno;
+
+  if (! file || std::rename(temporaryFile.c_str(), myCacheFile.c_str()) != 0)
+  {
+    if (file)
+    {
+      localErrno = errno;
+    }
+    std::remove(temporaryFile.c_str());
+    throw std::runtime_error("Failed to write grammar cache '" +
+                             myCacheFile + "': " +
+                             std::strerror(localErrno));
+  }
+}
+
+//*******************************************************
+// GrammarCache::Reader::Reader
+//*******************************************************
+GrammarCache::Reader::Reader(const char *theBegin, const char *theEnd)
+  noexcept :
+  myCursor(theBegin),
+  myEnd(theEnd)
+{
+}
+
+//*******************************************************
+// GrammarCache::Reader::advance
+//*******************************************************
+const char* GrammarCache::Reader::advance(std::size_t theSize)
+{
+  if (theSize > static_cast<std::size_t>(myEnd - myCursor))
+  {
+    throw std::runtime_error("Grammar cache is corrupt.");
+  }
+  auto bytes = myCursor;
+  myCursor += theSize;
+  return bytes;
+}
+
+//*******************************************************
+// GrammarCache::Reader::readString
+//*******************************************************
+std::string GrammarCache::Reader::readString()
+{
+  auto size = read<uint32_t>();
+  return std::string(advance(size), size);
+}
+
+//*******************************************************
+// GrammarCache::Writer::getBytes
+//*******************************************************
+const std::string& GrammarCache::Writer::getBytes() const noexcept
+{
+  return myBytes;
+}
+
+//*******************************************************
+// GrammarCache::Writer::write
+//*******************************************************
+void GrammarCache::Writer::write(const std::string &theString)
+{
+  write<uint32_t>(theString.size());
+  myBytes.append(theString);
+}
@@ -0,0 +1,366 @@
+#ifndef GRAMMARCACHE_H
+#define GRAMMARCACHE_H
+
+/**
+ * @file GrammarCache.h
+ * @brief Defines the class which stores an analyzed grammar in a file.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+/**
+ * Binary file holding everything the compiler builds from a grammar file
+ * before it can compile: the frozen ScannerTable, the symbols, the
+ * productions (actions included) and the PredictTable. Loading it skips
+ * reading the grammar text, finalizing the scanner table and analyzing the
+ * grammar.
+ *
+ * The file is a header followed by a payload. The header holds a magic
+ * string, the format VERSION, a hash of the contents of the grammar file
+ * the cache was built from and a hash of the payload. A cache whose header
+ * does not match the current grammar file, or whose payload does not match
+ * its hash, is stale and is not loaded.
+ *
+ * The payload is written and read in order by the classes being cached
+ * (see Writer and Reader), in the host's byte order. The file is mapped,
+ * not read, so loading costs little more than hashing the payload and
+ * copying the tables out of the mapping. The loaders still check every
+ * index they read, so a payload which matches its hash but not its
+ * grammar (or an embedded grammar, which has no hash) is reported as corrupt
+ * rather than crashing the compiler.
+ *
+ * The file is replaced with a rename, so compilers running at the same
+ * time always see either the old or the new cache.
+ */
+class GrammarCache
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Format version. Increment on any change to what is written.
+   */
+  static constexpr uint32_t VERSION = 6;
+
+  /** Starting value of hash. */
+  static constexpr uint64_t HASH_BASIS = 0xcbf29ce484222325ull;
+
+  /**
+   * Reads the payload of a cache, in the order it was written.
+   */
+  class Reader
+  {
+    public:
+
+    /**
+     * Constructor
+     *
+     * @param theBegin
+     *          start of the payload
+     * @param theEnd
+     *          end of the payload
+     */
+    Reader(const char *theBegin, const char *theEnd) noexcept;
+
+    /**
+     * Reads a value.
+     *
+     * @return value
+     * @throws std::runtime_error
+     *          if the payload is too short
+     */
+    template<typename T>
+    T read()
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be cached.");
+      T value;
+      std::memcpy(&value, advance(sizeof(T)), sizeof(T));
+      return value;
+    }
+
+    /**
+     * Reads a vector of values written with Writer::write.
+     *
+     * @param theValues
+     *          OUT parameter - values read
+     * @throws std::runtime_error
+     *          if the payload is too short
+     */
+    template<typename T>
+    void read(std::vector<T> &theValues)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be cached.");
+      std::size_t size = read<uint32_t>();
+      // Checked before resizing, a corrupt size could be huge.
+      auto values = advance(size * sizeof(T));
+      theValues.resize(size);
+      if (size > 0)
+      {
+        std::memcpy(theValues.data(), values, size * sizeof(T));
+      }
+    }
+
+    /**
+     * Reads a string written with Writer::write.
+     *
+     * @return string
+     * @throws std::runtime_error
+     *          if the payload is too short
+     */
+    std::string readString();
+
+    private:
+
+    /**
+     * Moves past the given number of bytes.
+     *
+     * @param theSize
+     *          number of bytes
+     * @return first of the bytes
+     * @throws std::runtime_error
+     *          if the payload is too short
+     */
+    const char* advance(std::size_t theSize);
+
+    /** Next byte to read. */
+    const char *myCursor;
+
+    /** End of the payload. */
+    const char *myEnd;
+  };
+
+  /**
+   * Builds the payload of a cache.
+   */
+  class Writer
+  {
+    public:
+
+    /**
+     * Returns the payload written so far.
+     *
+     * @return payload
+     */
+    const std::string& getBytes() const noexcept;
+
+    /**
+     * Writes a value.
+     *
+     * @param theValue
+     *          value to write
+     */
+    template<typename T>
+    void write(const T &theValue)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be cached.");
+      myBytes.append(reinterpret_cast<const char*>(&theValue), sizeof(T));
+    }
+
+    /**
+     * Writes a vector of values, preceded by its size.
+     *
+     * @param theValues
+     *          values to write
+     */
+    template<typename T>
+    void write(const std::vector<T> &theValues)
+    {
+      write(theValues.data(), theValues.size());
+    }
+
+    /**
+     * Writes an array of values, preceded by its size, as a vector of them
+     * is written.
+     *
+     * @param theValues
+     *          values to write
+     * @param theSize
+     *          number of values
+     */
+    template<typename T>
+    void write(const T *theValues, std::size_t theSize)
+    {
+      static_assert(std::is_trivially_copyable<T>::value,
+                    "Only trivially copyable values can be cached.");
+      write<uint32_t>(theSize);
+      if (theSize > 0)
+      {
+        myBytes.append(reinterpret_cast<const char*>(theValues),
+                       theSize * sizeof(T));
+      }
+    }
+
+    /**
+     * Writes a string, preceded by its size.
+     *
+     * @param theString
+     *          string to write
+     */
+    void write(const std::string &theString);
+
+    private:
+
+    /** Payload */
+    std::string myBytes;
+  };
+
+  /**
+   * Default constructor.
+   */
+  GrammarCache() = delete;
+
+  /**
+   * Copy constructor
+   */
+  GrammarCache(const GrammarCache &) = delete;
+
+  /**
+   * Move constructor
+   */
+  GrammarCache(GrammarCache &&) = delete;
+
+  /**
+   * Constructor. Hashes the grammar file and maps the cache file, if it
+   * exists and was built from the same grammar file contents.
+   *
+   * @param theCacheFile
+   *          cache file, need not exist
+   * @param theGrammarFile
+   *          grammar file the cache is for
+   * @throws std::runtime_error
+   *          if the grammar file cannot be read
+   */
+  GrammarCache(const std::string &theCacheFile,
+               const std::string &theGrammarFile);
+
+  /**
+   * Destructor
+   */
+  ~GrammarCache();
+
+  /**
+   * Copy assignment operator
+   */
+  GrammarCache& operator=(const GrammarCache &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  GrammarCache& operator=(GrammarCache &&) = delete;
+
+  /**
+   * Returns the grammar file hash, which identifies the grammar the cache
+   * is for.
+   *
+   * @return grammar file hash
+   */
+  uint64_t getGrammarHash() const noexcept;
+
+  /**
+   * Returns a reader of the cached payload. Only valid if isValid returns
+   * true.
+   *
+   * @return payload reader
+   */
+  Reader getReader() const noexcept;
+
+  /**
+   * Returns the FNV-1a hash of the given bytes, continuing from theHash.
+   *
+   * @param theBytes
+   *          bytes to hash
+   * @param theSize
+   *          number of bytes
+   * @param theHash
+   *          hash of the bytes before theBytes, HASH_BASIS for none
+   * @return hash
+   */
+  static uint64_t hash(const char *theBytes, std::size_t theSize,
+                       uint64_t theHash = HASH_BASIS) noexcept;
+
+  /**
+   * Returns true if the cache file exists and matches the grammar file.
+   *
+   * @return true if the cache can be loaded
+   */
+  bool isValid() const noexcept;
+
+  /**
+   * Replaces the cache file with the given payload, for the grammar file
+   * given at construction.
+   *
+   * @param theWriter
+   *          payload
+   * @throws std::runtime_error
+   *          if the file cannot be written
+   */
+  void save(const Writer &theWriter) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Start of the cache file.
+   */
+  class Header
+  {
+    public:
+
+    /** Identifies the file as a grammar cache. */
+    char myMagic[8];
+
+    /** Format version, see VERSION. */
+    uint32_t myVersion;
+
+    /** Hash of the contents of the grammar file. */
+    uint64_t myGrammarHash;
+
+    /** Size of the payload following the header, in bytes. */
+    uint64_t myPayloadSize;
+
+    /** Hash of the payload. */
+    uint64_t myPayloadHash;
+  };
+
+  /** Value of Header::myMagic */
+  static const char MAGIC[8];
+
+  /**
+   * Maps the cache file and checks its header.
+   */
+  void map() noexcept;
+
+  /** Name of the cache file. */
+  const std::string myCacheFile;
+
+  /** Hash of the contents of the grammar file. */
+  uint64_t myGrammarHash = 0;
+
+  /** Start of the mapping, null if there is no valid cache. */
+  void *myMapping = nullptr;
+
+  /** Size of the mapping, in bytes. */
+  std::size_t myMappingSize = 0;
+};
+
+#endif
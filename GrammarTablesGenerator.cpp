@@ -0,0 +1,358 @@
+/**
+ * @file GrammarTablesGenerator.cpp
+ * @brief Implementation of GrammarTablesGenerator class
+ *
+ * @author Michael Albers
+ */
+
+#include <cctype>
+#include <climits>
+#include <iomanip>
+#include <sstream>
+
+#include "GrammarTablesGenerator.h"
+#include "PredictTable.h"
+#include "ScannerTable.h"
+
+namespace
+{
+  /** Names of the scanner table actions, as written in the source. */
+  const char *ACTIONS[] = {
+    "Error",
+    "MoveAppend",
+    "MoveNoAppend",
+    "HaltAppend",
+    "HaltNoAppend",
+    "HaltReuse"
+  };
+
+  /** Names of the parse stack entry kinds, as written in the source. */
+  const char *KINDS[] = {
+    "Terminal",
+    "NonTerminal",
+    "Action",
+    "EOP"
+  };
+
+  /**
+   * Returns the initializers of the given numbers.
+   *
+   * @param theValues
+   *          numbers
+   * @param theSize
+   *          number of numbers
+   * @return initializers
+   */
+  template<typename T>
+  std::vector<std::string> toElements(const T *theValues, uint32_t theSize)
+  {
+    std::vector<std::string> elements;
+    for (auto ii = 0u; ii < theSize; ++ii)
+    {
+      elements.push_back(std::to_string(theValues[ii]));
+    }
+    return elements;
+  }
+}
+
+//*******************************************************
+// GrammarTablesGenerator::GrammarTablesGenerator
+//*******************************************************
+GrammarTablesGenerator::GrammarTablesGenerator(
+  const GrammarCache::Writer &theWriter,
+  const ScannerTable &theScannerTable,
+  const PredictTable &thePredictTable,
+  const std::string &theGrammarFile) :
+  myGrammarFile(theGrammarFile),
+  myPredictTable(thePredictTable),
+  myScannerTable(theScannerTable),
+  myWriter(theWriter)
+{
+  auto start = myGrammarFile.find_last_of('/');
+  myName = myGrammarFile.substr(start == std::string::npos ? 0 : start + 1);
+  myName = myName.substr(0, myName.find_last_of('.'));
+}
+
+//*******************************************************
+// GrammarTablesGenerator::generate
+//*******************************************************
+void GrammarTablesGenerator::generate(std::ostream &theOS) const
+{
+  static constexpr uint32_t BYTES_PER_LINE = 16;
+
+  const auto &tables = myWriter.getBytes();
+
+  theOS << "/**" << std::endl
+        << " * @file" << std::endl
+        << " * @brief Analyzed tables of " << myGrammarFile << std::endl
+        << " *" << std::endl
+        << " * Generated by GrammarTablesGenerator, do not edit." << std::endl
+        << " */" << std::endl
+        << std::endl
+        << "#include \"EmbeddedGrammar.h\"" << std::endl
+        << std::endl
+        << "namespace" << std::endl
+        << "{" << std::endl
+        << "  /**" << std::endl
+        << "   * GrammarCache payload, version " << GrammarCache::VERSION
+        << ", of the symbols and" << std::endl
+        << "   * productions." << std::endl
+        << "   */" << std::endl
+        << "  constexpr char TABLES[] =";
+
+  // Octal escapes are always 3 digits, so can't run into the next byte.
+  theOS << std::oct << std::setfill('0');
+  for (auto ii = 0u; ii < tables.size(); ++ii)
+  {
+    if (0 == ii % BYTES_PER_LINE)
+    {
+      theOS << std::endl << "    \"";
+    }
+    theOS << "\\" << std::setw(3)
+          << static_cast<uint32_t>(static_cast<unsigned char>(tables[ii]));
+    if (BYTES_PER_LINE - 1 == ii % BYTES_PER_LINE || ii + 1 == tables.size())
+    {
+      theOS << "\"";
+    }
+  }
+  theOS << std::dec << std::setfill(' ');
+  if (tables.empty())
+  {
+    theOS << " \"\"";
+  }
+  theOS << ";" << std::endl;
+
+  auto scannerTables = generateScannerTables(theOS);
+  auto predictTables = generatePredictTables(theOS);
+
+  theOS << std::endl
+        << "  constexpr EmbeddedGrammar GRAMMAR = {" << std::endl
+        << "    \"" << myName << "\"," << std::endl
+        << "    \"" << myGrammarFile << "\"," << std::endl
+        << "    TABLES," << std::endl
+        << "    sizeof(TABLES) - 1," << std::endl
+        << scannerTables << "," << std::endl
+        << predictTables << std::endl
+        << "  };" << std::endl
+        << std::endl
+        << "  const bool registered =" << std::endl
+        << "    EmbeddedGrammar::registerGrammar(GRAMMAR);" << std::endl
+        << "}" << std::endl;
+}
+
+//*******************************************************
+// GrammarTablesGenerator::generateArray
+//*******************************************************
+std::string GrammarTablesGenerator::generateArray(
+  std::ostream &theOS,
+  const std::string &theComment,
+  const std::string &theType,
+  const std::string &theName,
+  const std::vector<std::string> &theElements)
+{
+  static constexpr std::size_t LINE_LENGTH = 79;
+  static const std::string INDENT = "    ";
+
+  if (theElements.empty())
+  {
+    return "nullptr";
+  }
+
+  theOS << std::endl
+        << "  /** " << theComment << " */" << std::endl
+        << "  constexpr " << theType << " " << theName << "[] = {";
+
+  // As many elements to a line as fit.
+  std::size_t column = LINE_LENGTH;
+  for (auto ii = 0u; ii < theElements.size(); ++ii)
+  {
+    std::string element = theElements[ii] +
+      (ii + 1 < theElements.size() ? "," : "");
+    if (column + 1 + element.size() > LINE_LENGTH)
+    {
+      theOS << std::endl << INDENT << element;
+      column = INDENT.size() + element.size();
+    }
+    else
+    {
+      theOS << " " << element;
+      column += 1 + element.size();
+    }
+  }
+  theOS << std::endl << "  };" << std::endl;
+
+  return theName;
+}
+
+//*******************************************************
+// GrammarTablesGenerator::generatePredictTables
+//*******************************************************
+std::string GrammarTablesGenerator::generatePredictTables(
+  std::ostream &theOS) const
+{
+  const auto &tables = myPredictTable.getTables();
+
+  std::vector<std::string> pushes;
+  for (auto ii = 0u; ii < tables.myPushesSize; ++ii)
+  {
+    const auto &push = tables.myPushes[ii];
+    pushes.push_back(
+      "ParseStackEntry(ParseStackEntry::Kind::" +
+      std::string(KINDS[static_cast<uint32_t>(push.getKind())]) + ", " +
+      std::to_string(push.getIndex()) + ")");
+  }
+
+  auto nonTerminals = generateArray(
+    theOS, "Predict table rows, see PredictTable::Tables.", "Symbol::Index",
+    "NON_TERMINALS",
+    toElements(tables.myNonTerminals, tables.myNonTerminalsSize));
+  auto terminals = generateArray(
+    theOS, "Predict table columns.", "Symbol::Index", "TERMINALS",
+    toElements(tables.myTerminals, tables.myTerminalsSize));
+  auto table = generateArray(
+    theOS, "Dense predict table.", "uint16_t", "TABLE",
+    toElements(tables.myTable, tables.myTableSize));
+  auto comb = generateArray(
+    theOS, "Compressed predict table entries.", "uint32_t", "COMB",
+    toElements(tables.myComb, tables.myCombSize));
+  auto rowBases = generateArray(
+    theOS, "Position of each row in COMB.", "uint32_t", "ROW_BASES",
+    toElements(tables.myRowBases, tables.myRowsSize));
+  auto rowDefaults = generateArray(
+    theOS, "Default of each row of COMB.", "uint16_t", "ROW_DEFAULTS",
+    toElements(tables.myRowDefaults, tables.myRowsSize));
+  auto numberGrammarSymbols = generateArray(
+    theOS, "Number of grammar symbols of each production.", "uint32_t",
+    "NUMBER_GRAMMAR_SYMBOLS",
+    toElements(tables.myNumberGrammarSymbols, tables.myNumberProductions));
+  auto pushOffsets = generateArray(
+    theOS, "Start of each production's push sequence.", "uint32_t",
+    "PUSH_OFFSETS",
+    toElements(tables.myPushOffsets, tables.myNumberProductions + 1));
+  auto pushesName = generateArray(
+    theOS, "Push sequences of the productions.", "ParseStackEntry",
+    "PUSHES", pushes);
+
+  std::ostringstream initializer;
+  initializer
+    << "    {" << std::endl
+    << "      PredictTable::Representation::"
+    << (PredictTable::Representation::Dense == tables.myRepresentation ?
+        "Dense" : "Compressed") << "," << std::endl
+    << "      " << tables.myLargestColumnNameSize << ", "
+    << tables.myLargestNonTerminalNameSize << "," << std::endl
+    << "      " << nonTerminals << ", " << tables.myNonTerminalsSize << ","
+    << std::endl
+    << "      " << terminals << ", " << tables.myTerminalsSize << ","
+    << std::endl
+    << "      " << table << ", " << tables.myTableSize << "," << std::endl
+    << "      " << comb << ", " << tables.myCombSize << "," << std::endl
+    << "      " << rowBases << ", " << rowDefaults << ", "
+    << tables.myRowsSize << "," << std::endl
+    << "      " << numberGrammarSymbols << ", "
+    << tables.myNumberProductions << "," << std::endl
+    << "      " << pushOffsets << "," << std::endl
+    << "      " << pushesName << ", " << tables.myPushesSize << std::endl
+    << "    }";
+  return initializer.str();
+}
+
+//*******************************************************
+// GrammarTablesGenerator::generateScannerTables
+//*******************************************************
+std::string GrammarTablesGenerator::generateScannerTables(
+  std::ostream &theOS) const
+{
+  const auto &tables = myScannerTable.getTables();
+
+  std::vector<std::string> entries;
+  for (auto ii = 0u; ii < tables.myStates * tables.myColumns; ++ii)
+  {
+    const auto &entry = tables.myEntries[ii];
+    entries.push_back(
+      "ScannerTable::PackedEntry(ScannerTable::Action::" +
+      std::string(ACTIONS[static_cast<uint32_t>(entry.getAction())]) + ", " +
+      std::to_string(entry.getNextState()) + ", " +
+      std::to_string(entry.getTerminalId()) + ")");
+  }
+
+  std::vector<std::string> runs;
+  for (auto ii = 0u; ii < tables.myStates; ++ii)
+  {
+    const auto &run = tables.myRuns[ii];
+    std::string low;
+    std::string span;
+    for (auto range = 0u; range < ScannerTable::Run::MAX_RANGES; ++range)
+    {
+      low += (range > 0 ? ", " : "") + std::to_string(run.myLow[range]);
+      span += (range > 0 ? ", " : "") + std::to_string(run.mySpan[range]);
+    }
+    runs.push_back("ScannerTable::Run({{" + low + "}}, {{" + span + "}}, " +
+                   std::to_string(run.myNumberRanges) + ", " +
+                   (run.myAppend ? "true" : "false") + ")");
+  }
+
+  // Reserved words are letters and digits, anything else is escaped.
+  std::vector<std::string> slots;
+  for (auto ii = 0u; ii < tables.myNumberReservedWords; ++ii)
+  {
+    const auto &slot = tables.myReservedWordSlots[ii];
+    std::ostringstream word;
+    word << std::oct << std::setfill('0');
+    for (auto character = 0u; character < slot.myLength; ++character)
+    {
+      auto value = static_cast<unsigned char>(slot.myWord[character]);
+      if (std::isalnum(value))
+      {
+        word << slot.myWord[character];
+      }
+      else
+      {
+        word << "\\" << std::setw(3) << static_cast<uint32_t>(value);
+      }
+    }
+    slots.push_back("{\"" + word.str() + "\", " +
+                    std::to_string(slot.myLength) + ", " +
+                    std::to_string(slot.myTerminalId) + "}");
+  }
+
+  auto columnMap = generateArray(
+    theOS, "Scanner table, see ScannerTable::Tables.", "uint32_t",
+    "COLUMN_MAP", toElements(tables.myColumnMap, UCHAR_MAX + 1));
+  auto entriesName = generateArray(
+    theOS, "Frozen scanner table entries.", "ScannerTable::PackedEntry",
+    "ENTRIES", entries);
+  auto runsName = generateArray(
+    theOS, "Run of each state.", "ScannerTable::Run", "RUNS", runs);
+  auto displacements = generateArray(
+    theOS, "Reserved word hash displacements.", "uint32_t",
+    "RESERVED_WORD_DISPLACEMENTS",
+    toElements(tables.myReservedWordDisplacements,
+               tables.myNumberReservedWords));
+  auto slotsName = generateArray(
+    theOS, "Reserved word hash slots.", "ScannerTable::ReservedWord",
+    "RESERVED_WORD_SLOTS", slots);
+  auto reservedWordTerminals = generateArray(
+    theOS, "Terminals reserved words are looked up for.", "uint8_t",
+    "RESERVED_WORD_TERMINALS",
+    toElements(tables.myReservedWordTerminals, tables.myNumberTerminalIds));
+
+  std::ostringstream initializer;
+  initializer
+    << "    {" << std::endl
+    << "      " << columnMap << "," << std::endl
+    << "      " << entriesName << ", " << tables.myColumns << ", "
+    << tables.myStates << "," << std::endl
+    << "      " << tables.myOriginalColumns << ", "
+    << tables.myOriginalStates << "," << std::endl
+    << "      " << runsName << "," << std::endl
+    << "      " << tables.myFingerprint << "ull," << std::endl
+    << "      " << displacements << ", " << slotsName << ", "
+    << tables.myNumberReservedWords << "," << std::endl
+    << "      " << tables.myReservedWordMinLength << ", "
+    << tables.myReservedWordMaxLength << "," << std::endl
+    << "      " << reservedWordTerminals << ", "
+    << tables.myNumberTerminalIds << std::endl
+    << "    }";
+  return initializer.str();
+}
@@ -0,0 +1,157 @@
+#ifndef GRAMMARTABLESGENERATOR_H
+#define GRAMMARTABLESGENERATOR_H
+
+/**
+ * @file GrammarTablesGenerator.h
+ * @brief Generates a source file holding a grammar's analyzed tables.
+ *
+ * @author Michael Albers
+ */
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "GrammarCache.h"
+
+class PredictTable;
+class ScannerTable;
+
+/**
+ * Writes the C++ source of an EmbeddedGrammar: the GrammarCache payload of
+ * a grammar's symbols and productions as a constexpr array, the arrays of
+ * its ScannerTable::Tables and PredictTable::Tables as typed constexpr
+ * arrays, and the EmbeddedGrammar describing them, which registers itself
+ * with EmbeddedGrammar::registerGrammar during static initialization.
+ * Linking the generated file into a program is all it takes to embed the
+ * grammar.
+ */
+class GrammarTablesGenerator
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  GrammarTablesGenerator() = delete;
+
+  /**
+   * Copy constructor
+   */
+  GrammarTablesGenerator(const GrammarTablesGenerator&) = default;
+
+  /**
+   * Move constructor
+   */
+  GrammarTablesGenerator(GrammarTablesGenerator&&) = default;
+
+  /**
+   * Constructor.
+   *
+   * @param theWriter
+   *          cache payload of the grammar, saved without its scanner table
+   * @param theScannerTable
+   *          scanner table of the grammar
+   * @param thePredictTable
+   *          predict table of the grammar
+   * @param theGrammarFile
+   *          grammar file the tables were built from
+   */
+  GrammarTablesGenerator(const GrammarCache::Writer &theWriter,
+                         const ScannerTable &theScannerTable,
+                         const PredictTable &thePredictTable,
+                         const std::string &theGrammarFile);
+
+  /**
+   * Destructor
+   */
+  ~GrammarTablesGenerator() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  GrammarTablesGenerator& operator=(const GrammarTablesGenerator&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  GrammarTablesGenerator& operator=(GrammarTablesGenerator&&) = delete;
+
+  /**
+   * Writes the generated source.
+   *
+   * @param theOS
+   *          stream to write to
+   */
+  void generate(std::ostream &theOS) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Writes a constexpr array, unless it is empty.
+   *
+   * @param theOS
+   *          stream to write to
+   * @param theComment
+   *          doc comment of the array
+   * @param theType
+   *          element type
+   * @param theName
+   *          array name
+   * @param theElements
+   *          initializer of each element
+   * @return theName, or "nullptr" if there are no elements
+   */
+  static std::string generateArray(
+    std::ostream &theOS, const std::string &theComment,
+    const std::string &theType, const std::string &theName,
+    const std::vector<std::string> &theElements);
+
+  /**
+   * Writes the predict table arrays and returns the initializer of the
+   * PredictTable::Tables pointing at them.
+   *
+   * @param theOS
+   *          stream to write to
+   * @return initializer
+   */
+  std::string generatePredictTables(std::ostream &theOS) const;
+
+  /**
+   * Writes the scanner table arrays and returns the initializer of the
+   * ScannerTable::Tables pointing at them.
+   *
+   * @param theOS
+   *          stream to write to
+   * @return initializer
+   */
+  std::string generateScannerTables(std::ostream &theOS) const;
+
+  /** Grammar file the tables were built from. */
+  const std::string myGrammarFile;
+
+  /** Name of the grammar, the grammar file name without its extension. */
+  std::string myName;
+
+  /** Predict table of the grammar. */
+  const PredictTable &myPredictTable;
+
+  /** Scanner table of the grammar. */
+  const ScannerTable &myScannerTable;
+
+  /** Cache payload of the grammar. */
+  const GrammarCache::Writer &myWriter;
+};
+
+#endif
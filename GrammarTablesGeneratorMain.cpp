@@ -0,0 +1,78 @@
+/**
+ * @file GrammarTablesGeneratorMain.cpp
+ * @brief Entry point of the grammar tables source generator
+ *
+ * @author Michael Albers
+ */
+
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "ErrorWarningTracker.h"
+#include "Grammar.h"
+#include "GrammarAnalyzer.h"
+#include "GrammarCache.h"
+#include "GrammarTablesGenerator.h"
+#include "PredictTable.h"
+#include "ScannerTable.h"
+
+static void usage(char *theProgramName);
+
+int main(int argc, char **argv)
+{
+  try
+  {
+    if (argc != 3)
+    {
+      throw std::runtime_error("No grammar and/or output files provided.");
+    }
+
+    std::string grammarFile(argv[1]);
+    std::string outputFile(argv[2]);
+
+    ErrorWarningTracker ewTracker(grammarFile);
+    ScannerTable scannerTable;
+    Grammar grammar(grammarFile, ewTracker, scannerTable);
+    GrammarAnalyzer grammarAnalyzer(grammar);
+    PredictTable predictTable(grammar);
+
+    // The scanner and predict tables are written as arrays of their own.
+    GrammarCache::Writer writer;
+    grammar.save(writer, false);
+
+    std::ofstream output(outputFile);
+    if (! output)
+    {
+      throw std::runtime_error("Failed to open '" + outputFile + "'.");
+    }
+
+    GrammarTablesGenerator generator(writer, scannerTable, predictTable,
+                                     grammarFile);
+    generator.generate(output);
+
+    output.close();
+    if (! output)
+    {
+      throw std::runtime_error("Failed to write '" + outputFile + "'.");
+    }
+  }
+  catch (const std::exception &exception)
+  {
+    if (std::string(exception.what()).size() > 0)
+    {
+      std::cerr << argv[0] << ": error: " << exception.what() << std::endl;
+    }
+    usage(argv[0]);
+    return 1;
+  }
+
+  return 0;
+}
+
+void usage(char *theProgramName)
+{
+  std::cerr << "Usage: " << theProgramName
+            << " [grammar file] [generated source file]" << std::endl;
+}
@@ -13,19 +13,10 @@ const std::shared_ptr<Symbol> Lambda::ourLambda(new Lambda());
 // Lambda::Lambda
 //*******************************************************
 Lambda::Lambda() :
-  Symbol("Lambda"),
-  myFirstSet{ourLambda}
+  Symbol("Lambda")
 {
 }
 
-//*******************************************************
-// Lambda::addToFirstSet
-//*******************************************************
-void Lambda::addToFirstSet(std::shared_ptr<Symbol> theSymbol) noexcept
-{
-  // Nothing else goes in the first set of Lambda.
-}
-
 //*******************************************************
 // Lambda::getDerivesLambda
 //*******************************************************
@@ -41,11 +32,3 @@ std::shared_ptr<Symbol> Lambda::getInstance() noexcept
 {
   return ourLambda;
 }
-
-//*******************************************************
-// Lambda::getFirstSet
-//*******************************************************
-const Symbol::SymbolSet& Lambda::getFirstSet() const noexcept
-{
-  return myFirstSet;
-}
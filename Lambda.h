@@ -48,12 +48,6 @@ class Lambda : public Symbol
    */
   Lambda& operator=(Lambda&&) = delete;
 
-  /**
-   * @see Symbol.h 
-   */
-  virtual void addToFirstSet(std::shared_ptr<Symbol> theSymbol) noexcept
-    override;
-
   /**
    * Returns true if this symbol derives lambda
    *
@@ -61,13 +55,6 @@ class Lambda : public Symbol
    */
   virtual bool getDerivesLambda() const noexcept override;
 
-  /**
-   * Returns the first set for this symbol
-   *
-   * @return the first set for this symbol
-   */
-  virtual const SymbolSet& getFirstSet() const noexcept override;
-
   /**
    * Returns the singleton lambda.
    *
@@ -92,9 +79,6 @@ class Lambda : public Symbol
 
   /** Singleton lambda. */
   static const std::shared_ptr<Symbol> ourLambda;
-
-  /** Special first set for lambda. */
-  SymbolSet myFirstSet;
 };
 
 #endif
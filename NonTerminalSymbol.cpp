@@ -14,20 +14,3 @@ NonTerminalSymbol::NonTerminalSymbol(const std::string &theName) :
   Symbol(theName)
 {
 }
-
-//*******************************************************
-// NonTerminalSymbol::addToFollowSet
-//*******************************************************
-void NonTerminalSymbol::addToFollowSet(std::shared_ptr<Symbol> theSymbol)
-  noexcept
-{
-  myFollowSet.insert(theSymbol);
-}
-
-//*******************************************************
-// NonTerminalSymbol::getFollowSet
-//*******************************************************
-const Symbol::SymbolSet& NonTerminalSymbol::getFollowSet() const noexcept
-{
-  return myFollowSet;
-}
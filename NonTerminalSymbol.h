@@ -62,21 +62,6 @@ class NonTerminalSymbol : public Symbol
    */
   NonTerminalSymbol& operator=(NonTerminalSymbol&&) = default;
 
-  /**
-   * Adds the given symbol to the follow set.
-   *
-   * @param theSymbol
-   *          symbol to add
-   */
-  void addToFollowSet(std::shared_ptr<Symbol> theSymbol) noexcept;
-
-  /**
-   * Returns the follow set for this symbol
-   *
-   * @return the follow set for this symbol
-   */
-  const SymbolSet& getFollowSet() const noexcept;
-
   // ************************************************************
   // Protected
   // ************************************************************
@@ -86,9 +71,6 @@ class NonTerminalSymbol : public Symbol
   // Private
   // ************************************************************
   private:
-
-  /** Follow set of this symbol. */
-  SymbolSet myFollowSet;
 };
 
 #endif
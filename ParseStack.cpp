@@ -0,0 +1,101 @@
+/**
+ * @file ParseStack.cpp
+ * @brief Implementation of ParseStack class
+ *
+ * @author Michael Albers
+ */
+
+#include "ParseStack.h"
+#include "PredictTable.h"
+
+//*******************************************************
+// ParseStack::endOfProduction
+//*******************************************************
+SemanticStack::Frame ParseStack::endOfProduction(
+  SemanticStack &theSemanticStack) noexcept
+{
+  auto frame = endOfProduction();
+  theSemanticStack.restore(frame);
+  return frame;
+}
+
+//*******************************************************
+// ParseStack::endOfProduction
+//*******************************************************
+SemanticStack::Frame ParseStack::endOfProduction() noexcept
+{
+  auto frame = myEOPFrames.back();
+  myEOPFrames.pop_back();
+  myEntries.pop_back();
+  return frame;
+}
+
+//*******************************************************
+// ParseStack::getEntries
+//*******************************************************
+const std::vector<ParseStackEntry>& ParseStack::getEntries() const noexcept
+{
+  return myEntries;
+}
+
+//*******************************************************
+// ParseStack::getEOPFrames
+//*******************************************************
+const std::vector<SemanticStack::Frame>& ParseStack::getEOPFrames()
+  const noexcept
+{
+  return myEOPFrames;
+}
+
+//*******************************************************
+// ParseStack::predict
+//*******************************************************
+SemanticStack::Frame ParseStack::predict(uint32_t theProductionNumber,
+                                         const PredictTable &thePredictTable,
+                                         SemanticStack &theSemanticStack)
+{
+  auto frame = theSemanticStack.getFrame();
+  auto numberGrammarSymbols =
+    thePredictTable.getNumberGrammarSymbols(theProductionNumber);
+  if (isTail())
+  {
+    theSemanticStack.expandTail(numberGrammarSymbols);
+  }
+  else
+  {
+    theSemanticStack.expand(numberGrammarSymbols);
+  }
+  predict(theProductionNumber, thePredictTable, frame);
+  return frame;
+}
+
+//*******************************************************
+// ParseStack::predict
+//*******************************************************
+void ParseStack::predict(uint32_t theProductionNumber,
+                         const PredictTable &thePredictTable,
+                         const SemanticStack::Frame &theFrame)
+{
+  if (isTail())
+  {
+    myEntries.pop_back();
+  }
+  else
+  {
+    myEntries.back() = ParseStackEntry(ParseStackEntry::Kind::EOP);
+    myEOPFrames.push_back(theFrame);
+  }
+  myEntries.insert(myEntries.end(),
+                   thePredictTable.getPushBegin(theProductionNumber),
+                   thePredictTable.getPushEnd(theProductionNumber));
+}
+
+//*******************************************************
+// ParseStack::start
+//*******************************************************
+void ParseStack::start(Symbol::Index theStartSymbol)
+{
+  myEntries.clear();
+  myEOPFrames.clear();
+  myEntries.emplace_back(ParseStackEntry::Kind::NonTerminal, theStartSymbol);
+}
@@ -0,0 +1,202 @@
+#ifndef PARSESTACK_H
+#define PARSESTACK_H
+
+/**
+ * @file ParseStack.h
+ * @brief Defines the parse stack.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "ParseStackEntry.h"
+#include "SemanticStack.h"
+#include "Symbol.h"
+
+class PredictTable;
+
+/**
+ * The parse stack of an LL(1) parse, with the semantic stack frame of each
+ * of its EOP entries. Predicting a production and ending one are shared by
+ * the Parser, the TraceRenderer replaying its steps and the
+ * ParseTablePrinter printing them, so all three keep the stack the same.
+ *
+ * The accessors are defined here as the parser calls them on every step.
+ */
+class ParseStack
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  ParseStack() = default;
+
+  /**
+   * Copy constructor
+   */
+  ParseStack(const ParseStack &) = default;
+
+  /**
+   * Move constructor
+   */
+  ParseStack(ParseStack &&) = default;
+
+  /**
+   * Destructor
+   */
+  ~ParseStack() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  ParseStack& operator=(const ParseStack &) = default;
+
+  /**
+   * Move assignment operator
+   */
+  ParseStack& operator=(ParseStack &&) = default;
+
+  /**
+   * Returns the entry on top of the stack. The stack must not be empty.
+   *
+   * @return top entry
+   */
+  ParseStackEntry back() const noexcept
+  {
+    return myEntries.back();
+  }
+
+  /**
+   * Pops the EOP on top of the stack, restoring the semantic stack to the
+   * frame saved when its production was predicted.
+   *
+   * @param theSemanticStack
+   *          semantic stack of the parse
+   * @return restored frame
+   */
+  SemanticStack::Frame endOfProduction(SemanticStack &theSemanticStack)
+    noexcept;
+
+  /**
+   * Pops the EOP on top of the stack, leaving any semantic stack alone.
+   *
+   * @return frame saved for the EOP
+   */
+  SemanticStack::Frame endOfProduction() noexcept;
+
+  /**
+   * Returns true if the stack is empty, the parse is over.
+   *
+   * @return true if empty
+   */
+  bool empty() const noexcept
+  {
+    return myEntries.empty();
+  }
+
+  /**
+   * Returns the entries, bottom first.
+   *
+   * @return entries
+   */
+  const std::vector<ParseStackEntry>& getEntries() const noexcept;
+
+  /**
+   * Returns the frames of the EOP entries, bottom first.
+   *
+   * @return EOP frames
+   */
+  const std::vector<SemanticStack::Frame>& getEOPFrames() const noexcept;
+
+  /**
+   * Returns true if predicting the non-terminal on top of the stack elides
+   * the production's EOP, see predict.
+   *
+   * @return true if the production is in tail position
+   */
+  bool isTail() const noexcept
+  {
+    return myEntries.size() > 1 &&
+      ParseStackEntry::Kind::EOP == myEntries[myEntries.size()-2].getKind();
+  }
+
+  /**
+   * Pops the entry on top of the stack.
+   */
+  void pop() noexcept
+  {
+    myEntries.pop_back();
+  }
+
+  /**
+   * Replaces the non-terminal on top of the stack by the given production
+   * and expands the semantic stack for its grammar symbols.
+   *
+   * The EOP replaces the non-terminal, then the RHS goes on top. If the EOP
+   * would be directly on top of another, the production is in tail
+   * position (see isTail): nothing is left to do between the two EOPs, so
+   * its EOP is elided and its semantic records take over the current
+   * production's. This keeps right recursive lists (statements, ids, ...)
+   * from growing both stacks.
+   *
+   * @param theProductionNumber
+   *          production predicted
+   * @param thePredictTable
+   *          table holding the production's entries
+   * @param theSemanticStack
+   *          semantic stack of the parse
+   * @return semantic stack frame before the production was expanded
+   */
+  SemanticStack::Frame predict(uint32_t theProductionNumber,
+                               const PredictTable &thePredictTable,
+                               SemanticStack &theSemanticStack);
+
+  /**
+   * Replaces the non-terminal on top of the stack by the given production,
+   * as predict does, leaving the semantic stack alone.
+   *
+   * @param theProductionNumber
+   *          production predicted
+   * @param thePredictTable
+   *          table holding the production's entries
+   * @param theFrame
+   *          semantic stack frame before the production was expanded,
+   *          saved for its EOP
+   */
+  void predict(uint32_t theProductionNumber,
+               const PredictTable &thePredictTable,
+               const SemanticStack::Frame &theFrame);
+
+  /**
+   * Empties the stack and pushes the start symbol.
+   *
+   * @param theStartSymbol
+   *          index of the start symbol
+   */
+  void start(Symbol::Index theStartSymbol);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Semantic stack frames of the EOP entries in myEntries, bottom first. */
+  std::vector<SemanticStack::Frame> myEOPFrames;
+
+  /** Entries, bottom first. */
+  std::vector<ParseStackEntry> myEntries;
+};
+
+#endif
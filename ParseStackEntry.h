@@ -0,0 +1,102 @@
+#ifndef PARSESTACKENTRY_H
+#define PARSESTACKENTRY_H
+
+/**
+ * @file ParseStackEntry.h
+ * @brief Defines an entry of the parse stack.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+#include "Symbol.h"
+
+/**
+ * An entry of the Parser's parse stack: what kind of entry it is, in the
+ * top bits, and the index of its symbol in the rest. Being a single
+ * integer, entries are pushed and popped without any reference counting,
+ * and a production's entries (see PredictTable::getPushBegin) are pushed
+ * with a plain copy.
+ *
+ * The accessors are defined here as the parser calls them on every step.
+ */
+class ParseStackEntry
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Kinds of entries. */
+  enum class Kind : uint32_t
+  {
+    /** Terminal to match, getIndex is the terminal. */
+    Terminal,
+    /** Non-terminal to predict, getIndex is the non-terminal. */
+    NonTerminal,
+    /** Semantic routine to run, getIndex is the action symbol. */
+    Action,
+    /** End of a production, restores the semantic stack. */
+    EOP
+  };
+
+  /**
+   * Default constructor
+   */
+  ParseStackEntry() = default;
+
+  /**
+   * Constructor
+   *
+   * @param theKind
+   *          kind of entry
+   * @param theIndex
+   *          index of the symbol, unused for an EOP
+   */
+  constexpr ParseStackEntry(Kind theKind, Symbol::Index theIndex = 0) :
+    myEntry((static_cast<uint32_t>(theKind) << KIND_SHIFT) | theIndex)
+  {
+  }
+
+  /**
+   * Returns the symbol index of the entry.
+   *
+   * @return symbol index
+   */
+  constexpr Symbol::Index getIndex() const noexcept
+  {
+    return myEntry & INDEX_MASK;
+  }
+
+  /**
+   * Returns the kind of the entry.
+   *
+   * @return kind
+   */
+  constexpr Kind getKind() const noexcept
+  {
+    return static_cast<Kind>(myEntry >> KIND_SHIFT);
+  }
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Position of the kind in myEntry. */
+  static constexpr uint32_t KIND_SHIFT = 30;
+
+  /** Mask of the symbol index in myEntry. */
+  static constexpr uint32_t INDEX_MASK = (1u << KIND_SHIFT) - 1;
+
+  /** Kind and symbol index. */
+  uint32_t myEntry = 0;
+};
+
+#endif
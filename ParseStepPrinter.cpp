@@ -0,0 +1,184 @@
+/**
+ * @file ParseStepPrinter.cpp
+ * @brief Implementation of ParseStepPrinter class
+ *
+ * @author Michael Albers
+ */
+
+#include <iomanip>
+
+#include "ActionSymbol.h"
+#include "EOPSymbol.h"
+#include "Grammar.h"
+#include "ParseStepPrinter.h"
+#include "Production.h"
+#include "SemanticRecord.h"
+#include "SemanticRoutines.h"
+#include "Token.h"
+
+namespace
+{
+  /** Width of the step column, as the --trace-tables parse table. */
+  const uint32_t STEP_WIDTH = 17;
+}
+
+//*******************************************************
+// ParseStepPrinter::ParseStepPrinter
+//*******************************************************
+ParseStepPrinter::ParseStepPrinter(std::ostream &theOS,
+                                   const Grammar &theGrammar,
+                                   SemanticStack &theSemanticStack,
+                                   const SemanticRoutines &theSemanticRoutines,
+                                   bool thePrintParse,
+                                   bool thePrintGeneration) :
+  myGrammar(theGrammar),
+  myOS(theOS),
+  myPrintGeneration(thePrintGeneration),
+  myPrintParse(thePrintParse),
+  mySemanticRoutines(theSemanticRoutines),
+  mySemanticStack(theSemanticStack)
+{
+}
+
+//*******************************************************
+// ParseStepPrinter::action
+//*******************************************************
+void ParseStepPrinter::action(const ActionSymbol &theAction)
+{
+  const auto &code = mySemanticRoutines.getCode();
+  if (! myInStep)
+  {
+    myNumberCodeLines = code.size();
+    return;
+  }
+
+  printStep("Action") << theAction << '\n';
+
+  if (myPrintGeneration)
+  {
+    for (auto argument : theAction.getArguments())
+    {
+      std::string name{"$"};
+      if (ActionSymbol::LHS_ARGUMENT == argument)
+      {
+        name += "$";
+      }
+      else
+      {
+        name += std::to_string(argument);
+      }
+      printStep(name)
+        << mySemanticStack.getRecordFromArgument(argument).extract() << '\n';
+    }
+
+    for (; myNumberCodeLines < code.size(); ++myNumberCodeLines)
+    {
+      printStep("Generate") << code[myNumberCodeLines] << '\n';
+    }
+  }
+}
+
+//*******************************************************
+// ParseStepPrinter::begin
+//*******************************************************
+void ParseStepPrinter::begin(const Token &theLookAheadToken)
+{
+}
+
+//*******************************************************
+// ParseStepPrinter::beginStep
+//*******************************************************
+void ParseStepPrinter::beginStep(const Token &theLookAheadToken)
+{
+  myInStep = true;
+}
+
+//*******************************************************
+// ParseStepPrinter::endOfProduction
+//*******************************************************
+void ParseStepPrinter::endOfProduction(const SemanticStack::Frame &theFrame)
+{
+  if (myPrintParse && myInStep)
+  {
+    printStep("EOP") << EOPSymbol(theFrame.myCurrentIndex,
+                                  theFrame.myLeftIndex,
+                                  theFrame.myRightIndex,
+                                  theFrame.myTopIndex) << '\n';
+  }
+}
+
+//*******************************************************
+// ParseStepPrinter::endStep
+//*******************************************************
+void ParseStepPrinter::endStep(const Token &theLookAheadToken)
+{
+  myInStep = false;
+}
+
+//*******************************************************
+// ParseStepPrinter::finish
+//*******************************************************
+void ParseStepPrinter::finish()
+{
+  myOS.flush();
+}
+
+//*******************************************************
+// ParseStepPrinter::match
+//*******************************************************
+void ParseStepPrinter::match(const Token &theToken)
+{
+  if (myPrintParse && myInStep)
+  {
+    printStep("Match") << theToken << '\n';
+  }
+}
+
+//*******************************************************
+// ParseStepPrinter::predict
+//*******************************************************
+void ParseStepPrinter::predict(uint32_t theProductionNumber,
+                               const SemanticStack::Frame &theFrame,
+                               bool theEOPElided)
+{
+  if (myPrintParse && myInStep)
+  {
+    printStep("Predict(" + std::to_string(theProductionNumber) + ")")
+      << *myGrammar.getProduction(theProductionNumber);
+    if (theEOPElided)
+    {
+      // Its records replaced those of the production it ends.
+      myOS << " (tail)";
+    }
+    myOS << '\n';
+  }
+}
+
+//*******************************************************
+// ParseStepPrinter::printStep
+//*******************************************************
+std::ostream& ParseStepPrinter::printStep(const std::string &theStep)
+{
+  return myOS << std::left << std::setw(STEP_WIDTH) << theStep << std::right
+              << " | ";
+}
+
+//*******************************************************
+// ParseStepPrinter::skip
+//*******************************************************
+void ParseStepPrinter::skip(Symbol::Index theSymbol)
+{
+  if (myPrintParse && myInStep)
+  {
+    printStep("Skip")
+      << *myGrammar.getSymbolRegistry().getSymbol(theSymbol) << '\n';
+  }
+}
+
+//*******************************************************
+// ParseStepPrinter::start
+//*******************************************************
+void ParseStepPrinter::start()
+{
+  printStep("Parser Action") << "Detail" << '\n';
+}
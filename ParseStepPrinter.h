@@ -0,0 +1,185 @@
+#ifndef PARSESTEPPRINTER_H
+#define PARSESTEPPRINTER_H
+
+/**
+ * @file ParseStepPrinter.h
+ * @brief Defines the tracer printing one line per parse step.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+
+#include "ParseTracer.h"
+
+class Grammar;
+class SemanticRoutines;
+
+/**
+ * Prints each step of the parse as it happens: what the parser did, and
+ * for code generation the records the semantic routine used and the code
+ * it generated. Only what changed is printed, so each step costs the same
+ * whatever the size of the input (see ParseTablePrinter for the full state
+ * of the parse at each step).
+ */
+class ParseStepPrinter : public ParseTracer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  ParseStepPrinter() = delete;
+
+  /**
+   * Copy constructor
+   */
+  ParseStepPrinter(const ParseStepPrinter&) = delete;
+
+  /**
+   * Move constructor
+   */
+  ParseStepPrinter(ParseStepPrinter&&) = delete;
+
+  /**
+   * Constructor
+   *
+   * @param theOS
+   *          stream to print to
+   * @param theGrammar
+   *          language grammar
+   * @param theSemanticStack
+   *          semantic stack of the parse
+   * @param theSemanticRoutines
+   *          semantic routines of the parse
+   * @param thePrintParse
+   *          print parse steps
+   * @param thePrintGeneration
+   *          print code generation steps
+   */
+  ParseStepPrinter(std::ostream &theOS,
+                   const Grammar &theGrammar,
+                   SemanticStack &theSemanticStack,
+                   const SemanticRoutines &theSemanticRoutines,
+                   bool thePrintParse,
+                   bool thePrintGeneration);
+
+  /**
+   * Destructor
+   */
+  virtual ~ParseStepPrinter() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  ParseStepPrinter& operator=(const ParseStepPrinter&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  ParseStepPrinter& operator=(ParseStepPrinter&&) = delete;
+
+  /**
+   * Prints the action, and for code generation its records and the code
+   * it generated.
+   */
+  virtual void action(const ActionSymbol &theAction) override;
+
+  /**
+   * Does nothing, the first token is printed when matched.
+   */
+  virtual void begin(const Token &theLookAheadToken) override;
+
+  /**
+   * Starts printing the step's events.
+   */
+  virtual void beginStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Prints the restored frame.
+   */
+  virtual void endOfProduction(const SemanticStack::Frame &theFrame)
+    override;
+
+  /**
+   * Stops printing events.
+   */
+  virtual void endStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Flushes the stream.
+   */
+  virtual void finish() override;
+
+  /**
+   * Prints the matched token.
+   */
+  virtual void match(const Token &theToken) override;
+
+  /**
+   * Prints the predicted production.
+   */
+  virtual void predict(uint32_t theProductionNumber,
+                       const SemanticStack::Frame &theFrame,
+                       bool theEOPElided) override;
+
+  /**
+   * Prints the skipped symbol.
+   */
+  virtual void skip(Symbol::Index theSymbol) override;
+
+  /**
+   * Prints the header.
+   */
+  virtual void start() override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Prints the start of a line, the step column.
+   *
+   * @param theStep
+   *          step column text
+   * @return myOS
+   */
+  std::ostream& printStep(const std::string &theStep);
+
+  /** Language grammar */
+  const Grammar &myGrammar;
+
+  /** If between beginStep and endStep, when events are printed. */
+  bool myInStep = false;
+
+  /** Number of generated code lines already printed. */
+  std::size_t myNumberCodeLines = 0;
+
+  /** Stream to print to. */
+  std::ostream &myOS;
+
+  /** Print code generation steps */
+  const bool myPrintGeneration;
+
+  /** Print parse steps */
+  const bool myPrintParse;
+
+  /** Semantic routines, for the generated code. */
+  const SemanticRoutines &mySemanticRoutines;
+
+  /** Semantic stack, for the records of semantic routines. */
+  SemanticStack &mySemanticStack;
+};
+
+#endif
@@ -0,0 +1,415 @@
+/**
+ * @file ParseTablePrinter.cpp
+ * @brief Implementation of ParseTablePrinter class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
+
+#include "EOPSymbol.h"
+#include "ErrorWarningTracker.h"
+#include "Grammar.h"
+#include "ParseTablePrinter.h"
+#include "PredictTable.h"
+#include "SemanticRecord.h"
+#include "SemanticRoutines.h"
+
+namespace
+{
+  /** Width of the parser action column. */
+  const uint32_t ACTION_WIDTH = 17;
+
+  /** Width of the parse stack column. */
+  const uint32_t STACK_WIDTH = 1;
+}
+
+//*******************************************************
+// ParseTablePrinter::ParseTablePrinter
+//*******************************************************
+ParseTablePrinter::ParseTablePrinter(
+  std::ostream &theOS,
+  std::vector<Token> theTokens,
+  const Grammar &theGrammar,
+  const PredictTable &thePredictTable,
+  const SemanticStack &theSemanticStack,
+  const SemanticRoutines &theSemanticRoutines,
+  const ErrorWarningTracker &theEWTracker,
+  bool thePrintParse,
+  bool thePrintGeneration) :
+  myEWTracker(theEWTracker),
+  myGrammar(theGrammar),
+  myOS(theOS),
+  myPredictTable(thePredictTable),
+  myPrintGeneration(thePrintGeneration),
+  myPrintParse(thePrintParse),
+  mySemanticRoutines(theSemanticRoutines),
+  mySemanticStack(theSemanticStack),
+  myTokens(std::move(theTokens))
+{
+}
+
+//*******************************************************
+// ParseTablePrinter::action
+//*******************************************************
+void ParseTablePrinter::action(const ActionSymbol &theAction)
+{
+  myStack.pop();
+}
+
+//*******************************************************
+// ParseTablePrinter::begin
+//*******************************************************
+void ParseTablePrinter::begin(const Token &theLookAheadToken)
+{
+  printState(theLookAheadToken);
+}
+
+//*******************************************************
+// ParseTablePrinter::beginStep
+//*******************************************************
+void ParseTablePrinter::beginStep(const Token &theLookAheadToken)
+{
+  myStepAction.clear();
+
+  if (myPrintParse)
+  {
+    std::ostringstream remainingTokens;
+    printTokens(remainingTokens, theLookAheadToken);
+    myStepTokens = remainingTokens.str();
+
+    std::ostringstream stackContents;
+    printStack(stackContents);
+    myStepStack = stackContents.str();
+  }
+}
+
+//*******************************************************
+// ParseTablePrinter::endOfProduction
+//*******************************************************
+void ParseTablePrinter::endOfProduction(const SemanticStack::Frame &theFrame)
+{
+  myStack.endOfProduction();
+}
+
+//*******************************************************
+// ParseTablePrinter::endStep
+//*******************************************************
+void ParseTablePrinter::endStep(const Token &theLookAheadToken)
+{
+  if (myPrintParse && ! myEWTracker.hasError())
+  {
+    myOS << std::setw(ACTION_WIDTH) << myStepAction << " | "
+         << std::setw(myTokensWidth) << myStepTokens << " | "
+         << std::setw(STACK_WIDTH) << myStepStack
+         << std::endl;
+  }
+
+  printState(theLookAheadToken);
+}
+
+//*******************************************************
+// ParseTablePrinter::finish
+//*******************************************************
+void ParseTablePrinter::finish()
+{
+}
+
+//*******************************************************
+// ParseTablePrinter::getNextToken
+//*******************************************************
+std::size_t ParseTablePrinter::getNextToken() const noexcept
+{
+  // Once at the end of file the scanner keeps returning the end of file
+  // token, so there is always one left.
+  return std::min(myNumberMatched + 1, myTokens.size() - 1);
+}
+
+//*******************************************************
+// ParseTablePrinter::getStackSymbols
+//*******************************************************
+std::vector<std::shared_ptr<Symbol>> ParseTablePrinter::getStackSymbols()
+  const
+{
+  const auto &symbols = myGrammar.getSymbolRegistry();
+
+  std::vector<std::shared_ptr<Symbol>> stackSymbols;
+  const auto &entries = myStack.getEntries();
+  auto eopFrame = myStack.getEOPFrames().rbegin();
+  for (auto entry = entries.rbegin(); entry != entries.rend(); ++entry)
+  {
+    if (ParseStackEntry::Kind::EOP == entry->getKind())
+    {
+      stackSymbols.push_back(std::make_shared<EOPSymbol>(
+                               eopFrame->myCurrentIndex,
+                               eopFrame->myLeftIndex,
+                               eopFrame->myRightIndex,
+                               eopFrame->myTopIndex));
+      ++eopFrame;
+    }
+    else
+    {
+      stackSymbols.push_back(symbols.getSymbol(entry->getIndex()));
+    }
+  }
+  return stackSymbols;
+}
+
+//*******************************************************
+// ParseTablePrinter::match
+//*******************************************************
+void ParseTablePrinter::match(const Token &theToken)
+{
+  myStepAction = "Match";
+  myStack.pop();
+  ++myNumberMatched;
+}
+
+//*******************************************************
+// ParseTablePrinter::predict
+//*******************************************************
+void ParseTablePrinter::predict(uint32_t theProductionNumber,
+                                const SemanticStack::Frame &theFrame,
+                                bool theEOPElided)
+{
+  myStepAction = "Predict(" + std::to_string(theProductionNumber) + ")";
+
+  // The stack elides the EOP when the parser did.
+  myStack.predict(theProductionNumber, myPredictTable, theFrame);
+}
+
+//*******************************************************
+// ParseTablePrinter::printStack
+//*******************************************************
+void ParseTablePrinter::printStack(std::ostream &theOS) const
+{
+  auto stackSymbols = getStackSymbols();
+  for (auto ii = 0u; ii < stackSymbols.size(); ++ii)
+  {
+    theOS << *stackSymbols[ii];
+    if (ii < stackSymbols.size() - 1)
+    {
+      theOS << " ";
+    }
+  }
+}
+
+//*******************************************************
+// ParseTablePrinter::printState
+//*******************************************************
+void ParseTablePrinter::printState(const Token &theLookAheadToken)
+{
+  if (myPrintGeneration)
+  {
+    std::vector<Token> remainingTokens{theLookAheadToken};
+    remainingTokens.insert(remainingTokens.end(),
+                           myTokens.begin() + getNextToken(), myTokens.end());
+    const auto &semanticStack(mySemanticStack.getStack());
+    const auto &generatedCode(mySemanticRoutines.getCode());
+    auto allSymbols(mySemanticRoutines.getSymbols());
+    auto parseStack(getStackSymbols());
+
+    auto tokenIter = remainingTokens.begin();
+    auto semanticIter = semanticStack.begin();
+    semanticIter++; // Bottom element is a placeholder (skip it)
+    auto generatedIter = generatedCode.begin();
+    auto parseIter = parseStack.begin();
+    auto symbolIter = allSymbols.begin();
+
+    auto remainingTokensCheck = [&]()->bool
+    {
+      return tokenIter != remainingTokens.end();
+    };
+    auto remainingSemanticCheck = [&]()->bool
+    {
+      return semanticIter != semanticStack.end();
+    };
+    auto remainingGeneratedCheck = [&]()->bool
+    {
+      return generatedIter != generatedCode.end();
+    };
+    auto remainingParseCheck = [&]()->bool
+    {
+      return parseIter != parseStack.end();
+    };
+    auto remainingSymbolsCheck = [&]()->bool
+    {
+      return symbolIter != allSymbols.end();
+    };
+    auto remainingData = [&]()->bool
+    {
+      bool remainingData = (remainingTokensCheck() ||
+                            remainingSemanticCheck() ||
+                            remainingParseCheck() ||
+                            remainingGeneratedCheck() ||
+                            remainingSymbolsCheck());
+      return remainingData;
+    };
+
+    // Sized to fit GenInfix action symbol
+    static const uint32_t WIDTH = 22;
+
+    std::vector<std::string> columnNames =
+      {
+        "Remaining Tokens",
+        "Parse Stack",
+        "Semantic Stack",
+        "Symbol Table",
+        "Generated Code"
+      };
+
+    auto printDivider = [&]()
+    {
+      for (uint32_t ii = 0; ii < columnNames.size(); ++ii)
+      {
+        myOS << std::setw(WIDTH+3) << std::setfill('-') << "";
+      }
+      myOS << std::endl << std::setfill(' ');
+    };
+
+    if (! myPrintedHeader)
+    {
+      myPrintedHeader = true;
+      for (uint32_t ii = 0; ii < columnNames.size(); ++ii)
+      {
+        myOS << std::setw(WIDTH) << columnNames[ii];
+        if (ii < columnNames.size()-1)
+        {
+          myOS << " | ";
+        }
+      }
+      myOS << std::endl;
+      printDivider();
+    }
+
+    // Remaining Input, Parse stack, semantic stack, code
+    while (remainingData())
+    {
+      if (remainingTokensCheck())
+      {
+        uint32_t usedWidth = 0;
+        while (remainingTokensCheck() &&
+               usedWidth + (tokenIter->getLength() + 1) < WIDTH)
+        {
+          myOS << tokenIter->getToken() << " ";
+          usedWidth += tokenIter->getLength() + 1;
+          ++tokenIter;
+        }
+        while (usedWidth < WIDTH)
+        {
+          myOS << " ";
+          ++usedWidth;
+        }
+      }
+      else
+      {
+        myOS << std::setw(WIDTH) << " ";
+      }
+      myOS << " | ";
+
+      if (remainingParseCheck())
+      {
+        myOS << std::setw(WIDTH) << **parseIter;
+        ++parseIter;
+      }
+      else
+      {
+        myOS << std::setw(WIDTH) << " ";
+      }
+      myOS << " | ";
+
+      if (remainingSemanticCheck())
+      {
+        myOS << std::setw(WIDTH) << semanticIter->extract();
+        ++semanticIter;
+      }
+      else
+      {
+        myOS << std::setw(WIDTH) << " ";
+      }
+      myOS << " | ";
+
+      if (remainingSymbolsCheck())
+      {
+        myOS << std::setw(WIDTH) << std::left << *symbolIter
+                  << std::right;
+        ++symbolIter;
+      }
+      else
+      {
+        myOS << std::setw(WIDTH) << " ";
+      }
+      myOS << " | ";
+
+      if (remainingGeneratedCheck())
+      {
+        myOS << std::setw(WIDTH) << std::left << *generatedIter
+                  << std::right;
+        ++generatedIter;
+      }
+      else
+      {
+        myOS << std::setw(WIDTH) << " ";
+      }
+
+      myOS << std::endl;
+    }
+
+    printDivider();
+  }
+}
+
+//*******************************************************
+// ParseTablePrinter::printTokens
+//*******************************************************
+void ParseTablePrinter::printTokens(std::ostream &theOS,
+                                    const Token &theLookAheadToken) const
+{
+  // If prevents last parser step print from printing "$ $" as remaining
+  // symbols.
+  if (theLookAheadToken.getToken() != "$")
+  {
+    theOS << theLookAheadToken.getToken();
+  }
+
+  for (auto token = myTokens.begin() + getNextToken();
+       token != myTokens.end(); ++token)
+  {
+    theOS << " " << token->getToken();
+  }
+}
+
+//*******************************************************
+// ParseTablePrinter::skip
+//*******************************************************
+void ParseTablePrinter::skip(Symbol::Index theSymbol)
+{
+  myStack.pop();
+}
+
+//*******************************************************
+// ParseTablePrinter::start
+//*******************************************************
+void ParseTablePrinter::start()
+{
+  myNumberMatched = 0;
+  myStack.start(myGrammar.getStartSymbol()->getIndex());
+
+  if (myPrintParse)
+  {
+    // Make the second column the correct maximum size, always.
+    myTokensWidth = 0;
+    for (const auto &token : myTokens)
+    {
+      myTokensWidth += 1 + token.getLength();
+    }
+
+    myOS << std::left
+         << std::setw(ACTION_WIDTH) << "Parser Action" << " | "
+         << std::setw(myTokensWidth) << "Remaining Tokens" << " | "
+         << std::setw(STACK_WIDTH) << "Stack" << std::endl
+         << std::right;
+  }
+}
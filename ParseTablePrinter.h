@@ -0,0 +1,258 @@
+#ifndef PARSETABLEPRINTER_H
+#define PARSETABLEPRINTER_H
+
+/**
+ * @file ParseTablePrinter.h
+ * @brief Defines the tracer printing the full state of each parse step.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "ParseStack.h"
+#include "ParseTracer.h"
+#include "Token.h"
+
+class ErrorWarningTracker;
+class Grammar;
+class PredictTable;
+class SemanticRoutines;
+
+/**
+ * Prints the parse as tables: for the parse, a row per step with the
+ * remaining tokens and the parse stack; for code generation, after each
+ * step, the remaining tokens, parse stack, semantic stack, symbol table and
+ * all code generated so far.
+ *
+ * The parse stack is rebuilt from the events. Every row prints the whole
+ * state of the parse, so this is only usable on small inputs (see
+ * ParseStepPrinter).
+ */
+class ParseTablePrinter : public ParseTracer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  ParseTablePrinter() = delete;
+
+  /**
+   * Copy constructor
+   */
+  ParseTablePrinter(const ParseTablePrinter&) = delete;
+
+  /**
+   * Move constructor
+   */
+  ParseTablePrinter(ParseTablePrinter&&) = delete;
+
+  /**
+   * Constructor
+   *
+   * @param theOS
+   *          stream to print to
+   * @param theTokens
+   *          all tokens of the source, through the end of file token
+   * @param theGrammar
+   *          language grammar
+   * @param thePredictTable
+   *          LL(1) predict table
+   * @param theSemanticStack
+   *          semantic stack of the parse
+   * @param theSemanticRoutines
+   *          semantic routines of the parse
+   * @param theEWTracker
+   *          error/warning tracker, parse rows stop at the first error
+   * @param thePrintParse
+   *          print parse steps
+   * @param thePrintGeneration
+   *          print code generation steps
+   */
+  ParseTablePrinter(std::ostream &theOS,
+                    std::vector<Token> theTokens,
+                    const Grammar &theGrammar,
+                    const PredictTable &thePredictTable,
+                    const SemanticStack &theSemanticStack,
+                    const SemanticRoutines &theSemanticRoutines,
+                    const ErrorWarningTracker &theEWTracker,
+                    bool thePrintParse,
+                    bool thePrintGeneration);
+
+  /**
+   * Destructor
+   */
+  virtual ~ParseTablePrinter() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  ParseTablePrinter& operator=(const ParseTablePrinter&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  ParseTablePrinter& operator=(ParseTablePrinter&&) = delete;
+
+  /**
+   * Pops the action from the parse stack.
+   */
+  virtual void action(const ActionSymbol &theAction) override;
+
+  /**
+   * Prints the initial code generation state.
+   */
+  virtual void begin(const Token &theLookAheadToken) override;
+
+  /**
+   * Saves the remaining tokens and parse stack for the step's row.
+   */
+  virtual void beginStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Pops the EOP from the parse stack.
+   */
+  virtual void endOfProduction(const SemanticStack::Frame &theFrame)
+    override;
+
+  /**
+   * Prints the step's row and the code generation state.
+   */
+  virtual void endStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Does nothing, rows are printed as they end.
+   */
+  virtual void finish() override;
+
+  /**
+   * Pops the terminal from the parse stack.
+   */
+  virtual void match(const Token &theToken) override;
+
+  /**
+   * Replaces the non-terminal on the parse stack by the production.
+   */
+  virtual void predict(uint32_t theProductionNumber,
+                       const SemanticStack::Frame &theFrame,
+                       bool theEOPElided) override;
+
+  /**
+   * Pops the symbol from the parse stack.
+   */
+  virtual void skip(Symbol::Index theSymbol) override;
+
+  /**
+   * Prints the parse table header.
+   */
+  virtual void start() override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Returns the position in myTokens of the first token after the
+   * look-ahead token.
+   *
+   * @return position of the next token
+   */
+  std::size_t getNextToken() const noexcept;
+
+  /**
+   * Returns the symbols on the parse stack, top first, for printing.
+   *
+   * @return parse stack symbols
+   */
+  std::vector<std::shared_ptr<Symbol>> getStackSymbols() const;
+
+  /**
+   * Add the stack contents to the given stream.
+   *
+   * @param theOS
+   *          stream to add stack data to
+   */
+  void printStack(std::ostream &theOS) const;
+
+  /**
+   * Prints the state of code generation.
+   *
+   * @param theLookAheadToken
+   *          look-ahead token
+   */
+  void printState(const Token &theLookAheadToken);
+
+  /**
+   * Prints all tokens remaining after the look-ahead token.
+   *
+   * @param theOS
+   *          stream to print tokens to
+   * @param theLookAheadToken
+   *          Look-ahead token
+   */
+  void printTokens(std::ostream &theOS, const Token &theLookAheadToken) const;
+
+  /** Error/Warning tracker */
+  const ErrorWarningTracker &myEWTracker;
+
+  /** Language grammar */
+  const Grammar &myGrammar;
+
+  /** Number of tokens matched. */
+  std::size_t myNumberMatched = 0;
+
+  /** Stream to print to. */
+  std::ostream &myOS;
+
+  /** Production predict table */
+  const PredictTable &myPredictTable;
+
+  /** If the code generation header has been printed. */
+  bool myPrintedHeader = false;
+
+  /** Print code generation steps */
+  const bool myPrintGeneration;
+
+  /** Print parse steps */
+  const bool myPrintParse;
+
+  /** Semantic routines */
+  const SemanticRoutines &mySemanticRoutines;
+
+  /** Semantic stack */
+  const SemanticStack &mySemanticStack;
+
+  /** Parse stack, as the parser's. */
+  ParseStack myStack;
+
+  /** Parser action of the current step. */
+  std::string myStepAction;
+
+  /** Parse stack at the start of the current step. */
+  std::string myStepStack;
+
+  /** Remaining tokens at the start of the current step. */
+  std::string myStepTokens;
+
+  /** All tokens of the source. */
+  const std::vector<Token> myTokens;
+
+  /** Width of the remaining tokens column. */
+  std::size_t myTokensWidth = 0;
+};
+
+#endif
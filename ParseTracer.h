@@ -0,0 +1,128 @@
+#ifndef PARSETRACER_H
+#define PARSETRACER_H
+
+/**
+ * @file ParseTracer.h
+ * @brief Defines the interface for receiving the steps of a parse.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+
+#include "SemanticStack.h"
+#include "Symbol.h"
+
+class ActionSymbol;
+class Token;
+
+/**
+ * Event sink for the steps of a Parser, used to trace the parse (see
+ * ParseStepPrinter and ParseTablePrinter). Each step of the parse is one
+ * event (predict, match, action, endOfProduction or skip), between a
+ * beginStep and an endStep.
+ *
+ * The events only describe what changed, so a tracer which handles them
+ * in constant time keeps tracing linear in the length of the parse.
+ *
+ * Events can also come without a beginStep and endStep, for steps which
+ * are not to be printed (see TraceRenderer): the tracer only keeps track
+ * of them.
+ */
+class ParseTracer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Destructor
+   */
+  virtual ~ParseTracer() = default;
+
+  /**
+   * Called after an action symbol's semantic routine has been run.
+   *
+   * @param theAction
+   *          action symbol
+   */
+  virtual void action(const ActionSymbol &theAction) = 0;
+
+  /**
+   * Called once the first token has been scanned, before the first step.
+   *
+   * @param theLookAheadToken
+   *          first look-ahead token
+   */
+  virtual void begin(const Token &theLookAheadToken) = 0;
+
+  /**
+   * Called before each step.
+   *
+   * @param theLookAheadToken
+   *          look-ahead token
+   */
+  virtual void beginStep(const Token &theLookAheadToken) = 0;
+
+  /**
+   * Called when an EOP has restored the semantic stack.
+   *
+   * @param theFrame
+   *          frame restored
+   */
+  virtual void endOfProduction(const SemanticStack::Frame &theFrame) = 0;
+
+  /**
+   * Called after each step.
+   *
+   * @param theLookAheadToken
+   *          look-ahead token
+   */
+  virtual void endStep(const Token &theLookAheadToken) = 0;
+
+  /**
+   * Called once the parse is done.
+   */
+  virtual void finish() = 0;
+
+  /**
+   * Called when a terminal has been matched.
+   *
+   * @param theToken
+   *          matched token
+   */
+  virtual void match(const Token &theToken) = 0;
+
+  /**
+   * Called when a production has been predicted.
+   *
+   * @param theProductionNumber
+   *          predicted production
+   * @param theFrame
+   *          frame of the production's EOP, that is the state of the
+   *          semantic stack before the production was expanded
+   * @param theEOPElided
+   *          if the production was predicted in tail position, and so no
+   *          EOP was pushed for it
+   */
+  virtual void predict(uint32_t theProductionNumber,
+                       const SemanticStack::Frame &theFrame,
+                       bool theEOPElided) = 0;
+
+  /**
+   * Called when a symbol has been popped without matching it, after a
+   * syntax error.
+   *
+   * @param theSymbol
+   *          symbol skipped
+   */
+  virtual void skip(Symbol::Index theSymbol) = 0;
+
+  /**
+   * Called before the first token is scanned.
+   */
+  virtual void start() = 0;
+};
+
+#endif
@@ -8,17 +8,14 @@
  * @author Michael Albers
  */
 
-#include <memory>
-#include <stack>
+#include "ParseStack.h"
 
 class Grammar;
 class ErrorWarningTracker;
+class ParseTracer;
 class PredictTable;
 class Scanner;
 class SemanticRoutines;
-class SemanticStack;
-class Symbol;
-class Token;
 
 /**
  * Class which defines a universal LL(1) parser.
@@ -60,10 +57,8 @@ class Parser
    *          routines used for handling semantic data and code generation
    * @param theEWTracker
    *          error/warning tracker
-   * @param thePrintParse
-   *          print parse steps
-   * @param thePrintGeneration
-   *          print code generation steps
+   * @param theTracer
+   *          receives each step of the parse, nullptr not to trace it
    */
   Parser(Scanner &theScanner,
          const Grammar &theGrammar,
@@ -71,8 +66,7 @@ class Parser
          SemanticStack &theSemanticStack,
          SemanticRoutines &theSemanticRoutines,
          ErrorWarningTracker &theEWTracker,
-         bool thePrintParse,
-         bool thePrintGeneration);
+         ParseTracer *theTracer);
 
   /**
    * Destructor
@@ -104,35 +98,6 @@ class Parser
    */
   void parse();
 
-  /**
-   * Add the stack contents to the given stream.
-   *
-   * @param theOS
-   *          stream to add stack data to
-   * @param theStack
-   *          stack to print
-   */
-  static void printStack(std::ostream &theOS,
-                         std::stack<std::shared_ptr<Symbol>> theStack);
-
-  /**
-   * Prints the state of parse/code generation.
-   *
-   * @param theLookAheadToken
-   *          look-ahead token
-   */
-  void printState(const Token &theLookAheadToken) noexcept;
-
-  /**
-   * Prints all tokens remaining in the scanner.
-   *
-   * @param theOS
-   *          stream to print tokens to
-   * @param theLookAheadToken
-   *          Look-ahead token
-   */
-  void printTokens(std::ostream &theOS, const Token &theLookAheadToken);
-
   /** Error/Warning tracker */
   ErrorWarningTracker &myEWTracker;
 
@@ -142,12 +107,6 @@ class Parser
   /** Production predict table */
   const PredictTable &myPredictTable;
 
-  /** Print code generation steps */
-  const bool myPrintGeneration;
-
-  /** Print parse steps */
-  const bool myPrintParse;
-
   /** Token scanner */
   Scanner &myScanner;
 
@@ -157,8 +116,11 @@ class Parser
   /** Semantic stack */
   SemanticStack &mySemanticStack;
 
-  /** Stack of expected symbols during parsing */
-  std::stack<std::shared_ptr<Symbol>> myStack;
+  /** Stack of expected symbols during parsing. */
+  ParseStack myStack;
+
+  /** Receives each step of the parse, if any. */
+  ParseTracer *myTracer;
 };
 
 #endif
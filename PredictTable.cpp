@@ -5,19 +5,302 @@
  * @author Michael Albers
  */
 
+#include <algorithm>
 #include <iomanip>
+#include <stdexcept>
+#include <string>
 
 #include "Grammar.h"
 #include "PredictTable.h"
 #include "Production.h"
 
+constexpr uint16_t PredictTable::NO_PRODUCTION;
+constexpr uint32_t PredictTable::COMB_PRODUCTION_MASK;
+constexpr uint32_t PredictTable::COMB_ROW_SHIFT;
+
 //*******************************************************
 // PredictTable::PredictTable
 //*******************************************************
 PredictTable::PredictTable(const Grammar &theGrammar) :
   myGrammar(theGrammar)
 {
+  fillPushes();
   populateTable();
+  useOwnTables();
+
+  // The comb vector is slower to look up, so only worth it when it saves a
+  // good part of the table.
+  auto denseSize = getSize();
+  try
+  {
+    compress();
+  }
+  catch (const std::runtime_error&)
+  {
+    return;
+  }
+  myTables.myRepresentation = Representation::Compressed;
+  useOwnTables();
+  auto compressedSize = getSize();
+  setRepresentation(compressedSize * 2 <= denseSize ?
+                    Representation::Compressed : Representation::Dense);
+}
+
+//*******************************************************
+// PredictTable::PredictTable
+//*******************************************************
+PredictTable::PredictTable(const Grammar &theGrammar,
+                           Representation theRepresentation) :
+  myGrammar(theGrammar)
+{
+  fillPushes();
+  populateTable();
+  if (Representation::Compressed == theRepresentation)
+  {
+    compress();
+  }
+  setRepresentation(theRepresentation);
+}
+
+//*******************************************************
+// PredictTable::PredictTable
+//*******************************************************
+PredictTable::PredictTable(const Grammar &theGrammar,
+                           GrammarCache::Reader &theReader) :
+  myGrammar(theGrammar)
+{
+  fillPushes();
+
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  myNonTerminalBegin = symbols.getBegin(SymbolRegistry::Kind::NonTerminal);
+  myNumberTerminals = symbols.getEnd(SymbolRegistry::Kind::Terminal);
+
+  myTables.myLargestColumnNameSize = theReader.read<uint32_t>();
+  myTables.myLargestNonTerminalNameSize = theReader.read<uint32_t>();
+  theReader.read(myNonTerminals);
+  theReader.read(myTerminals);
+  myTables.myRepresentation =
+    static_cast<Representation>(theReader.read<uint8_t>());
+  theReader.read(myTable);
+  theReader.read(myComb);
+  theReader.read(myRowBases);
+  theReader.read(myRowDefaults);
+
+  if (myRowBases.size() != myRowDefaults.size())
+  {
+    throw std::runtime_error{"Grammar cache is corrupt."};
+  }
+  useOwnTables();
+  validate();
+}
+
+//*******************************************************
+// PredictTable::PredictTable
+//*******************************************************
+PredictTable::PredictTable(const Grammar &theGrammar,
+                           const Tables &theTables) :
+  myGrammar(theGrammar),
+  myTables(theTables)
+{
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  myNonTerminalBegin = symbols.getBegin(SymbolRegistry::Kind::NonTerminal);
+  myNumberTerminals = symbols.getEnd(SymbolRegistry::Kind::Terminal);
+  validate();
+}
+
+//*******************************************************
+// PredictTable::compress
+//*******************************************************
+void PredictTable::compress()
+{
+  uint32_t numberRows = myNumberTerminals > 0 ?
+    myTable.size() / myNumberTerminals : 0;
+  if (numberRows >= UINT16_MAX)
+  {
+    throw std::runtime_error{"Too many non-terminals to compress the "
+        "predict table, at most " + std::to_string(UINT16_MAX - 1) +
+        " are supported."};
+  }
+
+  // Each row's default is its most common entry, usually NO_PRODUCTION.
+  // The other entries, including any NO_PRODUCTION ones, go in the comb.
+  myRowDefaults.assign(numberRows, NO_PRODUCTION);
+  std::vector<std::vector<Symbol::Index>> rowColumns(numberRows);
+  std::vector<uint16_t> sorted;
+  for (uint32_t row = 0; row < numberRows; ++row)
+  {
+    auto begin = myTable.begin() + row * myNumberTerminals;
+    auto end = begin + myNumberTerminals;
+    sorted.assign(begin, end);
+    std::sort(sorted.begin(), sorted.end());
+    std::size_t longestRun = 0;
+    for (auto run = sorted.begin(); run != sorted.end();)
+    {
+      auto runEnd = std::upper_bound(run, sorted.end(), *run);
+      if (static_cast<std::size_t>(runEnd - run) > longestRun)
+      {
+        longestRun = runEnd - run;
+        myRowDefaults[row] = *run;
+      }
+      run = runEnd;
+    }
+    for (auto entry = begin; entry != end; ++entry)
+    {
+      if (*entry != myRowDefaults[row])
+      {
+        rowColumns[row].push_back(entry - begin);
+      }
+    }
+  }
+
+  // First fit, fullest rows first as they are the hardest to place.
+  std::vector<uint32_t> rows(numberRows);
+  for (uint32_t row = 0; row < numberRows; ++row)
+  {
+    rows[row] = row;
+  }
+  std::stable_sort(rows.begin(), rows.end(),
+                   [&](uint32_t theLeft, uint32_t theRight)
+                   {
+                     return rowColumns[theLeft].size() >
+                       rowColumns[theRight].size();
+                   });
+
+  // Free slots of the comb are found by following nextFree, which is the
+  // slot itself if free, otherwise a slot after it. Slots past its end are
+  // free.
+  std::vector<uint32_t> nextFree;
+  auto findFree = [&](uint32_t theSlot)
+  {
+    auto slot = theSlot;
+    while (slot < nextFree.size() && nextFree[slot] != slot)
+    {
+      slot = nextFree[slot];
+    }
+    while (theSlot < nextFree.size() && nextFree[theSlot] != slot)
+    {
+      auto next = nextFree[theSlot];
+      nextFree[theSlot] = slot;
+      theSlot = next;
+    }
+    return slot;
+  };
+
+  myComb.clear();
+  myRowBases.assign(numberRows, 0);
+  std::size_t previousSize = 0;
+  uint32_t previousBase = 0;
+  for (auto row : rows)
+  {
+    const auto &columns = rowColumns[row];
+    if (columns.empty())
+    {
+      continue;
+    }
+
+    // Only the bases putting the first column on a free slot can fit.
+    // Rows with as many entries as the last one rarely fit in the holes it
+    // didn't, so they are only tried after its base. Without that, each
+    // row would retry every hole left before it.
+    if (columns.size() != previousSize)
+    {
+      previousSize = columns.size();
+      previousBase = 0;
+    }
+    auto slot = findFree(previousBase + columns.front());
+    uint32_t base = slot - columns.front();
+    auto fits = [&]()
+    {
+      for (auto column : columns)
+      {
+        if (base + column < myComb.size() && 0 != myComb[base + column])
+        {
+          return false;
+        }
+      }
+      return true;
+    };
+    while (! fits())
+    {
+      slot = findFree(slot + 1);
+      base = slot - columns.front();
+    }
+
+    myRowBases[row] = base;
+    previousBase = base;
+    if (myComb.size() < base + columns.back() + 1)
+    {
+      myComb.resize(base + columns.back() + 1, 0);
+      while (nextFree.size() < myComb.size())
+      {
+        nextFree.push_back(nextFree.size());
+      }
+    }
+    for (auto column : columns)
+    {
+      myComb[base + column] = ((row + 1) << COMB_ROW_SHIFT) |
+        myTable[row * myNumberTerminals + column];
+      nextFree[base + column] = base + column + 1;
+    }
+  }
+
+  // Lookups of any row and terminal stay within the comb.
+  auto largestBase = numberRows > 0 ?
+    *std::max_element(myRowBases.begin(), myRowBases.end()) : 0;
+  myComb.resize(std::max<std::size_t>(myComb.size(),
+                                      largestBase + myNumberTerminals), 0);
+}
+
+//*******************************************************
+// PredictTable::fillPushes
+//*******************************************************
+void PredictTable::fillPushes()
+{
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  auto productions = myGrammar.getProductions();
+
+  myPushOffsets.push_back(0);
+  for (auto production : productions)
+  {
+    auto rhs = production->getRHS();
+    uint32_t numberGrammarSymbols = 0;
+    for (auto rhsIter = rhs.rbegin(); rhsIter != rhs.rend(); ++rhsIter)
+    {
+      auto index = symbols.getIndex(**rhsIter);
+      switch (symbols.getKind(index))
+      {
+        case SymbolRegistry::Kind::Terminal:
+          ++numberGrammarSymbols;
+          myPushes.emplace_back(ParseStackEntry::Kind::Terminal, index);
+          break;
+
+        case SymbolRegistry::Kind::Lambda:
+          ++numberGrammarSymbols;
+          break;
+
+        case SymbolRegistry::Kind::NonTerminal:
+          ++numberGrammarSymbols;
+          myPushes.emplace_back(ParseStackEntry::Kind::NonTerminal, index);
+          break;
+
+        case SymbolRegistry::Kind::Action:
+          myPushes.emplace_back(ParseStackEntry::Kind::Action, index);
+          break;
+      }
+    }
+    myNumberGrammarSymbols.push_back(numberGrammarSymbols);
+    myPushOffsets.push_back(myPushes.size());
+  }
+}
+
+//*******************************************************
+// PredictTable::getEntry
+//*******************************************************
+uint32_t PredictTable::getEntry(Symbol::Index theNonTerminal,
+                                Symbol::Index theTerminal) const noexcept
+{
+  return (theNonTerminal - myNonTerminalBegin) * myNumberTerminals +
+    theTerminal;
 }
 
 //*******************************************************
@@ -25,46 +308,339 @@ PredictTable::PredictTable(const Grammar &theGrammar) :
 //*******************************************************
 void PredictTable::populateTable()
 {
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  myNonTerminalBegin = symbols.getBegin(SymbolRegistry::Kind::NonTerminal);
+  myNumberTerminals = symbols.getEnd(SymbolRegistry::Kind::Terminal);
+  auto numberNonTerminals =
+    symbols.getEnd(SymbolRegistry::Kind::NonTerminal) - myNonTerminalBegin;
+  myTable.assign(numberNonTerminals * myNumberTerminals, NO_PRODUCTION);
+
   auto productions = myGrammar.getProductions();
+  if (productions.size() > UINT16_MAX)
+  {
+    throw std::runtime_error{"Too many productions, at most " +
+        std::to_string(UINT16_MAX) + " are supported."};
+  }
+
+  std::vector<bool> hasRow(numberNonTerminals, false);
+  std::vector<bool> isColumn(myNumberTerminals, false);
   for (auto production : productions)
   {
     auto lhsSymbol = production->getLHS();
 
     auto nonTerminalNameSize = lhsSymbol->getName().size();
-    if (nonTerminalNameSize > myLargestNonTerminalNameSize)
+    if (nonTerminalNameSize > myTables.myLargestNonTerminalNameSize)
     {
-      myLargestNonTerminalNameSize = nonTerminalNameSize;
+      myTables.myLargestNonTerminalNameSize = nonTerminalNameSize;
     }
 
-    auto predictSet = production->getPredictSet();
-    for (auto predictSymbol : predictSet)
+    const auto &predictSet = production->getPredictSet();
+    for (auto terminal = predictSet.next(0); terminal < predictSet.getSize();
+         terminal = predictSet.next(terminal + 1))
     {
-      auto columnNameSize = predictSymbol->getName().size();
-      if (columnNameSize > myLargestColumnNameSize)
+      auto columnNameSize = symbols.getName(terminal).size();
+      if (columnNameSize > myTables.myLargestColumnNameSize)
       {
-        myLargestColumnNameSize = columnNameSize;
+        myTables.myLargestColumnNameSize = columnNameSize;
       }
 
-      myTable[lhsSymbol][predictSymbol] = production->getNumber();
-      myTerminals.insert(predictSymbol);
+      myTable[getEntry(lhsSymbol->getIndex(), terminal)] =
+        production->getNumber();
+      hasRow[lhsSymbol->getIndex() - myNonTerminalBegin] = true;
+      isColumn[terminal] = true;
+    }
+  }
+
+  Symbol::SymbolSet terminals;
+  for (Symbol::Index terminal = 0; terminal < myNumberTerminals; ++terminal)
+  {
+    if (isColumn[terminal])
+    {
+      terminals.insert(terminals.end(), symbols.getSymbol(terminal));
+    }
+  }
+  for (auto terminal : Symbol::sortByName(terminals))
+  {
+    myTerminals.push_back(terminal->getIndex());
+  }
+
+  // Rows are printed in the order the non-terminals first appear in the
+  // productions, rather than in myTable's (index) order.
+  auto addRow = [&](const std::shared_ptr<Symbol> &theSymbol)
+  {
+    auto index = symbols.getIndex(*theSymbol);
+    if (symbols.getKind(index) == SymbolRegistry::Kind::NonTerminal &&
+        hasRow[index - myNonTerminalBegin])
+    {
+      hasRow[index - myNonTerminalBegin] = false;
+      myNonTerminals.push_back(index);
+    }
+  };
+  for (auto production : productions)
+  {
+    addRow(production->getLHS());
+    for (const auto &symbol : production->getRHS())
+    {
+      addRow(symbol);
     }
   }
 }
 
+//*******************************************************
+// PredictTable::getNumberGrammarSymbols
+//*******************************************************
+uint32_t PredictTable::getNumberGrammarSymbols(uint32_t theProductionNumber)
+  const noexcept
+{
+  return myTables.myNumberGrammarSymbols[theProductionNumber - 1];
+}
+
 //*******************************************************
 // PredictTable::getProductionNumber
 //*******************************************************
 uint32_t PredictTable::getProductionNumber(
-  std::shared_ptr<Symbol> theNonTerminal,
-  std::shared_ptr<Symbol> theTerminal) const noexcept
+  Symbol::Index theNonTerminal,
+  Symbol::Index theTerminal) const noexcept
 {
-  uint32_t productionNumber = 0;
-  try
+  // The token of a lexical error has no terminal.
+  if (theTerminal >= myNumberTerminals)
+  {
+    return NO_PRODUCTION;
+  }
+  const auto &tables = myTables;
+  if (Representation::Dense == tables.myRepresentation)
+  {
+    return tables.myTable[getEntry(theNonTerminal, theTerminal)];
+  }
+
+  uint32_t row = theNonTerminal - myNonTerminalBegin;
+  auto entry = tables.myComb[tables.myRowBases[row] + theTerminal];
+  if ((entry >> COMB_ROW_SHIFT) == row + 1)
+  {
+    return entry & COMB_PRODUCTION_MASK;
+  }
+  return tables.myRowDefaults[row];
+}
+
+//*******************************************************
+// PredictTable::getPushBegin
+//*******************************************************
+const ParseStackEntry* PredictTable::getPushBegin(
+  uint32_t theProductionNumber) const noexcept
+{
+  return myTables.myPushes + myTables.myPushOffsets[theProductionNumber - 1];
+}
+
+//*******************************************************
+// PredictTable::getPushEnd
+//*******************************************************
+const ParseStackEntry* PredictTable::getPushEnd(
+  uint32_t theProductionNumber) const noexcept
+{
+  return myTables.myPushes + myTables.myPushOffsets[theProductionNumber];
+}
+
+//*******************************************************
+// PredictTable::getRepresentation
+//*******************************************************
+PredictTable::Representation PredictTable::getRepresentation() const noexcept
+{
+  return myTables.myRepresentation;
+}
+
+//*******************************************************
+// PredictTable::getSize
+//*******************************************************
+std::size_t PredictTable::getSize() const noexcept
+{
+  const auto &tables = myTables;
+  if (Representation::Dense == tables.myRepresentation)
+  {
+    return tables.myTableSize * sizeof(tables.myTable[0]);
+  }
+  return tables.myCombSize * sizeof(tables.myComb[0]) +
+    tables.myRowsSize * (sizeof(tables.myRowBases[0]) +
+                         sizeof(tables.myRowDefaults[0]));
+}
+
+//*******************************************************
+// PredictTable::getTables
+//*******************************************************
+const PredictTable::Tables& PredictTable::getTables() const noexcept
+{
+  return myTables;
+}
+
+//*******************************************************
+// PredictTable::save
+//*******************************************************
+void PredictTable::save(GrammarCache::Writer &theWriter) const
+{
+  const auto &tables = myTables;
+  theWriter.write(tables.myLargestColumnNameSize);
+  theWriter.write(tables.myLargestNonTerminalNameSize);
+  theWriter.write(tables.myNonTerminals, tables.myNonTerminalsSize);
+  theWriter.write(tables.myTerminals, tables.myTerminalsSize);
+  theWriter.write(static_cast<uint8_t>(tables.myRepresentation));
+  theWriter.write(tables.myTable, tables.myTableSize);
+  theWriter.write(tables.myComb, tables.myCombSize);
+  theWriter.write(tables.myRowBases, tables.myRowsSize);
+  theWriter.write(tables.myRowDefaults, tables.myRowsSize);
+}
+
+//*******************************************************
+// PredictTable::setRepresentation
+//*******************************************************
+void PredictTable::setRepresentation(Representation theRepresentation)
+{
+  myTables.myRepresentation = theRepresentation;
+  if (Representation::Dense == myTables.myRepresentation)
+  {
+    std::vector<uint32_t>().swap(myComb);
+    std::vector<uint32_t>().swap(myRowBases);
+    std::vector<uint16_t>().swap(myRowDefaults);
+  }
+  else
+  {
+    std::vector<uint16_t>().swap(myTable);
+  }
+  useOwnTables();
+}
+
+//*******************************************************
+// PredictTable::useOwnTables
+//*******************************************************
+void PredictTable::useOwnTables() noexcept
+{
+  myTables.myNonTerminals = myNonTerminals.data();
+  myTables.myNonTerminalsSize = myNonTerminals.size();
+  myTables.myTerminals = myTerminals.data();
+  myTables.myTerminalsSize = myTerminals.size();
+  myTables.myTable = myTable.data();
+  myTables.myTableSize = myTable.size();
+  myTables.myComb = myComb.data();
+  myTables.myCombSize = myComb.size();
+  myTables.myRowBases = myRowBases.data();
+  myTables.myRowDefaults = myRowDefaults.data();
+  myTables.myRowsSize = myRowBases.size();
+  myTables.myNumberGrammarSymbols = myNumberGrammarSymbols.data();
+  myTables.myNumberProductions = myNumberGrammarSymbols.size();
+  myTables.myPushOffsets = myPushOffsets.data();
+  myTables.myPushes = myPushes.data();
+  myTables.myPushesSize = myPushes.size();
+}
+
+//*******************************************************
+// PredictTable::validate
+//*******************************************************
+void PredictTable::validate() const
+{
+  const auto &tables = myTables;
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  const auto &productions = myGrammar.getProductions();
+  uint32_t numberNonTerminals =
+    symbols.getEnd(SymbolRegistry::Kind::NonTerminal) - myNonTerminalBegin;
+
+  // Row of the left hand side of each production, by number - 1. A row
+  // predicting another non-terminal's production could loop the parse.
+  std::vector<uint32_t> productionRows;
+  for (const auto &production : productions)
+  {
+    productionRows.push_back(symbols.getIndex(*production->getLHS()) -
+                             myNonTerminalBegin);
+  }
+  auto isProductionOf = [&](uint32_t theRow, uint32_t theProductionNumber)
+  {
+    return NO_PRODUCTION == theProductionNumber ||
+      (theProductionNumber <= productionRows.size() &&
+       productionRows[theProductionNumber - 1] == theRow);
+  };
+
+  bool valid = false;
+  if (Representation::Dense == tables.myRepresentation)
+  {
+    valid = tables.myTableSize ==
+      static_cast<uint64_t>(numberNonTerminals) * myNumberTerminals;
+    for (std::size_t ii = 0; valid && ii < tables.myTableSize; ++ii)
+    {
+      valid = isProductionOf(ii / myNumberTerminals, tables.myTable[ii]);
+    }
+  }
+  else if (Representation::Compressed == tables.myRepresentation)
   {
-    productionNumber = myTable.at(theNonTerminal).at(theTerminal);
+    valid = tables.myRowsSize == numberNonTerminals;
+    for (uint32_t row = 0; valid && row < numberNonTerminals; ++row)
+    {
+      valid = static_cast<uint64_t>(tables.myRowBases[row]) +
+        myNumberTerminals <= tables.myCombSize &&
+        isProductionOf(row, tables.myRowDefaults[row]);
+    }
+    // Entries tagged with no row are free.
+    for (std::size_t ii = 0; valid && ii < tables.myCombSize; ++ii)
+    {
+      uint32_t tag = tables.myComb[ii] >> COMB_ROW_SHIFT;
+      valid = 0 == tag ||
+        isProductionOf(tag - 1, tables.myComb[ii] & COMB_PRODUCTION_MASK);
+    }
+  }
+  valid = valid &&
+    std::all_of(tables.myNonTerminals,
+                tables.myNonTerminals + tables.myNonTerminalsSize,
+                [&](Symbol::Index theNonTerminal)
+                {
+                  return theNonTerminal >= myNonTerminalBegin &&
+                    static_cast<uint32_t>(theNonTerminal -
+                                          myNonTerminalBegin) <
+                      numberNonTerminals;
+                }) &&
+    std::all_of(tables.myTerminals,
+                tables.myTerminals + tables.myTerminalsSize,
+                [&](Symbol::Index theTerminal)
+                {
+                  return theTerminal < myNumberTerminals;
+                });
+
+  // The push sequences are the productions' right hand sides, reversed,
+  // as fillPushes builds them.
+  valid = valid && tables.myNumberProductions == productions.size();
+  uint32_t push = 0;
+  for (std::size_t ii = 0; valid && ii < productions.size(); ++ii)
+  {
+    valid = tables.myPushOffsets[ii] == push;
+    uint32_t numberGrammarSymbols = 0;
+    auto rhs = productions[ii]->getRHS();
+    for (auto rhsIter = rhs.rbegin(); valid && rhsIter != rhs.rend();
+         ++rhsIter)
+    {
+      auto index = symbols.getIndex(**rhsIter);
+      auto kind = symbols.getKind(index);
+      if (SymbolRegistry::Kind::Action != kind)
+      {
+        ++numberGrammarSymbols;
+      }
+      if (SymbolRegistry::Kind::Lambda == kind)
+      {
+        continue;
+      }
+      auto entryKind = SymbolRegistry::Kind::Terminal == kind ?
+        ParseStackEntry::Kind::Terminal :
+        (SymbolRegistry::Kind::NonTerminal == kind ?
+         ParseStackEntry::Kind::NonTerminal : ParseStackEntry::Kind::Action);
+      valid = push < tables.myPushesSize &&
+        tables.myPushes[push].getKind() == entryKind &&
+        tables.myPushes[push].getIndex() == index;
+      ++push;
+    }
+    valid = valid &&
+      tables.myNumberGrammarSymbols[ii] == numberGrammarSymbols;
+  }
+  valid = valid && tables.myPushOffsets[productions.size()] == push &&
+    tables.myPushesSize == push;
+
+  if (! valid)
+  {
+    throw std::runtime_error{"Grammar cache is corrupt."};
   }
-  catch(...) {}
-  return productionNumber;
 }
 
 //*******************************************************
@@ -75,41 +651,48 @@ std::ostream& operator<<(std::ostream &theOS,
 {
   static constexpr uint32_t MIN_WIDTH = 3;
 
-  theOS << std::setw(thePredictTable.myLargestNonTerminalNameSize)
+  const auto &symbols = thePredictTable.myGrammar.getSymbolRegistry();
+  const auto &tables = thePredictTable.myTables;
+  auto terminalsBegin = tables.myTerminals;
+  auto terminalsEnd = terminalsBegin + tables.myTerminalsSize;
+  auto nonTerminalsBegin = tables.myNonTerminals;
+  auto nonTerminalsEnd = nonTerminalsBegin + tables.myNonTerminalsSize;
+
+  theOS << std::setw(tables.myLargestNonTerminalNameSize)
         << "Predict Table" << std::endl
-        << std::setw(thePredictTable.myLargestNonTerminalNameSize)
+        << std::setw(tables.myLargestNonTerminalNameSize)
         << "=============" << std::endl;
   /*
    * Print the column headers (terminal symbol names) 
    */ 
-  theOS << std::setw(thePredictTable.myLargestNonTerminalNameSize) << "";
-  for (auto terminal : thePredictTable.myTerminals)
+  theOS << std::setw(tables.myLargestNonTerminalNameSize) << "";
+  for (auto terminal = terminalsBegin; terminal != terminalsEnd; ++terminal)
   {
-    theOS << " | " << std::setw(MIN_WIDTH) << terminal->getName();
+    theOS << " | " << std::setw(MIN_WIDTH) << symbols.getName(*terminal);
   }
   theOS << std::endl;
 
   /*
    * Print each LHS predict set. 
    */ 
-  for (auto row : thePredictTable.myTable)
+  for (auto nonTerminal = nonTerminalsBegin; nonTerminal != nonTerminalsEnd;
+       ++nonTerminal)
   {
-    auto nonTerminal = row.first;
-    auto columns = row.second;
-
     // Print the non-terminal symbol
-    theOS << std::setw(thePredictTable.myLargestNonTerminalNameSize)
-          << nonTerminal->getName();
+    theOS << std::setw(tables.myLargestNonTerminalNameSize)
+          << symbols.getName(*nonTerminal);
 
     // Print production numbers.
-    for (auto terminal : thePredictTable.myTerminals)
+    for (auto terminal = terminalsBegin; terminal != terminalsEnd;
+         ++terminal)
     {
-      uint32_t nameSize = terminal->getName().size();
+      uint32_t nameSize = symbols.getName(*terminal).size();
       theOS << " | " << std::setw(std::max(MIN_WIDTH, nameSize));
-      const auto productionNumberIter = columns.find(terminal);
-      if (productionNumberIter != columns.end())
+      auto productionNumber =
+        thePredictTable.getProductionNumber(*nonTerminal, *terminal);
+      if (PredictTable::NO_PRODUCTION != productionNumber)
       {
-        theOS << productionNumberIter->second;
+        theOS << productionNumber;
       }
       else
       {
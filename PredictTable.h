@@ -8,11 +8,14 @@
  * @author Michael Albers
  */
 
+#include <cstddef>
 #include <cstdint>
-#include <map>
 #include <memory>
 #include <ostream>
+#include <vector>
 
+#include "GrammarCache.h"
+#include "ParseStackEntry.h"
 #include "Symbol.h"
 
 class Grammar;
@@ -20,6 +23,14 @@ class Grammar;
 /**
  * The class encapuslates a predict table. The table is used to determine
  * the next production to apply given a terminal and non-terminal symbol.
+ *
+ * The table is stored in one of two representations (see Representation).
+ * Dense is a plain 2-D array and the fastest to look up. Compressed is a
+ * comb vector (row displacement): each row keeps its most common entry as
+ * a default, and the rest of its entries are overlaid with those of the
+ * other rows in a single vector, tagged with their row. The tables of large
+ * grammars are mostly empty, so they are compressed when that at least
+ * halves their size.
  */
 class PredictTable
 {
@@ -28,6 +39,98 @@ class PredictTable
   // ************************************************************
   public:
 
+  /** Ways of storing the table. */
+  enum class Representation : uint8_t
+  {
+    /** 2-D array, Tables::myTable. */
+    Dense,
+    /** Comb vector, Tables::myComb, myRowBases and myRowDefaults. */
+    Compressed
+  };
+
+  /**
+   * The arrays the parser reads. They are either built from the Grammar or
+   * loaded from a grammar cache, and owned by the PredictTable, or are
+   * constant data compiled into the program (see EmbeddedGrammar), which
+   * the PredictTable points at without copying.
+   */
+  class Tables
+  {
+    public:
+
+    /** Representation of the table. */
+    Representation myRepresentation;
+
+    /** Size of the longest column name. */
+    uint32_t myLargestColumnNameSize;
+
+    /** Size of the longest non-terminal name. */
+    uint32_t myLargestNonTerminalNameSize;
+
+    /**
+     * Non-terminals with a row in the table, in the order they appear in
+     * the grammar, for printing.
+     */
+    const Symbol::Index *myNonTerminals;
+
+    /** Number of entries of myNonTerminals. */
+    uint32_t myNonTerminalsSize;
+
+    /** Terminals used in the table, in name order, for printing. */
+    const Symbol::Index *myTerminals;
+
+    /** Number of entries of myTerminals. */
+    uint32_t myTerminalsSize;
+
+    /**
+     * Dense table, by symbol index. Mimics a 2-D array, see getEntry.
+     * myTable[non-terminal][terminal] = production number, NO_PRODUCTION
+     * if the combination is an error. Empty if the table is Compressed.
+     */
+    const uint16_t *myTable;
+
+    /** Number of entries of myTable. */
+    uint32_t myTableSize;
+
+    /**
+     * Compressed table entries. Each is (row << 16 | production number),
+     * row being the non-terminal's row plus one so an empty slot is 0. A
+     * row's entry for a terminal is at myRowBases[row] + terminal, if it
+     * has the row's tag; otherwise it is the row's default.
+     */
+    const uint32_t *myComb;
+
+    /** Number of entries of myComb. */
+    uint32_t myCombSize;
+
+    /** Position of each row in myComb. */
+    const uint32_t *myRowBases;
+
+    /** Production number of each row's entries missing from myComb. */
+    const uint16_t *myRowDefaults;
+
+    /** Number of entries of myRowBases and myRowDefaults. */
+    uint32_t myRowsSize;
+
+    /** Number of grammar symbols of each production, by number - 1. */
+    const uint32_t *myNumberGrammarSymbols;
+
+    /** Number of productions, the entries of myNumberGrammarSymbols. */
+    uint32_t myNumberProductions;
+
+    /**
+     * Start of each production's symbols in myPushes, by number - 1, plus
+     * the end of the last production's.
+     */
+    const uint32_t *myPushOffsets;
+
+    /** Push sequences of all productions, one after another. */
+    const ParseStackEntry *myPushes;
+
+    /** Number of entries of myPushes. */
+    uint32_t myPushesSize;
+  };
+
   /**
    * Default constructor
    */
@@ -36,21 +139,62 @@ class PredictTable
   /**
    * Copy constructor
    */
-  PredictTable(const PredictTable&) = default;
+  PredictTable(const PredictTable&) = delete;
 
   /**
    * Move constructor
    */
-  PredictTable(PredictTable&&) = default;
+  PredictTable(PredictTable&&) = delete;
 
   /**
-   * Constructor. Populates the predict table from the Grammar object.
+   * Constructor. Populates the predict table from the Grammar object,
+   * choosing the representation from the density of the table.
    *
    * @param theGrammar
    *          Grammar object with predict sets filled in.
+   * @throws std::runtime_error
+   *          if there are too many productions for the table
    */
   PredictTable(const Grammar &theGrammar);
 
+  /**
+   * Constructor. Populates the predict table from the Grammar object, in
+   * the given representation.
+   *
+   * @param theGrammar
+   *          Grammar object with predict sets filled in.
+   * @param theRepresentation
+   *          representation of the table
+   * @throws std::runtime_error
+   *          if there are too many productions or non-terminals for the
+   *          representation
+   */
+  PredictTable(const Grammar &theGrammar, Representation theRepresentation);
+
+  /**
+   * Constructor. Loads the predict table from a cache written by save.
+   *
+   * @param theGrammar
+   *          Grammar object the table was built from
+   * @param theReader
+   *          cache reader, positioned where save wrote the table
+   * @throws std::runtime_error
+   *          if the cache is truncated or corrupt
+   */
+  PredictTable(const Grammar &theGrammar, GrammarCache::Reader &theReader);
+
+  /**
+   * Constructor. Points at the given tables without copying them.
+   *
+   * @param theGrammar
+   *          Grammar object the tables were built from
+   * @param theTables
+   *          tables, which must outlive this object
+   * @throws std::runtime_error
+   *          if the tables do not fit the grammar
+   */
+  PredictTable(const Grammar &theGrammar, const Tables &theTables);
+
   /**
    * Destructor
    */
@@ -59,27 +203,94 @@ class PredictTable
   /**
    * Copy assignment operator
    */
-  PredictTable& operator=(const PredictTable&) = default;
+  PredictTable& operator=(const PredictTable&) = delete;
 
   /**
    * Move assignment operator
    */
-  PredictTable& operator=(PredictTable&&) = default;
+  PredictTable& operator=(PredictTable&&) = delete;
+
+  /** Production number of the entries with no production. */
+  static constexpr uint16_t NO_PRODUCTION = 0;
 
   /**
    * Returns the production number to use for the given non-terminal and
    * terminal.
    *
    * @param theNonTerminal
-   *          non-terminal for lookup
+   *          index of the non-terminal for lookup
    * @param theTerminal
-   *          terminal for lookup
-   * @return production number or 0 on invalid symbol combination
+   *          index of the terminal for lookup
+   * @return production number or NO_PRODUCTION on invalid symbol
+   *         combination
+   */
+  uint32_t getProductionNumber(Symbol::Index theNonTerminal,
+                               Symbol::Index theTerminal) const noexcept;
+
+  /**
+   * Returns the number of grammar symbols (terminals, non-terminals and
+   * lambda) on the RHS of the given production, the number of semantic
+   * records it needs (see SemanticStack::expand).
+   *
+   * @param theProductionNumber
+   *          production number
+   * @return number of grammar symbols
+   */
+  uint32_t getNumberGrammarSymbols(uint32_t theProductionNumber)
+    const noexcept;
+
+  /**
+   * Returns the start of the entries the given production pushes on the
+   * parse stack when predicted: its RHS, last symbol first, without lambda.
+   *
+   * @param theProductionNumber
+   *          production number
+   * @return first entry to push
+   */
+  const ParseStackEntry* getPushBegin(uint32_t theProductionNumber)
+    const noexcept;
+
+  /**
+   * Returns the end of the entries the given production pushes, see
+   * getPushBegin.
+   *
+   * @param theProductionNumber
+   *          production number
+   * @return one past the last entry to push
    */
-  uint32_t getProductionNumber(std::shared_ptr<Symbol> theNonTerminal,
-                               std::shared_ptr<Symbol> theTerminalId)
+  const ParseStackEntry* getPushEnd(uint32_t theProductionNumber)
     const noexcept;
 
+  /**
+   * Returns the representation of the table.
+   *
+   * @return representation
+   */
+  Representation getRepresentation() const noexcept;
+
+  /**
+   * Returns the tables, for GrammarTablesGenerator to write out.
+   *
+   * @return tables
+   */
+  const Tables& getTables() const noexcept;
+
+  /**
+   * Returns the memory used by the entries of the table, that is the
+   * arrays getProductionNumber reads.
+   *
+   * @return size in bytes
+   */
+  std::size_t getSize() const noexcept;
+
+  /**
+   * Writes the predict table to a cache.
+   *
+   * @param theWriter
+   *          cache writer
+   */
+  void save(GrammarCache::Writer &theWriter) const;
+
   /**
    * Stream insertion operator.
    *
@@ -102,29 +313,108 @@ class PredictTable
   // ************************************************************
   private:
 
+  /** Mask of the production number of a myComb entry. */
+  static constexpr uint32_t COMB_PRODUCTION_MASK = 0xFFFF;
+
+  /** Shift of the row of a myComb entry. */
+  static constexpr uint32_t COMB_ROW_SHIFT = 16;
+
   /**
-   * Populates the predict table.
+   * Builds the Compressed representation from myTable.
+   *
+   * @throws std::runtime_error
+   *          if there are too many non-terminals to compress the table
+   */
+  void compress();
+
+  /**
+   * Fills in the push sequences of the productions, see getPushBegin.
+   */
+  void fillPushes();
+
+  /**
+   * Populates the predict table, in the Dense representation.
    */
   void populateTable();
 
+  /**
+   * Switches to the given representation, freeing the other one.
+   *
+   * @param theRepresentation
+   *          representation to keep
+   */
+  void setRepresentation(Representation theRepresentation);
+
+  /**
+   * Points myTables at the arrays this object owns.
+   */
+  void useOwnTables() noexcept;
+
+  /**
+   * Checks the tables in myTables fit the grammar: every production
+   * number is of a production of the row's non-terminal, every lookup
+   * stays in the table and the push sequences are those of the
+   * productions.
+   *
+   * @throws std::runtime_error
+   *          if not
+   */
+  void validate() const;
+
   /** Grammar data */
   const Grammar &myGrammar;
 
-  /** Size of the longest column name. */
-  uint32_t myLargestColumnNameSize = 0;
+  /**
+   * Returns the position of the given entry in myTable.
+   *
+   * @param theNonTerminal
+   *          index of the non-terminal
+   * @param theTerminal
+   *          index of the terminal
+   * @return position in myTable
+   */
+  uint32_t getEntry(Symbol::Index theNonTerminal, Symbol::Index theTerminal)
+    const noexcept;
+
+  /** Compressed table entries, see Tables. */
+  std::vector<uint32_t> myComb;
+
+  /** Index of the first non-terminal, the first row of the table. */
+  Symbol::Index myNonTerminalBegin = 0;
+
+  /** Number of grammar symbols of each production, see Tables. */
+  std::vector<uint32_t> myNumberGrammarSymbols;
+
+  /** Non-terminals with a row, see Tables. */
+  std::vector<Symbol::Index> myNonTerminals;
+
+  /** Number of terminals, the columns of the table. */
+  uint32_t myNumberTerminals = 0;
 
-  /** Size of the longest non-terminal name. */
-  uint32_t myLargestNonTerminalNameSize = 0;
+  /** Start of each production's push sequence, see Tables. */
+  std::vector<uint32_t> myPushOffsets;
+
+  /** Push sequences, see Tables. */
+  std::vector<ParseStackEntry> myPushes;
+
+  /** Position of each row in myComb, see Tables. */
+  std::vector<uint32_t> myRowBases;
+
+  /** Default of each row, see Tables. */
+  std::vector<uint16_t> myRowDefaults;
+
+  /** Dense table, see Tables. */
+  std::vector<uint16_t> myTable;
+
+  /** Terminals used in the table, see Tables. */
+  std::vector<Symbol::Index> myTerminals;
 
   /**
-   * Predict table. Mimics a 2-D array.
-   * myTable[non-terminal][terminal] = production number
+   * The arrays the parser reads: the members above or embedded ones. Also
+   * holds the representation and name sizes, which are set as the table
+   * is built.
    */
-  std::map<std::shared_ptr<Symbol>,
-           std::map<std::shared_ptr<Symbol>, uint32_t>> myTable;
-
-  /** All terminals used in the predict table. */
-  Symbol::SymbolSet myTerminals;
+  Tables myTables = Tables();
 };
 
 #endif
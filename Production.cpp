@@ -6,6 +6,7 @@
  */
 
 #include <iomanip>
+#include <utility>
 
 #include "Production.h"
 #include "Symbol.h"
@@ -29,14 +30,6 @@ void Production::addRHSSymbol(std::shared_ptr<Symbol> theRHSSymbol)
   myRHS.push_back(theRHSSymbol);
 }
 
-//*******************************************************
-// Production::addToPredictSet
-//*******************************************************
-void Production::addToPredictSet(std::shared_ptr<Symbol> theSymbol) noexcept
-{
-  myPredictSet.insert(theSymbol);
-}
-
 //*******************************************************
 // Production::getLHS
 //*******************************************************
@@ -56,7 +49,7 @@ uint32_t Production::getNumber() const noexcept
 //*******************************************************
 // Production::getPredictSet
 //*******************************************************
-Symbol::SymbolSet Production::getPredictSet() const noexcept
+const BitSet& Production::getPredictSet() const noexcept
 {
   return myPredictSet;
 }
@@ -69,6 +62,14 @@ Symbol::SymbolList Production::getRHS() const noexcept
   return myRHS;
 }
 
+//*******************************************************
+// Production::setPredictSet
+//*******************************************************
+void Production::setPredictSet(BitSet thePredictSet) noexcept
+{
+  myPredictSet = std::move(thePredictSet);
+}
+
 //*******************************************************
 // operator<<
 //*******************************************************
@@ -12,6 +12,7 @@
 #include <memory>
 #include <ostream>
 
+#include "BitSet.h"
 #include "Symbol.h"
 
 /**
@@ -62,14 +63,6 @@ class Production
    */
   void addRHSSymbol(std::shared_ptr<Symbol> theRHSSymbol) noexcept;
 
-  /**
-   * Adds the given symbol to the predict set of this production
-   *
-   * @param theSymbol
-   *          symbol to add to the predict set
-   */
-  void addToPredictSet(std::shared_ptr<Symbol> theSymbol) noexcept;
-
   /**
    * Returns the LHS of this production.
    *
@@ -87,9 +80,9 @@ class Production
   /**
    * Returns the predict set for this production.
    *
-   * @return predict set
+   * @return predict set, of terminal indices (see Symbol::getIndex)
    */
-  Symbol::SymbolSet getPredictSet() const noexcept;
+  const BitSet& getPredictSet() const noexcept;
 
   /**
    * Returns the RHS symbols.
@@ -98,6 +91,14 @@ class Production
    */
   Symbol::SymbolList getRHS() const noexcept;
 
+  /**
+   * Sets the predict set of this production.
+   *
+   * @param thePredictSet
+   *          indices of the terminals which predict this production
+   */
+  void setPredictSet(BitSet thePredictSet) noexcept;
+
   /**
    * Copy assignment operator
    */
@@ -136,8 +137,8 @@ class Production
   /** Numeric identifier of the production. */
   const uint32_t myNumber;
 
-  /** Set of symbols which predicts this production. */
-  Symbol::SymbolSet myPredictSet;
+  /** Indices of the terminals which predict this production. */
+  BitSet myPredictSet;
 
   /** Right hand side of production, in order. */
   Symbol::SymbolList myRHS;
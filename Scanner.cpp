@@ -5,41 +5,156 @@
  * @author Michael Albers
  */
 
-#include <cerrno>
+#include <algorithm>
 #include <cstring>
 #include <iostream>
-#include <stdexcept>
+#include <thread>
 
 #include "ErrorWarningTracker.h"
 #include "Scanner.h"
 #include "ScannerTable.h"
 
+constexpr std::size_t Scanner::CHUNK_SIZE;
+constexpr std::size_t Scanner::PARALLEL_THRESHOLD;
+
 //*******************************************************
 // Scanner::Scanner
 //*******************************************************
 Scanner::Scanner(const std::string &theFile,
                  ScannerTable &theScannerTable,
                  ErrorWarningTracker &theEWTracker,
-                 bool thePrintTokens) :
+                 bool thePrintTokens,
+                 bool theUseDirectScanner,
+                 std::size_t theChunkSize) :
   myEWTracker(theEWTracker),
   myFile(theFile),
+  mySource(std::make_shared<SourceBuffer>(myFile)),
   myPrintTokens(thePrintTokens),
   myScannerTable(theScannerTable)
 {
-  myInputStream.open(myFile, std::ios::in);
-  if (! myInputStream)
+  myCursor = mySource->getBegin();
+  myReleased = myCursor;
+
+  if (theUseDirectScanner)
   {
-    auto localErrno = errno;
-    throw std::runtime_error("Failed to open '" + myFile + "': " +
-                             std::strerror(localErrno));
+    auto &directScanners = getDirectScanners();
+    auto directScanner = directScanners.find(
+      myScannerTable.getFingerprint());
+    if (directScanner != directScanners.end())
+    {
+      myDirectScanner = directScanner->second;
+    }
   }
 
-  Token token;
-  do
+  std::size_t size = mySource->getEnd() - mySource->getBegin();
+  if (0 == theChunkSize && size >= PARALLEL_THRESHOLD &&
+      std::thread::hardware_concurrency() > 1)
   {
-    token = getToken();
-    myTokens.push_back(token);
-  } while (!(token.getTerminal() == myScannerTable.getEOF()));
+    theChunkSize = CHUNK_SIZE;
+  }
+  if (theChunkSize > 0)
+  {
+    // Chunks start at the beginning of a line.
+    auto chunkStart = mySource->getBegin();
+    while (chunkStart != mySource->getEnd())
+    {
+      myChunkStarts.push_back(chunkStart);
+      if (static_cast<std::size_t>(mySource->getEnd() - chunkStart) <=
+          theChunkSize)
+      {
+        break;
+      }
+      auto newLine = static_cast<const char*>(std::memchr(
+        chunkStart + theChunkSize, '\n',
+        mySource->getEnd() - chunkStart - theChunkSize));
+      if (nullptr == newLine)
+      {
+        break;
+      }
+      chunkStart = newLine + 1;
+    }
+    myChunkStarts.push_back(mySource->getEnd());
+
+    myParallel = true;
+    launchChunks();
+  }
+}
+
+//*******************************************************
+// Scanner::Scanner
+//*******************************************************
+Scanner::Scanner(const Scanner &theParent, ChunkResult &theResult,
+                 const char *theCursor, uint32_t theLine,
+                 uint32_t theColumn) :
+  myColumn(theColumn),
+  myCursor(theCursor),
+  myDirectScanner(theParent.myDirectScanner),
+  myEWTracker(theParent.myEWTracker),
+  myFile(theParent.myFile),
+  mySource(theParent.mySource),
+  myLine(theLine),
+  myChunkRecord(&theResult),
+  myPrintTokens(false),
+  myScannerTable(theParent.myScannerTable)
+{
+}
+
+//*******************************************************
+// Scanner::~Scanner
+//*******************************************************
+Scanner::~Scanner()
+{
+  // Chunks still being scanned use this object, wait for them first.
+  myChunkScans.clear();
+}
+
+//*******************************************************
+// Scanner::adoptNextChunk
+//*******************************************************
+void Scanner::adoptNextChunk()
+{
+  auto chunkNumber = myChunksAdopted++;
+  auto chunk = myChunkScans.front().get();
+  myChunkScans.pop_front();
+  launchChunks();
+
+  auto chunkLine = myNextChunkLine;
+  myNextChunkLine += chunk.myNewLines;
+
+  myChunkToken = 0;
+  myChunkError = 0;
+  myChunkLineOffset = chunkLine - 1;
+  if (chunkNumber > 0)
+  {
+    // The scan of the previous chunk stopped at a token boundary past the
+    // end of that chunk. If this chunk's scan started a token there too the
+    // two scans agree from there on.
+    auto resume = myChunk.myEnd;
+    auto syncPoint = std::lower_bound(
+      chunk.mySyncPoints.begin(), chunk.mySyncPoints.end(), resume,
+      [](const SyncPoint &theSyncPoint, const char *theCursor)
+      {
+        return theSyncPoint.myCursor < theCursor;
+      });
+
+    if (syncPoint != chunk.mySyncPoints.end() &&
+        syncPoint->myCursor == resume)
+    {
+      myChunkToken = syncPoint->myTokensBefore;
+      myChunkError = syncPoint->myErrorsBefore;
+    }
+    else
+    {
+      chunk = scanChunk(resume, myChunkStarts[chunkNumber + 1], myLine,
+                        myColumn, chunkNumber + 2 == myChunkStarts.size());
+      myChunkLineOffset = 0;
+    }
+  }
+
+  myChunk = std::move(chunk);
+  myCursor = myChunk.myEnd;
+  myLine = myChunk.myEndLine + myChunkLineOffset;
+  myColumn = myChunk.myEndColumn;
 }
 
 //*******************************************************
@@ -47,7 +162,7 @@ Scanner::Scanner(const std::string &theFile,
 //*******************************************************
 void Scanner::consumeChar()
 {
-  auto character = myInputStream.get();
+  auto character = *myCursor++;
   ++myColumn;
   if ('\n' == character)
   {
@@ -61,7 +176,9 @@ void Scanner::consumeChar()
 //*******************************************************
 char Scanner::currentChar()
 {
-  return myInputStream.peek();
+  // At the end of the file this is SourceBuffer::SENTINEL, but the same
+  // character can be in the file too; check isAtEnd.
+  return *myCursor;
 }
 
 //*******************************************************
@@ -72,6 +189,18 @@ uint32_t Scanner::getColumn() const noexcept
   return myColumn;
 }
 
+//*******************************************************
+// Scanner::getDirectScanners
+//*******************************************************
+std::map<uint64_t, Scanner::DirectScanFunction>& Scanner::getDirectScanners()
+  noexcept
+{
+  // Function local so it exists before the generated code registers with it
+  // during static initialization.
+  static std::map<uint64_t, DirectScanFunction> directScanners;
+  return directScanners;
+}
+
 //*******************************************************
 // Scanner::getLine
 //*******************************************************
@@ -83,9 +212,13 @@ uint32_t Scanner::getLine() const noexcept
 //*******************************************************
 // Scanner::getRemainingTokens
 //*******************************************************
-std::deque<Token> Scanner::getRemainingTokens() const noexcept
+std::deque<Token> Scanner::getRemainingTokens() noexcept
 {
-  return myTokens;
+  while (myLookahead.empty() || ! isEOF(myLookahead.back()))
+  {
+    myLookahead.push_back(nextToken());
+  }
+  return myLookahead;
 }
 
 //*******************************************************
@@ -105,120 +238,310 @@ Token Scanner::getToken()
     currentState = ScannerTable::START_STATE;
   };
 
-  auto isNoTerminal = [](std::shared_ptr<Symbol> theTerminal)->bool
-  {
-    bool isNoTerminal = false;
-    try
-    {
-      isNoTerminal =
-        (dynamic_cast<TerminalSymbol*>(theTerminal.get())->getId() ==
-         ScannerTable::NO_TERMINAL);
-    }
-    catch (std::bad_cast){/* Just in case */}
-
-    return isNoTerminal;
-  };
-
   reset();
   token.setPosition(myLine, myColumn);
 
-  while (currentChar() >= 0) // -1 is returned on EOF
+  if (myChunkRecord != nullptr)
   {
-    auto action = myScannerTable.getAction(currentState, currentChar());
+    myChunkRecord->mySyncPoints.push_back(
+      SyncPoint{myCursor, myChunkRecord->myTokens.size(),
+                myChunkRecord->myErrors.size()});
+  }
 
-    switch (action)
+  while (! isAtEnd())
+  {
+    ScannerTable::PackedEntry entry;
+    if (myDirectScanner != nullptr)
+    {
+      // The direct scanner takes all of the Move* actions itself, so only
+      // Error and Halt* entries come back from it.
+      moveCursor(myDirectScanner(myCursor, mySource->getEnd(), token,
+                                 entry));
+      if (isAtEnd())
+      {
+        break;
+      }
+    }
+    else
+    {
+      entry = myScannerTable.getEntry(currentState, currentChar());
+    }
+
+    switch (entry.getAction())
     {
       case ScannerTable::Action::Error:
       {
-        token.append(currentChar());
+        token.append(myCursor);
         consumeChar();
 
         std::string error;
         error += "invalid token: '" + token.getToken() + "'";
-        myEWTracker.reportError(getLine(), getColumn(), error);
+        reportError(error);
 
         reset(); // Error recovery
+        token.setPosition(myLine, myColumn);
       }
       break;
 
       case ScannerTable::Action::MoveAppend:
-        currentState = myScannerTable.getState(currentState,
-                                               currentChar());
-        token.append(currentChar());
+        currentState = entry.getNextState();
+        token.append(myCursor);
         consumeChar();
+        skipRun(currentState, token);
         break;
 
       case ScannerTable::Action::MoveNoAppend:
-        currentState = myScannerTable.getState(currentState,
-                                               currentChar());
+        currentState = entry.getNextState();
         consumeChar();
+        skipRun(currentState, token);
         break;
 
       case ScannerTable::Action::HaltAppend:
-      {
-        token.append(currentChar());
-        auto terminal = myScannerTable.lookupTerminal(currentState,
-                                                      currentChar(),
-                                                      token.getToken());
-        token.setTerminal(terminal);
+        token.append(myCursor);
         consumeChar();
-        if (isNoTerminal(terminal))
+        if (entry.getTerminalId() == ScannerTable::NO_TERMINAL)
         {
           return getToken();
         }
-      }
-      return token;
+        token.setTerminal(myScannerTable.lookupTerminal(entry.getTerminalId(),
+                                                        token.getText(),
+                                                        token.getLength()));
+        return token;
 
       case ScannerTable::Action::HaltNoAppend:
-      {
-        auto terminal = myScannerTable.lookupTerminal(currentState,
-                                                      currentChar(),
-                                                      token.getToken());
-        token.setTerminal(terminal);
         consumeChar();
-        if (isNoTerminal(terminal))
+        if (entry.getTerminalId() == ScannerTable::NO_TERMINAL)
         {
           return getToken();
         }
-      }
-      return token;
+        token.setTerminal(myScannerTable.lookupTerminal(entry.getTerminalId(),
+                                                        token.getText(),
+                                                        token.getLength()));
+        return token;
 
       case ScannerTable::Action::HaltReuse:
-      {
-        auto terminal = myScannerTable.lookupTerminal(currentState,
-                                                      currentChar(),
-                                                      token.getToken());
-        token.setTerminal(terminal);
-        if (isNoTerminal(terminal))
+        if (entry.getTerminalId() == ScannerTable::NO_TERMINAL)
         {
           return getToken();
         }
-      }
-      return token;
+        token.setTerminal(myScannerTable.lookupTerminal(entry.getTerminalId(),
+                                                        token.getText(),
+                                                        token.getLength()));
+        return token;
+    }
+  }
+
+  token.clear();
+  static const char EOF_TEXT[] = "$"; // To match lecture 15 PDF examples.
+  token.append(EOF_TEXT);
+  token.setTerminal(myScannerTable.getEOF().get());
+  token.setPosition(myLine, myColumn);
+  return token;
+}
+
+//*******************************************************
+// Scanner::isAtEnd
+//*******************************************************
+bool Scanner::isAtEnd() const noexcept
+{
+  return mySource->getEnd() == myCursor;
+}
+
+//*******************************************************
+// Scanner::isEOF
+//*******************************************************
+bool Scanner::isEOF(const Token &theToken) const noexcept
+{
+  return theToken.getTerminal() == myScannerTable.getEOF().get();
+}
+
+//*******************************************************
+// Scanner::scanChunk
+//*******************************************************
+Scanner::ChunkResult Scanner::scanChunk(const char *theBegin,
+                                        const char *theEnd,
+                                        uint32_t theLine,
+                                        uint32_t theColumn,
+                                        bool theLastChunk) const
+{
+  ChunkResult result;
+  result.myNewLines = std::count(theBegin, std::max(theBegin, theEnd), '\n');
+
+  Scanner scanner(*this, result, theBegin, theLine, theColumn);
+  while (theLastChunk || scanner.myCursor < theEnd)
+  {
+    auto tokenStart = scanner.myCursor;
+    auto token = scanner.getToken();
+    if (scanner.isEOF(token))
+    {
+      result.myTokens.push_back(token);
+      break;
+    }
+    if (scanner.myCursor == tokenStart)
+    {
+      // A character the scanner cannot get past; leave it to the sequential
+      // scan so it behaves exactly as it always has.
+      result.mySyncPoints.pop_back();
+      result.myStuck = true;
+      break;
     }
+    result.myTokens.push_back(token);
+  }
+
+  result.myEnd = scanner.myCursor;
+  result.myEndLine = scanner.myLine;
+  result.myEndColumn = scanner.myColumn;
+  return result;
+}
+
+//*******************************************************
+// Scanner::skipRun
+//*******************************************************
+void Scanner::skipRun(ScannerTable::State theState, Token &theToken)
+{
+  auto runEnd = myScannerTable.findRunEnd(theState, myCursor);
+  if (runEnd == myCursor)
+  {
+    return;
   }
 
-  if (myInputStream.eof())
+  if (myScannerTable.isRunAppended(theState))
   {
-    token.clear();
-    token.append('$'); // Just to match examples in lecture 15 PDF.
-    token.setTerminal(myScannerTable.getEOF());
-    token.setPosition(myLine, myColumn);
+    theToken.append(myCursor, runEnd - myCursor);
   }
+  moveCursor(runEnd);
+}
 
+//*******************************************************
+// Scanner::launchChunks
+//*******************************************************
+void Scanner::launchChunks()
+{
+  auto numberChunks = myChunkStarts.size() - 1;
+  auto maximumScans = std::max(1u, std::thread::hardware_concurrency());
+  while (myChunksLaunched < numberChunks &&
+         myChunkScans.size() < maximumScans)
+  {
+    auto chunkNumber = myChunksLaunched++;
+    myChunkScans.push_back(std::async(
+      std::launch::async, &Scanner::scanChunk, this,
+      myChunkStarts[chunkNumber], myChunkStarts[chunkNumber + 1], 1, 1,
+      chunkNumber + 1 == numberChunks));
+  }
+}
+
+//*******************************************************
+// Scanner::moveCursor
+//*******************************************************
+void Scanner::moveCursor(const char *theCursor) noexcept
+{
+  auto lineStart = myCursor;
+  while (auto newLine = static_cast<const char*>(
+           std::memchr(lineStart, '\n', theCursor - lineStart)))
+  {
+    ++myLine;
+    myColumn = 1;
+    lineStart = newLine + 1;
+  }
+  myColumn += theCursor - lineStart;
+  myCursor = theCursor;
+}
+
+//*******************************************************
+// Scanner::nextToken
+//*******************************************************
+Token Scanner::nextToken()
+{
+  while (myParallel && myChunkToken == myChunk.myTokens.size())
+  {
+    for (; myChunkError < myChunk.myErrors.size(); ++myChunkError)
+    {
+      const auto &error = myChunk.myErrors[myChunkError];
+      myEWTracker.reportError(error.myLine + myChunkLineOffset,
+                              error.myColumn, error.myError);
+    }
+
+    if (myChunk.myStuck || myChunksAdopted + 1 == myChunkStarts.size())
+    {
+      // Carry on from where the chunk stopped as if the whole file had been
+      // scanned sequentially.
+      myParallel = false;
+    }
+    else
+    {
+      adoptNextChunk();
+    }
+  }
+
+  if (! myParallel)
+  {
+    return getToken();
+  }
+
+  // Errors are reported when the token after them is, as they would be
+  // when scanning sequentially.
+  for (; myChunkError < myChunk.myErrors.size() &&
+         myChunk.myErrors[myChunkError].myTokensBefore <= myChunkToken;
+       ++myChunkError)
+  {
+    const auto &error = myChunk.myErrors[myChunkError];
+    myEWTracker.reportError(error.myLine + myChunkLineOffset, error.myColumn,
+                            error.myError);
+  }
+
+  Token token{myChunk.myTokens[myChunkToken++]};
+  token.setPosition(token.getLine() + myChunkLineOffset, token.getColumn());
   return token;
 }
 
+//*******************************************************
+// Scanner::registerDirectScanner
+//*******************************************************
+bool Scanner::registerDirectScanner(uint64_t theFingerprint,
+                                    DirectScanFunction theFunction) noexcept
+{
+  getDirectScanners()[theFingerprint] = theFunction;
+  return true;
+}
+
+//*******************************************************
+// Scanner::reportError
+//*******************************************************
+void Scanner::reportError(const std::string &theError)
+{
+  if (myChunkRecord != nullptr)
+  {
+    myChunkRecord->myErrors.push_back(
+      ChunkError{getLine(), getColumn(), theError,
+                 myChunkRecord->myTokens.size()});
+  }
+  else
+  {
+    myEWTracker.reportError(getLine(), getColumn(), theError);
+  }
+}
+
 //*******************************************************
 // Scanner::scan
 //*******************************************************
 Token Scanner::scan()
 {
-  Token token{myTokens.front()};
+  if (myLookahead.empty())
+  {
+    myLookahead.push_back(nextToken());
+  }
+
+  if (static_cast<std::size_t>(myCursor - myReleased) >= CHUNK_SIZE)
+  {
+    mySource->release(myReleased, myCursor);
+    myReleased = myCursor;
+  }
+
+  Token token{myLookahead.front()};
   // Allow so multiple calls to scan after EOF keep returning EOF.
-  if (myTokens.size() > 1)
+  if (! isEOF(token))
   {
-    myTokens.pop_front();
+    myLookahead.pop_front();
   }
 
   if (myPrintTokens)
@@ -227,3 +550,4 @@ Token Scanner::scan()
   }
   return token;
 }
+
@@ -8,19 +8,37 @@
  * @author Michael Albers
  */
 
+#include <cstddef>
 #include <cstdint>
-#include <fstream>
-#include <string>
 #include <deque>
+#include <future>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "ScannerTable.h"
+#include "SourceBuffer.h"
 #include "Token.h"
 
 class ErrorWarningTracker;
 class ScannerTable;
 
 /**
- * Scans an input file returning all of the tokens contained therein.
+ * Scans an input file returning all of the tokens contained therein. Tokens
+ * are scanned on demand, so only a small lookahead buffer of tokens is held
+ * at any one time regardless of the size of the input file. The memory of
+ * the file itself is given back (see SourceBuffer::release) every
+ * CHUNK_SIZE bytes behind the scan.
+ *
+ * Files of PARALLEL_THRESHOLD bytes or more (or any file, given a chunk
+ * size) are split at line boundaries into chunks which are scanned ahead on
+ * other threads, a few chunks at a time. Each chunk is scanned
+ * speculatively from ScannerTable::START_STATE at its first line. Its
+ * tokens are only used from the point where the scan of the chunk before
+ * it stopped, and only if the chunk's own scan started a token there too;
+ * otherwise (e.g. inside a token spanning lines) the chunk is rescanned
+ * from that point.
  */
 class Scanner
 {
@@ -29,6 +47,37 @@ class Scanner
   // ************************************************************
   public:
 
+  /**
+   * Direct coded scanner for one scanner table, generated by
+   * ScannerGenerator. Starting in ScannerTable::START_STATE at theCursor it
+   * takes every Move* action of the table itself, appending to theToken as
+   * the table would. It stops on the first character for which the table
+   * gives an Error or Halt* action, storing that entry in theEntry without
+   * consuming the character, or at theEnd, leaving theEntry alone.
+   *
+   * @param theCursor
+   *          first character to scan
+   * @param theEnd
+   *          end of the source, where SourceBuffer::SENTINEL is stored
+   * @param theToken
+   *          token being scanned
+   * @param theEntry
+   *          OUT parameter - entry for the character the scan stopped on
+   * @return character the scan stopped on
+   */
+  using DirectScanFunction = const char* (*)(
+    const char *theCursor, const char *theEnd, Token &theToken,
+    ScannerTable::PackedEntry &theEntry);
+
+  /** Nominal size of the chunks a large file is scanned in, in bytes. */
+  static constexpr std::size_t CHUNK_SIZE = 4 << 20;
+
+  /**
+   * Files of at least this many bytes are scanned in parallel, unless a
+   * chunk size is given to the constructor.
+   */
+  static constexpr std::size_t PARALLEL_THRESHOLD = 4 * CHUNK_SIZE;
+
   /**
    * Default constructor.
    */
@@ -37,46 +86,57 @@ class Scanner
   /**
    * Copy constructor
    */
-  Scanner(const Scanner &) = default;
+  Scanner(const Scanner &) = delete;
 
   /**
    * Move constructor
    */
-  Scanner(Scanner &&) = default;
+  Scanner(Scanner &&) = delete;
 
   /**
    * constructor
    *
    * @param theFile
-   *          file to scan/tokenize
+   *          file to scan/tokenize, SourceBuffer::STANDARD_INPUT for
+   *          standard input
    * @param theScannerTable
    *          table which drives the scan
    * @param theEWTracker
    *          error/warning tracker
    * @param thePrintTokens
    *          if true, tokens will be printed as they are scanned
+   * @param theUseDirectScanner
+   *          if true, scan with the registered direct scanner matching
+   *          theScannerTable, if there is one, rather than the table
+   * @param theChunkSize
+   *          if not 0, scan the file in parallel in chunks of this many
+   *          bytes whatever its size and the number of processors; if 0,
+   *          only files of at least PARALLEL_THRESHOLD bytes are, in
+   *          CHUNK_SIZE chunks, when there is more than one processor
    * @throw std::runtime_error
    *          on error opening input file
    */
   Scanner(const std::string &theFile,
           ScannerTable &theScannerTable,
           ErrorWarningTracker &theEWTracker,
-          bool thePrintTokens);
+          bool thePrintTokens,
+          bool theUseDirectScanner = true,
+          std::size_t theChunkSize = 0);
 
   /**
    * Destructor
    */
-  ~Scanner() = default;
+  ~Scanner();
 
   /**
    * Copy assignment operator
    */
-  Scanner& operator=(const Scanner &) = default;
+  Scanner& operator=(const Scanner &) = delete;
 
   /**
    * Move assignment operator
    */
-  Scanner& operator=(Scanner &&) = default;
+  Scanner& operator=(Scanner &&) = delete;
 
   /**
    * Returns the current column of the scan (this will be the column
@@ -94,11 +154,27 @@ class Scanner
   uint32_t getLine() const noexcept;
 
   /**
-   * Returns the tokens which have not yet been scanned.
+   * Returns the tokens which have not yet been scanned. This scans the rest
+   * of the input file into the lookahead buffer, so should only be used when
+   * printing the parse/code generation.
    *
    * @return list of tokens
    */
-  std::deque<Token> getRemainingTokens() const noexcept;
+  std::deque<Token> getRemainingTokens() noexcept;
+
+  /**
+   * Registers a generated direct scanner. Called during static
+   * initialization by the generated code.
+   *
+   * @param theFingerprint
+   *          ScannerTable::getFingerprint of the table the scanner was
+   *          generated from
+   * @param theFunction
+   *          generated scan function
+   * @return true
+   */
+  static bool registerDirectScanner(uint64_t theFingerprint,
+                                    DirectScanFunction theFunction) noexcept;
 
   /**
    * Consumes and returns the next token in the source file.
@@ -130,6 +206,105 @@ class Scanner
   // ************************************************************
   private:
 
+  /**
+   * Error found while scanning a chunk, reported when the token after it is
+   * returned.
+   */
+  class ChunkError
+  {
+    public:
+
+    /** Line of the error, relative to the chunk (see ChunkResult). */
+    uint32_t myLine;
+
+    /** Column of the error. */
+    uint32_t myColumn;
+
+    /** Error message. */
+    std::string myError;
+
+    /** Number of the chunk's tokens scanned before the error. */
+    std::size_t myTokensBefore;
+  };
+
+  /**
+   * Position in a chunk at which getToken started scanning a token, in
+   * ScannerTable::START_STATE with an empty token.
+   */
+  class SyncPoint
+  {
+    public:
+
+    /** Position in the source. */
+    const char *myCursor;
+
+    /** Number of the chunk's tokens scanned before this point. */
+    std::size_t myTokensBefore;
+
+    /** Number of the chunk's errors found before this point. */
+    std::size_t myErrorsBefore;
+  };
+
+  /**
+   * Results of scanning one chunk. Line numbers are relative to the line
+   * the chunk's scan started on.
+   */
+  class ChunkResult
+  {
+    public:
+
+    /** Position after the last token, where the next chunk takes over. */
+    const char *myEnd = nullptr;
+
+    /** Column at myEnd. */
+    uint32_t myEndColumn = 1;
+
+    /** Line at myEnd. */
+    uint32_t myEndLine = 1;
+
+    /** Errors, in the order found. */
+    std::vector<ChunkError> myErrors;
+
+    /** Number of new lines in the chunk's nominal range. */
+    uint32_t myNewLines = 0;
+
+    /**
+     * True if the scan stopped on a character it could not move past (see
+     * getToken). Scanning then continues sequentially from myEnd.
+     */
+    bool myStuck = false;
+
+    /** Start of every token scanned, in source order. */
+    std::vector<SyncPoint> mySyncPoints;
+
+    /** Tokens scanned. */
+    std::vector<Token> myTokens;
+  };
+
+  /**
+   * Constructor for the scanner of one chunk of theParent's source. Errors
+   * are recorded in theResult instead of being reported.
+   *
+   * @param theParent
+   *          scanner of the whole file
+   * @param theResult
+   *          where to record errors and sync points
+   * @param theCursor
+   *          first character to scan
+   * @param theLine
+   *          line of theCursor
+   * @param theColumn
+   *          column of theCursor
+   */
+  Scanner(const Scanner &theParent, ChunkResult &theResult,
+          const char *theCursor, uint32_t theLine, uint32_t theColumn);
+
+  /**
+   * Adopts the results of the next chunk, rescanning it if its speculative
+   * scan does not line up with the end of the previous chunk.
+   */
+  void adoptNextChunk();
+
   /**
    * Get the next token from the file.
    *
@@ -137,29 +312,165 @@ class Scanner
    */
   Token getToken();
 
+  /**
+   * Returns the generated direct scanners, by table fingerprint.
+   *
+   * @return direct scanners
+   */
+  static std::map<uint64_t, DirectScanFunction>& getDirectScanners() noexcept;
+
+  /**
+   * Starts scanning chunks ahead on other threads until the number of
+   * chunks in flight reaches the number of hardware threads.
+   */
+  void launchChunks();
+
+  /**
+   * Moves the cursor forward to the given character, updating the line and
+   * column as consumeChar would.
+   *
+   * @param theCursor
+   *          new cursor position, at or after the current one
+   */
+  void moveCursor(const char *theCursor) noexcept;
+
+  /**
+   * Returns the next token, scanning it or taking it from the chunk
+   * results.
+   *
+   * @return next token
+   */
+  Token nextToken();
+
+  /**
+   * Reports the given error at the current position, or records it in the
+   * chunk results when scanning a chunk.
+   *
+   * @param theError
+   *          error message
+   */
+  void reportError(const std::string &theError);
+
+  /**
+   * Scans the tokens starting from theBegin up to the first token starting
+   * at or after theEnd (or to the end of the file for the last chunk).
+   *
+   * @param theBegin
+   *          first character to scan
+   * @param theEnd
+   *          nominal end of the chunk
+   * @param theLine
+   *          line of theBegin
+   * @param theColumn
+   *          column of theBegin
+   * @param theLastChunk
+   *          true for the last chunk of the file
+   * @return chunk results
+   */
+  ChunkResult scanChunk(const char *theBegin, const char *theEnd,
+                        uint32_t theLine, uint32_t theColumn,
+                        bool theLastChunk) const;
+
+  /**
+   * Skips over the run of characters on which the given state moves back to
+   * itself, as if each had been consumed through the scanner table.
+   *
+   * @param theState
+   *          current state
+   * @param theToken
+   *          token being scanned
+   */
+  void skipRun(ScannerTable::State theState, Token &theToken);
+
+  /**
+   * Returns true if the whole file has been scanned. The character at the
+   * end is SourceBuffer::SENTINEL, which can also be in the file, so this
+   * compares positions.
+   *
+   * @return true at the end of the file
+   */
+  bool isAtEnd() const noexcept;
+
+  /**
+   * Returns true if the given token is the EOF token.
+   *
+   * @param theToken
+   *          token to check
+   * @return true if theToken is the EOF token
+   */
+  bool isEOF(const Token &theToken) const noexcept;
+
+  /** Results of the chunk being returned, see nextToken. */
+  ChunkResult myChunk;
+
+  /** Next error of myChunk to report. */
+  std::size_t myChunkError = 0;
+
+  /** Added to myChunk's line numbers to make them absolute. */
+  uint32_t myChunkLineOffset = 0;
+
+  /** Next token of myChunk to return. */
+  std::size_t myChunkToken = 0;
+
+  /** Chunks being scanned on other threads, in order. */
+  std::deque<std::future<ChunkResult>> myChunkScans;
+
+  /**
+   * Start of each chunk followed by the end of the file, empty when the
+   * file is scanned sequentially.
+   */
+  std::vector<const char*> myChunkStarts;
+
+  /** Number of chunks adopted by adoptNextChunk. */
+  uint32_t myChunksAdopted = 0;
+
+  /** Number of chunks passed to launchChunks. */
+  uint32_t myChunksLaunched = 0;
+
   /** Current column being read. */
   uint32_t myColumn = 1;
 
+  /** Current character in mySource. */
+  const char *myCursor;
+
+  /** Generated scanner for myScannerTable, null to use the table. */
+  DirectScanFunction myDirectScanner = nullptr;
+
   /** Error/Warning tracker */
   ErrorWarningTracker &myEWTracker;
 
   /** Input file name */
   std::string myFile;
 
-  /** File input */
-  std::ifstream myInputStream;
+  /** File contents, shared with the chunk scanners. */
+  std::shared_ptr<const SourceBuffer> mySource;
 
   /** Current line number. */
   uint32_t myLine = 1;
 
+  /** Start of the part of mySource not yet released, see scan. */
+  const char *myReleased = nullptr;
+
+  /** Line the next chunk to be adopted starts on. */
+  uint32_t myNextChunkLine = 1;
+
+  /** Where errors and sync points are recorded in a chunk scanner. */
+  ChunkResult *myChunkRecord = nullptr;
+
+  /** True while tokens come from chunk results, see nextToken. */
+  bool myParallel = false;
+
   /** Should tokens be printed as they are scanned? */
   const bool myPrintTokens;
 
   /** Scanner driver table */
   ScannerTable &myScannerTable;
 
-  /** All tokens from the file. */
-  std::deque<Token> myTokens;
+  /**
+   * Tokens scanned but not yet consumed by 'scan'. Once the end of the file
+   * has been reached the EOF token is left in here.
+   */
+  std::deque<Token> myLookahead;
 };
 
 #endif
@@ -0,0 +1,255 @@
+/**
+ * @file ScannerGenerator.cpp
+ * @brief Implementation of ScannerGenerator class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <climits>
+#include <deque>
+#include <iomanip>
+#include <map>
+#include <vector>
+
+#include "ScannerGenerator.h"
+#include "ScannerTable.h"
+#include "SourceBuffer.h"
+
+namespace
+{
+  /**
+   * Character which is both in SourceBuffer::SENTINEL, stored after the
+   * file, and an ordinary character of the file.
+   */
+  constexpr uint32_t SENTINEL =
+    static_cast<unsigned char>(SourceBuffer::SENTINEL);
+
+  /**
+   * Returns the source code name of the given action.
+   *
+   * @param theAction
+   *          action
+   * @return enumerator name
+   */
+  const char* getActionName(ScannerTable::Action theAction) noexcept
+  {
+    switch (theAction)
+    {
+      case ScannerTable::Action::Error:
+        return "Error";
+      case ScannerTable::Action::MoveAppend:
+        return "MoveAppend";
+      case ScannerTable::Action::MoveNoAppend:
+        return "MoveNoAppend";
+      case ScannerTable::Action::HaltAppend:
+        return "HaltAppend";
+      case ScannerTable::Action::HaltNoAppend:
+        return "HaltNoAppend";
+      case ScannerTable::Action::HaltReuse:
+        return "HaltReuse";
+    }
+    return "Error";
+  }
+
+  /**
+   * Returns true if the given entry is a Move* entry.
+   *
+   * @param theEntry
+   *          entry to check
+   * @return true for a move
+   */
+  bool isMove(ScannerTable::PackedEntry theEntry) noexcept
+  {
+    return theEntry.getAction() == ScannerTable::Action::MoveAppend ||
+      theEntry.getAction() == ScannerTable::Action::MoveNoAppend;
+  }
+
+  /**
+   * Writes the code taking the given entry, for a case of a state's switch.
+   *
+   * @param theOS
+   *          stream to write to
+   * @param theEntry
+   *          entry to take
+   */
+  void generateAction(std::ostream &theOS,
+                      ScannerTable::PackedEntry theEntry)
+  {
+    switch (theEntry.getAction())
+    {
+      case ScannerTable::Action::MoveAppend:
+        theOS << "        theToken.append(cursor);" << std::endl;
+        // Fall through
+      case ScannerTable::Action::MoveNoAppend:
+        theOS << "        ++cursor;" << std::endl
+              << "        goto state" << theEntry.getNextState() << ";"
+              << std::endl;
+        break;
+
+      default:
+        theOS << "        theEntry = ScannerTable::PackedEntry(" << std::endl
+              << "          ScannerTable::Action::"
+              << getActionName(theEntry.getAction()) << ", "
+              << theEntry.getNextState() << ", " << theEntry.getTerminalId()
+              << ");" << std::endl
+              << "        return cursor;" << std::endl;
+        break;
+    }
+  }
+}
+
+//*******************************************************
+// ScannerGenerator::ScannerGenerator
+//*******************************************************
+ScannerGenerator::ScannerGenerator(const ScannerTable &theScannerTable,
+                                   const std::string &theGrammarFile) :
+  myGrammarFile(theGrammarFile),
+  myScannerTable(theScannerTable)
+{
+}
+
+//*******************************************************
+// ScannerGenerator::generate
+//*******************************************************
+void ScannerGenerator::generate(std::ostream &theOS) const
+{
+  // Only states reachable from the start state get code, and only states
+  // which are moved to get a label (the start state is entered at the top).
+  std::vector<bool> reachable(myScannerTable.getNumberStates(), false);
+  std::vector<bool> movedTo(myScannerTable.getNumberStates(), false);
+  std::deque<uint32_t> toVisit{ScannerTable::START_STATE};
+  reachable[ScannerTable::START_STATE] = true;
+  while (! toVisit.empty())
+  {
+    auto state = toVisit.front();
+    toVisit.pop_front();
+    for (uint32_t character = 0; character <= UCHAR_MAX; ++character)
+    {
+      auto entry = myScannerTable.getEntry(state,
+                                           static_cast<char>(character));
+      if (isMove(entry))
+      {
+        movedTo[entry.getNextState()] = true;
+      }
+      if (isMove(entry) && ! reachable[entry.getNextState()])
+      {
+        reachable[entry.getNextState()] = true;
+        toVisit.push_back(entry.getNextState());
+      }
+    }
+  }
+
+  theOS << "/**" << std::endl
+        << " * @file" << std::endl
+        << " * @brief Direct coded scanner for " << myGrammarFile << std::endl
+        << " *" << std::endl
+        << " * Generated by ScannerGenerator, do not edit." << std::endl
+        << " */" << std::endl
+        << std::endl
+        << "#include \"Scanner.h\"" << std::endl
+        << "#include \"ScannerTable.h\"" << std::endl
+        << "#include \"Token.h\"" << std::endl
+        << std::endl
+        << "namespace" << std::endl
+        << "{" << std::endl
+        << "  const char* scan(const char *theCursor, const char *theEnd,"
+        << std::endl
+        << "                   Token &theToken,"
+        << " ScannerTable::PackedEntry &theEntry)" << std::endl
+        << "  {" << std::endl
+        << "    const char *cursor = theCursor;" << std::endl;
+
+  for (uint32_t state = 0; state < reachable.size(); ++state)
+  {
+    if (reachable[state])
+    {
+      generateState(theOS, state, movedTo[state]);
+    }
+  }
+
+  theOS << "  }" << std::endl
+        << std::endl
+        << "  const bool registered = Scanner::registerDirectScanner("
+        << std::endl
+        << "    0x" << std::hex << std::setw(16) << std::setfill('0')
+        << myScannerTable.getFingerprint() << std::dec << std::setfill(' ')
+        << "ull, scan);" << std::endl
+        << "}" << std::endl;
+}
+
+//*******************************************************
+// ScannerGenerator::generateState
+//*******************************************************
+void ScannerGenerator::generateState(std::ostream &theOS, uint32_t theState,
+                                     bool theLabel) const
+{
+  // Group the characters with the same entry into one set of case labels,
+  // in order of their first character. The largest group becomes the
+  // default. The sentinel gets a case of its own, which checks for the end
+  // of the file before taking its entry.
+  std::vector<std::pair<ScannerTable::PackedEntry, std::vector<uint32_t>>>
+    cases;
+  std::map<uint64_t, uint32_t> caseIndices; // Entry fields, index in cases
+  for (uint32_t character = 0; character <= UCHAR_MAX; ++character)
+  {
+    if (SENTINEL == character)
+    {
+      continue;
+    }
+    auto entry = myScannerTable.getEntry(theState,
+                                         static_cast<char>(character));
+    uint64_t key = (static_cast<uint64_t>(entry.getTerminalId()) << 32) |
+      (entry.getNextState() << 3) | static_cast<uint32_t>(entry.getAction());
+    auto caseIndex = caseIndices.find(key);
+    if (caseIndex == caseIndices.end())
+    {
+      caseIndex = caseIndices.emplace(key, cases.size()).first;
+      cases.emplace_back(entry, std::vector<uint32_t>());
+    }
+    cases[caseIndex->second].second.push_back(character);
+  }
+  auto defaultCase = std::max_element(
+    cases.begin(), cases.end(),
+    [](const decltype(cases)::value_type &theLeft,
+       const decltype(cases)::value_type &theRight)
+    {
+      return theLeft.second.size() < theRight.second.size();
+    });
+
+  theOS << std::endl;
+  if (theLabel)
+  {
+    theOS << "  state" << theState << ":" << std::endl;
+  }
+  theOS << "    switch (static_cast<unsigned char>(*cursor))" << std::endl
+        << "    {" << std::endl;
+
+  for (auto caseEntry = cases.begin(); caseEntry != cases.end(); ++caseEntry)
+  {
+    if (caseEntry == defaultCase)
+    {
+      continue;
+    }
+    const auto &characters = caseEntry->second;
+    for (auto ii = 0u; ii < characters.size(); ++ii)
+    {
+      theOS << (0 == ii % 8 ? "      " : " ")
+            << "case " << characters[ii] << ":"
+            << (7 == ii % 8 || ii + 1 == characters.size() ? "\n" : "");
+    }
+    generateAction(theOS, caseEntry->first);
+  }
+
+  theOS << "      case " << SENTINEL << ":" << std::endl
+        << "        if (theEnd == cursor)" << std::endl
+        << "        {" << std::endl
+        << "          return cursor;" << std::endl
+        << "        }" << std::endl;
+  generateAction(theOS, myScannerTable.getEntry(
+                   theState, static_cast<char>(SENTINEL)));
+
+  theOS << "      default:" << std::endl;
+  generateAction(theOS, defaultCase->first);
+  theOS << "    }" << std::endl;
+}
@@ -0,0 +1,112 @@
+#ifndef SCANNERGENERATOR_H
+#define SCANNERGENERATOR_H
+
+/**
+ * @file ScannerGenerator.h
+ * @brief Generates a direct coded scanner from a scanner table.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+class ScannerTable;
+
+/**
+ * Writes the C++ source of a direct coded scanner (see
+ * Scanner::DirectScanFunction) for a scanner table. Each state of the table
+ * becomes a label with a switch on the current character, so the character
+ * classes and states are compiled in rather than looked up. The generated
+ * code registers itself with Scanner under the table's fingerprint, so
+ * linking it in is all that is needed for Scanner to use it.
+ */
+class ScannerGenerator
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  ScannerGenerator() = delete;
+
+  /**
+   * Copy constructor
+   */
+  ScannerGenerator(const ScannerGenerator&) = default;
+
+  /**
+   * Move constructor
+   */
+  ScannerGenerator(ScannerGenerator&&) = default;
+
+  /**
+   * Constructor.
+   *
+   * @param theScannerTable
+   *          finalized scanner table to generate the scanner from
+   * @param theGrammarFile
+   *          grammar file the table was read from, for comments in the
+   *          generated code
+   */
+  ScannerGenerator(const ScannerTable &theScannerTable,
+                   const std::string &theGrammarFile);
+
+  /**
+   * Destructor
+   */
+  ~ScannerGenerator() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  ScannerGenerator& operator=(const ScannerGenerator&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  ScannerGenerator& operator=(ScannerGenerator&&) = delete;
+
+  /**
+   * Writes the generated scanner source.
+   *
+   * @param theOS
+   *          stream to write to
+   */
+  void generate(std::ostream &theOS) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Writes the code for one state.
+   *
+   * @param theOS
+   *          stream to write to
+   * @param theState
+   *          state to write
+   * @param theLabel
+   *          true if other states move to this state, so it needs a label
+   */
+  void generateState(std::ostream &theOS, uint32_t theState,
+                     bool theLabel) const;
+
+  /** Grammar file the table was read from. */
+  const std::string myGrammarFile;
+
+  /** Table to generate the scanner from. */
+  const ScannerTable &myScannerTable;
+};
+
+#endif
@@ -8,21 +8,86 @@
 #include <algorithm>
 #include <cctype>
 #include <climits>
+#include <deque>
+#include <map>
 #include <stdexcept>
 #include <string>
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
 #include "ScannerTable.h"
+#include "SourceBuffer.h"
 #include "TerminalSymbol.h"
 
 
 constexpr TerminalSymbol::Id ScannerTable::NO_TERMINAL;
 constexpr TerminalSymbol::Id ScannerTable::EOF_SYMBOL;
+constexpr ScannerTable::State ScannerTable::PackedEntry::MAX_STATE;
+constexpr TerminalSymbol::Id ScannerTable::PackedEntry::MAX_TERMINAL_ID;
+constexpr uint32_t ScannerTable::Run::MAX_RANGES;
+
+namespace
+{
+  /**
+   * Hashes the given text, ignoring case (64 bit FNV-1a over the lower case
+   * characters). FNV's high bits, which pick a word's bucket, barely change
+   * between similar short words, so the result is mixed to spread them.
+   *
+   * @param theText
+   *          text to hash
+   * @param theLength
+   *          length of theText
+   * @return hash value
+   */
+  inline uint64_t hashReservedWord(const char *theText,
+                                   uint32_t theLength) noexcept
+  {
+    uint64_t hash = 0xcbf29ce484222325ull;
+    for (uint32_t ii = 0; ii < theLength; ++ii)
+    {
+      hash ^= static_cast<unsigned char>(std::tolower(
+                static_cast<unsigned char>(theText[ii])));
+      hash *= 0x100000001b3ull;
+    }
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdull;
+    hash ^= hash >> 33;
+    return hash;
+  }
+
+  /**
+   * Mixes a word's hash with its bucket's displacement to give its slot in
+   * the reserved word table.
+   *
+   * @param theHash
+   *          value from hashReservedWord
+   * @param theDisplacement
+   *          displacement of the word's bucket
+   * @param theNumberSlots
+   *          size of the table
+   * @return slot
+   */
+  inline uint32_t reservedWordSlot(uint64_t theHash, uint32_t theDisplacement,
+                                   uint32_t theNumberSlots) noexcept
+  {
+    uint64_t mix = theHash ^ (theDisplacement * 0x9e3779b97f4a7c15ull);
+    mix ^= mix >> 33;
+    mix *= 0xff51afd7ed558ccdull;
+    mix ^= mix >> 33;
+    mix *= 0xc4ceb9fe1a85ec53ull;
+    mix ^= mix >> 33;
+    return mix % theNumberSlots;
+  }
+}
 
 //*******************************************************
 // ScannerTable::ScannerTable
 //*******************************************************
 ScannerTable::ScannerTable()
 {
+  myColumnMap.fill(0);
   addTerminal(std::make_shared<TerminalSymbol>("$", EOF_SYMBOL, ""));
   addTerminal(std::make_shared<TerminalSymbol>("NoTerminal", NO_TERMINAL, ""));
 }
@@ -40,8 +105,6 @@ void ScannerTable::addColumn(const std::string &theCharacterClass) noexcept
 //*******************************************************
 void ScannerTable::addTerminal(std::shared_ptr<Symbol> theTerminal) noexcept
 {
-  myTerminals.insert(theTerminal);
-
   TerminalSymbol *terminal = dynamic_cast<TerminalSymbol*>(theTerminal.get());
   myTerminalIdMap[terminal->getId()] = theTerminal;
 
@@ -69,124 +132,990 @@ void ScannerTable::addTableEntry(State theState, uint32_t theColumn,
   myTable[theState][theColumn] = theEntry;
 }
 
+//*******************************************************
+// ScannerTable::buildRuns
+//*******************************************************
+void ScannerTable::buildRuns() noexcept
+{
+  myRuns.assign(myTables.myStates, Run());
+  for (State state = 0; state < myTables.myStates; ++state)
+  {
+    // A state could loop on some characters appending them and on others
+    // not; the run takes whichever action covers more characters.
+    // SourceBuffer::SENTINEL is left out so that every run stops at the end
+    // of the file; the table handles the character when it is in the file.
+    static constexpr uint32_t RUN_END =
+      static_cast<unsigned char>(SourceBuffer::SENTINEL);
+    std::array<bool, RUN_END> inRun[2];
+    uint32_t runSize[2] = {0, 0};
+    for (uint32_t character = 0; character < RUN_END; ++character)
+    {
+      auto entry = getEntry(state, static_cast<char>(character));
+      bool append = (entry.getAction() == Action::MoveAppend);
+      bool selfLoop = (append || entry.getAction() == Action::MoveNoAppend) &&
+        entry.getNextState() == state;
+      inRun[0][character] = selfLoop && ! append;
+      inRun[1][character] = selfLoop && append;
+      runSize[append] += selfLoop;
+    }
+
+    bool append = runSize[1] > runSize[0];
+    if (0 == runSize[append])
+    {
+      continue;
+    }
+
+    Run run;
+    run.myAppend = append;
+    for (uint32_t character = 0; character < RUN_END; ++character)
+    {
+      if (! inRun[append][character])
+      {
+        continue;
+      }
+
+      uint32_t last = character;
+      while (last + 1 < RUN_END && inRun[append][last + 1])
+      {
+        ++last;
+      }
+
+      if (Run::MAX_RANGES == run.myNumberRanges)
+      {
+        // Too scattered to be worth it, the table handles this state.
+        run.myNumberRanges = 0;
+        break;
+      }
+      run.myLow[run.myNumberRanges] = character;
+      run.mySpan[run.myNumberRanges] = last - character;
+      ++run.myNumberRanges;
+      character = last;
+    }
+
+    myRuns[state] = run;
+  }
+}
+
+//*******************************************************
+// ScannerTable::buildReservedWordHash
+//*******************************************************
+void ScannerTable::buildReservedWordHash()
+{
+  // Hash and displace: every word hashes to a bucket, then the buckets are
+  // placed largest first, each searching for a displacement which moves all
+  // of its words into free slots. There are as many slots as words.
+  uint32_t numberWords = myReservedWords.size();
+  myReservedWordDisplacements.assign(numberWords, 0);
+  myReservedWordSlots.assign(numberWords, ReservedWord{nullptr, 0, 0});
+  myTables.myReservedWordMinLength = UINT32_MAX;
+  myTables.myReservedWordMaxLength = 0;
+  if (0 == numberWords)
+  {
+    return;
+  }
+
+  std::vector<std::vector<std::pair<uint64_t, const ReservedWord*>>>
+    buckets(numberWords);
+  std::vector<ReservedWord> words;
+  words.reserve(numberWords);
+  for (const auto &reservedWord : myReservedWords)
+  {
+    uint32_t length = reservedWord.first.size();
+    words.push_back({reservedWord.first.data(), length,
+                     reservedWord.second});
+    myTables.myReservedWordMinLength =
+      std::min(myTables.myReservedWordMinLength, length);
+    myTables.myReservedWordMaxLength =
+      std::max(myTables.myReservedWordMaxLength, length);
+  }
+  for (const auto &word : words)
+  {
+    uint64_t hash = hashReservedWord(word.myWord, word.myLength);
+    buckets[(hash >> 32) % numberWords].emplace_back(hash, &word);
+  }
+
+  std::vector<uint32_t> bucketOrder(numberWords);
+  for (uint32_t ii = 0; ii < numberWords; ++ii)
+  {
+    bucketOrder[ii] = ii;
+  }
+  std::stable_sort(bucketOrder.begin(), bucketOrder.end(),
+                   [&](uint32_t theLeft, uint32_t theRight)
+                   {
+                     return buckets[theLeft].size() >
+                       buckets[theRight].size();
+                   });
+
+  static constexpr uint32_t MAX_DISPLACEMENT = 1 << 20;
+  std::vector<bool> used(numberWords, false);
+  std::vector<uint32_t> slots;
+  for (auto bucketNumber : bucketOrder)
+  {
+    const auto &bucket = buckets[bucketNumber];
+    if (bucket.empty())
+    {
+      break;
+    }
+
+    uint32_t displacement = 0;
+    for (; displacement < MAX_DISPLACEMENT; ++displacement)
+    {
+      slots.clear();
+      for (const auto &entry : bucket)
+      {
+        auto slot = reservedWordSlot(entry.first, displacement, numberWords);
+        if (used[slot] ||
+            std::find(slots.begin(), slots.end(), slot) != slots.end())
+        {
+          break;
+        }
+        slots.push_back(slot);
+      }
+      if (slots.size() == bucket.size())
+      {
+        break;
+      }
+    }
+
+    if (MAX_DISPLACEMENT == displacement)
+    {
+      throw std::runtime_error(
+        "Unable to build a perfect hash of the reserved words.");
+    }
+
+    myReservedWordDisplacements[bucketNumber] = displacement;
+    for (auto ii = 0u; ii < bucket.size(); ++ii)
+    {
+      used[slots[ii]] = true;
+      myReservedWordSlots[slots[ii]] = *bucket[ii].second;
+    }
+  }
+}
+
+//*******************************************************
+// ScannerTable::buildReservedWordTerminals
+//*******************************************************
+void ScannerTable::buildReservedWordTerminals() noexcept
+{
+  myReservedWordTerminals.assign(myTerminalsById.size(), 0);
+  auto markTerminal = [this](const PackedEntry &theEntry)
+  {
+    if (theEntry.getTerminalId() < myReservedWordTerminals.size())
+    {
+      myReservedWordTerminals[theEntry.getTerminalId()] = 1;
+    }
+  };
+
+  // Reserved words match ignoring case, so follow the states reached on
+  // the lower and upper case of each character together.
+  std::vector<bool> inStates(myTables.myStates);
+  std::vector<bool> outStates(myTables.myStates);
+  for (const auto &reservedWord : myReservedWords)
+  {
+    const auto &word = reservedWord.first;
+    std::fill(inStates.begin(), inStates.end(), false);
+    inStates[START_STATE] = true;
+    for (auto ii = 0u; ii < word.size(); ++ii)
+    {
+      auto character = static_cast<unsigned char>(word[ii]);
+      const char cases[] = {static_cast<char>(std::tolower(character)),
+                            static_cast<char>(std::toupper(character))};
+      std::fill(outStates.begin(), outStates.end(), false);
+      for (State state = 0; state < myTables.myStates; ++state)
+      {
+        if (! inStates[state])
+        {
+          continue;
+        }
+        for (auto caseCharacter : cases)
+        {
+          auto entry = getEntry(state, caseCharacter);
+          if (Action::MoveAppend == entry.getAction())
+          {
+            outStates[entry.getNextState()] = true;
+          }
+          else if (Action::HaltAppend == entry.getAction() &&
+                   ii + 1 == word.size())
+          {
+            markTerminal(entry);
+          }
+        }
+      }
+      inStates.swap(outStates);
+    }
+
+    // Having appended the whole word, the token halts on whatever follows
+    // without appending it.
+    for (State state = 0; state < myTables.myStates; ++state)
+    {
+      if (! inStates[state])
+      {
+        continue;
+      }
+      for (auto ii = 0u; ii < myColumnMap.size(); ++ii)
+      {
+        auto entry = getEntry(state, static_cast<char>(ii));
+        if (Action::HaltNoAppend == entry.getAction() ||
+            Action::HaltReuse == entry.getAction())
+        {
+          markTerminal(entry);
+        }
+      }
+    }
+  }
+}
+
 //*******************************************************
 // ScannerTable::checkExceptions
 //*******************************************************
 TerminalSymbol::Id ScannerTable::checkExceptions(
   TerminalSymbol::Id theTerminalId,
-  std::string theTokenString) const noexcept
+  const std::string &theTokenString) const noexcept
 {
-  std::transform(theTokenString.begin(), theTokenString.end(),
-                 theTokenString.begin(), ::tolower);
+  if (theTerminalId < myTables.myNumberTerminalIds &&
+      myTables.myReservedWordTerminals[theTerminalId])
+  {
+    findReservedWord(theTokenString.data(), theTokenString.size(),
+                     theTerminalId);
+  }
+  return theTerminalId;
+}
 
-  try
+//*******************************************************
+// ScannerTable::finalize
+//*******************************************************
+void ScannerTable::finalize()
+{
+  // The first column whose character class matches the character wins, so
+  // "Other" must be the last column in the table.
+  for (auto ii = 0u; ii < myColumnMap.size(); ++ii)
   {
-    theTerminalId = myReservedWords.at(theTokenString);
+    unsigned char character = ii;
+
+    uint32_t column = 0;
+    for (const auto &characterClass : myColumnCharacterClasses)
+    {
+      if ((characterClass == "letter" && std::isalpha(character)) ||
+          (characterClass == "digit" && std::isdigit(character)) ||
+          (characterClass == "whitespace" &&
+           (' ' == character || '\t' == character)) ||
+          (characterClass == "EOL" && '\n' == character) ||
+          (static_cast<char>(character) == characterClass[0]) ||
+          (characterClass == "Other")) // Must be last in the condition
+      {
+        break;
+      }
+      ++column;
+    }
+
+    myColumnMap[ii] = column;
   }
-  catch(...){}
 
-  return theTerminalId;
+  // Freeze the table. Validating every entry here is what allows getEntry
+  // to do no checking at all.
+  myTables.myColumns = myColumnCharacterClasses.size() + 1;
+  myFrozenTable.assign(myTable.size() * myTables.myColumns, PackedEntry());
+  for (State state = 0; state < myTable.size(); ++state)
+  {
+    const auto &row = myTable[state];
+    for (uint32_t column = 0; column < row.size(); ++column)
+    {
+      Entry entry{row[column]};
+      bool isMove = (entry.myAction == Action::MoveAppend ||
+                     entry.myAction == Action::MoveNoAppend);
+      if (isMove && entry.myNextState >= myTable.size())
+      {
+        throw std::runtime_error(
+          "Scanner table state " + std::to_string(state) + " moves to " +
+          "undefined state " + std::to_string(entry.myNextState));
+      }
+      if (! isMove)
+      {
+        entry.myNextState = START_STATE;
+      }
+
+      if (entry.myNextState > PackedEntry::MAX_STATE ||
+          entry.myTerminalId > PackedEntry::MAX_TERMINAL_ID)
+      {
+        throw std::runtime_error(
+          "Scanner table entry too large for packing, state " +
+          std::to_string(state) + ", column " + std::to_string(column));
+      }
+
+      myFrozenTable[state * myTables.myColumns + column] = PackedEntry(entry);
+    }
+  }
+  myTables.myStates = myTable.size();
+
+  myTables.myOriginalColumns = myColumnCharacterClasses.size();
+  myTables.myOriginalStates = myTables.myStates;
+  minimize();
+
+  // The rest is built from the minimized table through getEntry.
+  useOwnTables();
+  indexTerminals();
+  buildRuns();
+  buildReservedWordHash();
+  buildReservedWordTerminals();
+  useOwnTables();
+
+  // FNV-1a over the entry of every state/character pair.
+  myTables.myFingerprint = 0xcbf29ce484222325ull;
+  auto addToFingerprint = [this](uint32_t theValue)
+  {
+    for (auto byte = 0u; byte < sizeof(theValue); ++byte)
+    {
+      myTables.myFingerprint ^= (theValue >> (byte * 8)) & 0xFF;
+      myTables.myFingerprint *= 0x100000001b3ull;
+    }
+  };
+  addToFingerprint(myTables.myStates);
+  for (State state = 0; state < myTables.myStates; ++state)
+  {
+    for (auto ii = 0u; ii < myColumnMap.size(); ++ii)
+    {
+      auto entry = getEntry(state, static_cast<char>(ii));
+      addToFingerprint(static_cast<uint32_t>(entry.getAction()));
+      addToFingerprint(entry.getNextState());
+      addToFingerprint(entry.getTerminalId());
+    }
+  }
 }
 
 //*******************************************************
-// ScannerTable::getAction
+// ScannerTable::findReservedWord
 //*******************************************************
-ScannerTable::Action ScannerTable::getAction(State theCurrentState,
-                                             char theCharacter) const
+bool ScannerTable::findReservedWord(const char *theText, uint32_t theLength,
+                                    TerminalSymbol::Id &theTerminalId)
+  const noexcept
 {
-  validateState(theCurrentState);
-  auto column = getColumn(theCharacter);
+  if (theLength < myTables.myReservedWordMinLength ||
+      theLength > myTables.myReservedWordMaxLength)
+  {
+    return false;
+  }
+
+  uint32_t numberSlots = myTables.myNumberReservedWords;
+  uint64_t hash = hashReservedWord(theText, theLength);
+  const auto &slot = myTables.myReservedWordSlots[
+    reservedWordSlot(hash,
+                     myTables.myReservedWordDisplacements[(hash >> 32) %
+                                                          numberSlots],
+                     numberSlots)];
+
+  // The hash only says which word the text could be, so compare them.
+  if (slot.myLength != theLength)
+  {
+    return false;
+  }
+  for (uint32_t ii = 0; ii < theLength; ++ii)
+  {
+    if (std::tolower(static_cast<unsigned char>(theText[ii])) !=
+        slot.myWord[ii])
+    {
+      return false;
+    }
+  }
 
-  return myTable[theCurrentState][column].myAction;
+  theTerminalId = slot.myTerminalId;
+  return true;
 }
 
 //*******************************************************
-// ScannerTable::getColumn
+// ScannerTable::findRunEnd
 //*******************************************************
-uint32_t ScannerTable::getColumn(char theCharacter) const noexcept
+const char* ScannerTable::findRunEnd(State theState, const char *theCursor)
+  const noexcept
 {
-  uint32_t column = 0;
-  for (const auto characterClass : myColumnCharacterClasses)
+  const auto &run = myTables.myRuns[theState];
+  if (0 == run.myNumberRanges)
   {
-    if ((characterClass == "letter" && std::isalpha(theCharacter)) ||
-        (characterClass == "digit" && std::isdigit(theCharacter)) ||
-        (characterClass == "whitespace" &&
-         (' ' == theCharacter || '\t' == theCharacter)) ||
-        (characterClass == "EOL" && '\n' == theCharacter) ||
-        (theCharacter == characterClass[0]) ||
-        (characterClass == "Other")) // Must be last in the condition
+    return theCursor;
+  }
+
+#ifdef __SSE2__
+  // Aligned loads never cross into the next page, so reading the rest of
+  // the block holding the sentinel is safe. The sentinel is never in a run,
+  // which ends the loop.
+  auto offset = reinterpret_cast<uintptr_t>(theCursor) & 0xF;
+  auto block = reinterpret_cast<const __m128i*>(theCursor - offset);
+  uint32_t skipped = (1u << offset) - 1; // Characters before theCursor
+
+  __m128i low[Run::MAX_RANGES];
+  __m128i span[Run::MAX_RANGES];
+  for (uint32_t range = 0; range < run.myNumberRanges; ++range)
+  {
+    low[range] = _mm_set1_epi8(static_cast<char>(run.myLow[range]));
+    span[range] = _mm_set1_epi8(static_cast<char>(run.mySpan[range]));
+  }
+
+  while (true)
+  {
+    __m128i characters = _mm_load_si128(block);
+    __m128i inRun = _mm_setzero_si128();
+    for (uint32_t range = 0; range < run.myNumberRanges; ++range)
     {
-      break;
+      // In range if (character - low) <= span, as unsigned bytes.
+      __m128i relative = _mm_sub_epi8(characters, low[range]);
+      inRun = _mm_or_si128(
+        inRun, _mm_cmpeq_epi8(_mm_min_epu8(relative, span[range]), relative));
     }
-    ++column;
+
+    uint32_t notInRun = ~(_mm_movemask_epi8(inRun) | skipped) & 0xFFFF;
+    if (notInRun != 0)
+    {
+      return reinterpret_cast<const char*>(block) + __builtin_ctz(notInRun);
+    }
+    ++block;
+    skipped = 0;
   }
+#else
+  while (true)
+  {
+    uint8_t character = static_cast<uint8_t>(*theCursor);
+    bool inRun = false;
+    for (uint32_t range = 0; range < run.myNumberRanges; ++range)
+    {
+      inRun |= static_cast<uint8_t>(character - run.myLow[range]) <=
+        run.mySpan[range];
+    }
+    if (! inRun)
+    {
+      return theCursor;
+    }
+    ++theCursor;
+  }
+#endif
+}
+
+//*******************************************************
+// ScannerTable::getColumn
+//*******************************************************
+uint32_t ScannerTable::getColumn(char theCharacter) const noexcept
+{
+  return myTables.myColumnMap[static_cast<unsigned char>(theCharacter)];
+}
 
-  return column;
+//*******************************************************
+// ScannerTable::getEntry
+//*******************************************************
+ScannerTable::PackedEntry ScannerTable::getEntry(State theCurrentState,
+                                                 char theCharacter)
+  const noexcept
+{
+  return myTables.myEntries[theCurrentState * myTables.myColumns +
+                            getColumn(theCharacter)];
 }
 
 //*******************************************************
 // ScannerTable::getEOF
 //*******************************************************
-std::shared_ptr<Symbol> ScannerTable::getEOF() const noexcept
+const std::shared_ptr<Symbol>& ScannerTable::getEOF() const noexcept
 {
   return myTerminalIdMap.at(EOF_SYMBOL);
 }
 
 //*******************************************************
-// ScannerTable::getState
+// ScannerTable::getFingerprint
 //*******************************************************
-ScannerTable::State ScannerTable::getState(State theCurrentState,
-                                           char theCharacter) const
+uint64_t ScannerTable::getFingerprint() const noexcept
 {
-  validateState(theCurrentState);
-  auto column = getColumn(theCharacter);
+  return myTables.myFingerprint;
+}
 
-  return myTable[theCurrentState][column].myNextState;
+//*******************************************************
+// ScannerTable::getNumberStates
+//*******************************************************
+ScannerTable::State ScannerTable::getNumberStates() const noexcept
+{
+  return myTables.myStates;
 }
 
 //*******************************************************
-// ScannerTable::lookupTerminal
+// ScannerTable::getTables
 //*******************************************************
-std::shared_ptr<Symbol> ScannerTable::lookupTerminal(
-  State theCurrentState,
-  char theCharacter,
-  std::string theTokenString) const
+const ScannerTable::Tables& ScannerTable::getTables() const noexcept
 {
-  validateState(theCurrentState);
-  auto column = getColumn(theCharacter);
+  return myTables;
+}
 
-  std::shared_ptr<Symbol> terminal;
+//*******************************************************
+// ScannerTable::indexTerminals
+//*******************************************************
+void ScannerTable::indexTerminals() noexcept
+{
+  myTerminalsById.assign(myTerminalIdMap.rbegin()->first + 1, nullptr);
+  for (const auto &terminal : myTerminalIdMap)
+  {
+    myTerminalsById[terminal.first] = terminal.second.get();
+  }
+}
 
-  auto terminalId = myTable[theCurrentState][column].myTerminalId;
-  try
+//*******************************************************
+// ScannerTable::isRunAppended
+//*******************************************************
+bool ScannerTable::isRunAppended(State theState) const noexcept
+{
+  return myTables.myRuns[theState].myAppend;
+}
+
+//*******************************************************
+// ScannerTable::load
+//*******************************************************
+void ScannerTable::load(GrammarCache::Reader &theReader)
+{
+  myColumnMap = theReader.read<decltype(myColumnMap)>();
+  myTables.myOriginalColumns = theReader.read<uint32_t>();
+  myTables.myOriginalStates = theReader.read<State>();
+  myTables.myColumns = theReader.read<uint32_t>();
+  myTables.myStates = theReader.read<State>();
+  theReader.read(myFrozenTable);
+  theReader.read(myRuns);
+  myTables.myFingerprint = theReader.read<uint64_t>();
+
+  myTables.myReservedWordMinLength = theReader.read<uint32_t>();
+  myTables.myReservedWordMaxLength = theReader.read<uint32_t>();
+  theReader.read(myReservedWordDisplacements);
+  // Each slot takes at least two words, so a corrupt count runs out of
+  // payload rather than memory. The words point at the reserved words of
+  // the terminals, so must be one of them.
+  auto numberSlots = theReader.read<uint32_t>();
+  myReservedWordSlots.clear();
+  for (auto ii = 0u; ii < numberSlots; ++ii)
   {
-    terminal = myTerminalIdMap.at(terminalId);
-    std::transform(theTokenString.begin(), theTokenString.end(),
-                   theTokenString.begin(), ::tolower);
-    auto reservedWord = myReservedWords.find(theTokenString);
-    if (reservedWord != myReservedWords.end())
+    auto word = myReservedWords.find(theReader.readString());
+    auto terminalId = theReader.read<TerminalSymbol::Id>();
+    if (word == myReservedWords.end())
     {
-      terminal = myTerminalIdMap.at(reservedWord->second);
+      throw std::runtime_error{"Grammar cache is corrupt."};
     }
+    myReservedWordSlots.push_back({word->first.data(),
+                                   static_cast<uint32_t>(word->first.size()),
+                                   terminalId});
   }
-  catch (std::out_of_range &exception)
+  theReader.read(myReservedWordTerminals);
+
+  if (myFrozenTable.size() !=
+        static_cast<uint64_t>(myTables.myStates) * myTables.myColumns ||
+      myRuns.size() != myTables.myStates ||
+      myReservedWordDisplacements.size() != myReservedWordSlots.size())
   {
+    throw std::runtime_error{"Grammar cache is corrupt."};
+  }
+
+  indexTerminals();
+  useOwnTables();
+  validate();
+}
+
+//*******************************************************
+// ScannerTable::load
+//*******************************************************
+void ScannerTable::load(const Tables &theTables)
+{
+  indexTerminals();
+  myTables = theTables;
+  validate();
+}
+
+//*******************************************************
+// ScannerTable::lookupTerminal
+//*******************************************************
+const Symbol* ScannerTable::lookupTerminal(
+  TerminalSymbol::Id theTerminalId,
+  const char *theText,
+  uint32_t theLength) const noexcept
+{
+  const Symbol *terminal = nullptr;
+
+  if (theTerminalId < myTerminalsById.size() &&
+      myTerminalsById[theTerminalId] != nullptr)
+  {
+    // The reserved word terminals are as many as myTerminalsById.
+    if (myTables.myReservedWordTerminals[theTerminalId])
+    {
+      findReservedWord(theText, theLength, theTerminalId);
+    }
+    terminal = myTerminalsById[theTerminalId];
   }
 
   return terminal;
 }
 
 //*******************************************************
-// ScannerTable::validateState
+// ScannerTable::minimize
 //*******************************************************
-void ScannerTable::validateState(State theState) const
+void ScannerTable::minimize() noexcept
 {
-  if (theState >= myTable.size())
+  auto isMove = [](PackedEntry theEntry)
+  {
+    return theEntry.getAction() == Action::MoveAppend ||
+      theEntry.getAction() == Action::MoveNoAppend;
+  };
+
+  // Only columns some character maps to matter.
+  std::vector<uint32_t> columns;
   {
-    std::string error{"Illegal state, "};
-    error += std::to_string(theState) + ", must be 0 <= x < " +
-      std::to_string(myTable.size());
-    throw std::invalid_argument(error);
+    std::vector<bool> used(myTables.myColumns, false);
+    for (auto column : myColumnMap)
+    {
+      used[column] = true;
+    }
+    for (uint32_t column = 0; column < myTables.myColumns; ++column)
+    {
+      if (used[column])
+      {
+        columns.push_back(column);
+      }
+    }
+  }
+
+  auto entryAt = [this](State theState, uint32_t theColumn)
+  {
+    return myFrozenTable[theState * myTables.myColumns + theColumn];
+  };
+
+  // Reachable states, in order of their original number.
+  std::vector<bool> reachable(myTables.myStates, false);
+  std::vector<State> toVisit{START_STATE};
+  reachable[START_STATE] = true;
+  while (! toVisit.empty())
+  {
+    auto state = toVisit.back();
+    toVisit.pop_back();
+    for (auto column : columns)
+    {
+      auto entry = entryAt(state, column);
+      if (isMove(entry) && ! reachable[entry.getNextState()])
+      {
+        reachable[entry.getNextState()] = true;
+        toVisit.push_back(entry.getNextState());
+      }
+    }
+  }
+
+  // Hopcroft's algorithm. Two states start out in the same block if they
+  // take the same action on every column, halting with the same terminal.
+  // Blocks are then split until every member of a block moves into the
+  // same block on every column.
+  std::vector<uint32_t> blockOf(myTables.myStates, 0);
+  std::vector<std::vector<State>> blocks;
+  {
+    std::map<std::vector<uint32_t>, uint32_t> signatures;
+    for (State state = 0; state < myTables.myStates; ++state)
+    {
+      if (! reachable[state])
+      {
+        continue;
+      }
+
+      std::vector<uint32_t> signature;
+      for (auto column : columns)
+      {
+        auto entry = entryAt(state, column);
+        signature.push_back(static_cast<uint32_t>(entry.getAction()));
+        signature.push_back(isMove(entry) ? 0 : entry.getTerminalId());
+      }
+      auto block = signatures.emplace(signature, blocks.size()).first;
+      if (block->second == blocks.size())
+      {
+        blocks.emplace_back();
+      }
+      blockOf[state] = block->second;
+      blocks[block->second].push_back(state);
+    }
+  }
+
+  // predecessors[column index][state] = states moving to state on column
+  std::vector<std::vector<std::vector<State>>> predecessors(
+    columns.size(), std::vector<std::vector<State>>(myTables.myStates));
+  for (State state = 0; state < myTables.myStates; ++state)
+  {
+    for (auto ii = 0u; ii < columns.size() && reachable[state]; ++ii)
+    {
+      auto entry = entryAt(state, columns[ii]);
+      if (isMove(entry))
+      {
+        predecessors[ii][entry.getNextState()].push_back(state);
+      }
+    }
+  }
+
+  std::deque<std::pair<uint32_t, uint32_t>> splitters; // Block, column index
+  std::vector<std::vector<bool>> isSplitter;
+  for (uint32_t block = 0; block < blocks.size(); ++block)
+  {
+    isSplitter.emplace_back(columns.size(), true);
+    for (auto ii = 0u; ii < columns.size(); ++ii)
+    {
+      splitters.emplace_back(block, ii);
+    }
+  }
+
+  std::vector<bool> inSplitter(myTables.myStates, false);
+  while (! splitters.empty())
+  {
+    auto splitter = splitters.front();
+    splitters.pop_front();
+    isSplitter[splitter.first][splitter.second] = false;
+
+    // States which move into the splitter block on the splitter column.
+    std::vector<State> movers;
+    for (auto state : blocks[splitter.first])
+    {
+      for (auto mover : predecessors[splitter.second][state])
+      {
+        if (! inSplitter[mover])
+        {
+          inSplitter[mover] = true;
+          movers.push_back(mover);
+        }
+      }
+    }
+
+    std::vector<uint32_t> touchedBlocks;
+    for (auto mover : movers)
+    {
+      touchedBlocks.push_back(blockOf[mover]);
+    }
+    std::sort(touchedBlocks.begin(), touchedBlocks.end());
+    touchedBlocks.erase(std::unique(touchedBlocks.begin(),
+                                    touchedBlocks.end()),
+                        touchedBlocks.end());
+
+    for (auto block : touchedBlocks)
+    {
+      std::vector<State> inside;
+      std::vector<State> outside;
+      for (auto state : blocks[block])
+      {
+        (inSplitter[state] ? inside : outside).push_back(state);
+      }
+      if (outside.empty())
+      {
+        continue;
+      }
+
+      uint32_t newBlock = blocks.size();
+      blocks[block] = inside;
+      blocks.push_back(outside);
+      for (auto state : outside)
+      {
+        blockOf[state] = newBlock;
+      }
+
+      isSplitter.emplace_back(columns.size(), false);
+      for (auto ii = 0u; ii < columns.size(); ++ii)
+      {
+        // If the old block was still to be used as a splitter both halves
+        // have to be, otherwise the smaller one is enough.
+        uint32_t addedBlock = newBlock;
+        if (! isSplitter[block][ii] && inside.size() < outside.size())
+        {
+          addedBlock = block;
+        }
+        if (! isSplitter[addedBlock][ii])
+        {
+          isSplitter[addedBlock][ii] = true;
+          splitters.emplace_back(addedBlock, ii);
+        }
+      }
+    }
+
+    for (auto mover : movers)
+    {
+      inSplitter[mover] = false;
+    }
+  }
+
+  // Number the merged states in order of their lowest original state, which
+  // keeps START_STATE first.
+  for (auto &block : blocks)
+  {
+    std::sort(block.begin(), block.end());
+  }
+  std::vector<State> stateOfBlock(blocks.size());
+  std::vector<State> representatives;
+  for (State state = 0; state < myTables.myStates; ++state)
+  {
+    if (reachable[state] && blocks[blockOf[state]].front() == state)
+    {
+      stateOfBlock[blockOf[state]] = representatives.size();
+      representatives.push_back(state);
+    }
+  }
+
+  auto minimizedEntry = [&](State theState, uint32_t theColumn)
+  {
+    auto entry = entryAt(representatives[theState], theColumn);
+    if (isMove(entry))
+    {
+      entry = PackedEntry(entry.getAction(),
+                          stateOfBlock[blockOf[entry.getNextState()]],
+                          entry.getTerminalId());
+    }
+    return entry;
+  };
+
+  // Merge the columns which are identical in every merged state.
+  std::vector<uint32_t> newColumnOf(myTables.myColumns, 0);
+  std::vector<uint32_t> keptColumns;
+  {
+    std::map<std::vector<uint32_t>, uint32_t> columnContents;
+    for (auto column : columns)
+    {
+      std::vector<uint32_t> contents;
+      for (State state = 0; state < representatives.size(); ++state)
+      {
+        auto entry = minimizedEntry(state, column);
+        contents.push_back(static_cast<uint32_t>(entry.getAction()));
+        contents.push_back(entry.getNextState());
+        contents.push_back(entry.getTerminalId());
+      }
+      auto newColumn = columnContents.emplace(contents, keptColumns.size());
+      if (newColumn.second)
+      {
+        keptColumns.push_back(column);
+      }
+      newColumnOf[column] = newColumn.first->second;
+    }
+  }
+
+  std::vector<PackedEntry> table(representatives.size() * keptColumns.size());
+  for (State state = 0; state < representatives.size(); ++state)
+  {
+    for (auto ii = 0u; ii < keptColumns.size(); ++ii)
+    {
+      table[state * keptColumns.size() + ii] =
+        minimizedEntry(state, keptColumns[ii]);
+    }
+  }
+
+  for (auto &column : myColumnMap)
+  {
+    column = newColumnOf[column];
+  }
+  myFrozenTable.swap(table);
+  myTables.myColumns = keptColumns.size();
+  myTables.myStates = representatives.size();
+}
+
+//*******************************************************
+// ScannerTable::save
+//*******************************************************
+void ScannerTable::save(GrammarCache::Writer &theWriter) const
+{
+  // The table as read from the grammar file isn't needed once frozen.
+  const auto &tables = myTables;
+  decltype(myColumnMap) columnMap;
+  std::copy(tables.myColumnMap, tables.myColumnMap + columnMap.size(),
+            columnMap.begin());
+  theWriter.write(columnMap);
+  theWriter.write(tables.myOriginalColumns);
+  theWriter.write(tables.myOriginalStates);
+  theWriter.write(tables.myColumns);
+  theWriter.write(tables.myStates);
+  theWriter.write(tables.myEntries, tables.myStates * tables.myColumns);
+  theWriter.write(tables.myRuns, tables.myStates);
+  theWriter.write(tables.myFingerprint);
+
+  theWriter.write(tables.myReservedWordMinLength);
+  theWriter.write(tables.myReservedWordMaxLength);
+  theWriter.write(tables.myReservedWordDisplacements,
+                  tables.myNumberReservedWords);
+  theWriter.write(tables.myNumberReservedWords);
+  for (auto ii = 0u; ii < tables.myNumberReservedWords; ++ii)
+  {
+    const auto &slot = tables.myReservedWordSlots[ii];
+    theWriter.write(std::string(slot.myWord, slot.myLength));
+    theWriter.write(slot.myTerminalId);
+  }
+  theWriter.write(tables.myReservedWordTerminals,
+                  tables.myNumberTerminalIds);
+}
+
+//*******************************************************
+// ScannerTable::useOwnTables
+//*******************************************************
+void ScannerTable::useOwnTables() noexcept
+{
+  myTables.myColumnMap = myColumnMap.data();
+  myTables.myEntries = myFrozenTable.data();
+  myTables.myRuns = myRuns.data();
+  myTables.myReservedWordDisplacements = myReservedWordDisplacements.data();
+  myTables.myReservedWordSlots = myReservedWordSlots.data();
+  myTables.myNumberReservedWords = myReservedWordSlots.size();
+  myTables.myReservedWordTerminals = myReservedWordTerminals.data();
+  myTables.myNumberTerminalIds = myReservedWordTerminals.size();
+}
+
+//*******************************************************
+// ScannerTable::validate
+//*******************************************************
+void ScannerTable::validate() const
+{
+  const auto &tables = myTables;
+  auto isTerminal = [this](TerminalSymbol::Id theTerminalId)
+  {
+    return theTerminalId < myTerminalsById.size() &&
+      myTerminalsById[theTerminalId] != nullptr;
+  };
+  uint64_t numberEntries =
+    static_cast<uint64_t>(tables.myStates) * tables.myColumns;
+  bool valid = tables.myStates > 0 && tables.myColumns > 0 &&
+    numberEntries <= UINT32_MAX &&
+    (tables.myNumberReservedWords > 0 ||
+     tables.myReservedWordMinLength > tables.myReservedWordMaxLength) &&
+    tables.myNumberTerminalIds == myTerminalsById.size();
+  for (auto ii = 0u; valid && ii <= UCHAR_MAX; ++ii)
+  {
+    valid = tables.myColumnMap[ii] < tables.myColumns;
+  }
+  for (uint64_t ii = 0; valid && ii < numberEntries; ++ii)
+  {
+    auto entry = tables.myEntries[ii];
+    switch (entry.getAction())
+    {
+      case Action::Error:
+        break;
+      case Action::MoveAppend:
+      case Action::MoveNoAppend:
+        valid = entry.getNextState() < tables.myStates;
+        break;
+      case Action::HaltAppend:
+      case Action::HaltNoAppend:
+      case Action::HaltReuse:
+        valid = (NO_TERMINAL == entry.getTerminalId() ||
+                 isTerminal(entry.getTerminalId()));
+        break;
+      default:
+        valid = false;
+    }
+  }
+  // findRunEnd relies on runs stopping at the end of the source.
+  static constexpr uint32_t RUN_END =
+    static_cast<unsigned char>(SourceBuffer::SENTINEL);
+  for (State state = 0; valid && state < tables.myStates; ++state)
+  {
+    const auto &run = tables.myRuns[state];
+    valid = run.myNumberRanges <= Run::MAX_RANGES;
+    for (auto ii = 0u; valid && ii < run.myNumberRanges; ++ii)
+    {
+      valid = run.myLow[ii] + run.mySpan[ii] < RUN_END;
+    }
+  }
+  // Slots of an embedded table must name the terminals' reserved words.
+  for (auto ii = 0u; valid && ii < tables.myNumberReservedWords; ++ii)
+  {
+    const auto &slot = tables.myReservedWordSlots[ii];
+    auto word = myReservedWords.find(std::string(slot.myWord,
+                                                 slot.myLength));
+    valid = word != myReservedWords.end() &&
+      word->second == slot.myTerminalId && isTerminal(slot.myTerminalId);
+  }
+  if (! valid)
+  {
+    throw std::runtime_error{"Grammar cache is corrupt."};
   }
 }
 
@@ -250,3 +1179,20 @@ std::ostream& operator<<(std::ostream &theOS,
         << ", Terminal Id: " << theEntry.myTerminalId;
   return theOS;
 }
+
+//*******************************************************
+// operator<<
+//*******************************************************
+std::ostream& operator<<(std::ostream &theOS,
+                         const ScannerTable &theScannerTable)
+{
+  theOS << "Scanner Table" << std::endl
+        << "-------------" << std::endl
+        << " States:  " << theScannerTable.myTables.myStates
+        << " (" << theScannerTable.myTables.myOriginalStates
+        << " before minimization)" << std::endl
+        << " Columns: " << theScannerTable.myTables.myColumns
+        << " (" << theScannerTable.myTables.myOriginalColumns
+        << " before minimization)" << std::endl;
+  return theOS;
+}
@@ -8,6 +8,8 @@
  * @author Michael Albers
  */
 
+#include <array>
+#include <climits>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -15,6 +17,7 @@
 #include <string>
 #include <vector>
 
+#include "GrammarCache.h"
 #include "Symbol.h"
 #include "TerminalSymbol.h"
 
@@ -89,6 +92,239 @@ class ScannerTable
     TerminalSymbol::Id myTerminalId;
   };
 
+  /**
+   * Entry of the frozen table. The next state, action and terminal id of an
+   * Entry are packed into a single word so each scanned character costs one
+   * table load:
+   *   bits  0-15 next state
+   *   bits 16-18 action
+   *   bits 19-31 terminal id
+   */
+  class PackedEntry
+  {
+    public:
+
+    /** Largest next state which can be packed. */
+    static constexpr State MAX_STATE = 0xFFFF;
+
+    /** Largest terminal id which can be packed. */
+    static constexpr TerminalSymbol::Id MAX_TERMINAL_ID = 0x1FFF;
+
+    /**
+     * Default constructor, sets entry to error
+     */
+    PackedEntry() = default;
+
+    /**
+     * Constructor, packs the given entry. The entry must already have been
+     * checked against MAX_STATE and MAX_TERMINAL_ID.
+     *
+     * @param theEntry
+     *          entry to pack
+     */
+    explicit PackedEntry(const Entry &theEntry) noexcept :
+      myBits(theEntry.myNextState |
+             (static_cast<uint32_t>(theEntry.myAction) << 16) |
+             (theEntry.myTerminalId << 19))
+    {
+    }
+
+    /**
+     * Constructor, packs the given fields. The fields must already have been
+     * checked against MAX_STATE and MAX_TERMINAL_ID.
+     *
+     * @param theAction
+     *          action to take
+     * @param theNextState
+     *          next state, for the Move* actions
+     * @param theTerminalId
+     *          terminal id, for the Halt* actions
+     */
+    constexpr PackedEntry(Action theAction, State theNextState,
+                          TerminalSymbol::Id theTerminalId) noexcept :
+      myBits(theNextState |
+             (static_cast<uint32_t>(theAction) << 16) |
+             (theTerminalId << 19))
+    {
+    }
+
+    /**
+     * Returns the action of this entry.
+     *
+     * @return action
+     */
+    Action getAction() const noexcept
+    {
+      return static_cast<Action>((myBits >> 16) & 0x7);
+    }
+
+    /**
+     * Returns the next state, only meaningful for the Move* actions.
+     *
+     * @return next state
+     */
+    State getNextState() const noexcept
+    {
+      return myBits & MAX_STATE;
+    }
+
+    /**
+     * Returns the terminal id, only meaningful for the Halt* actions.
+     *
+     * @return terminal id
+     */
+    TerminalSymbol::Id getTerminalId() const noexcept
+    {
+      return myBits >> 19;
+    }
+
+    private:
+
+    /** Packed entry, zero is an Error entry. */
+    uint32_t myBits = 0;
+  };
+
+  /**
+   * Characters on which a state moves back to itself with one action. The
+   * scanner skips over whole runs of these characters at once instead of
+   * going through the table for each one. The characters are kept as a few
+   * byte ranges, which can be tested 16 characters at a time.
+   */
+  class Run
+  {
+    public:
+
+    /** Maximum number of ranges in a run. */
+    static constexpr uint32_t MAX_RANGES = 4;
+
+    /**
+     * Default constructor, a state without a run.
+     */
+    Run() = default;
+
+    /**
+     * Constructor
+     *
+     * @param theLow
+     *          lowest character of each range
+     * @param theSpan
+     *          number of characters in each range, less one
+     * @param theNumberRanges
+     *          number of ranges
+     * @param theAppend
+     *          are the characters appended to the token?
+     */
+    constexpr Run(std::array<uint8_t, MAX_RANGES> theLow,
+                  std::array<uint8_t, MAX_RANGES> theSpan,
+                  uint32_t theNumberRanges, bool theAppend) noexcept :
+      myLow(theLow),
+      mySpan(theSpan),
+      myNumberRanges(theNumberRanges),
+      myAppend(theAppend)
+    {
+    }
+
+    /** Lowest character of each range. */
+    std::array<uint8_t, MAX_RANGES> myLow;
+
+    /** Number of characters in each range, less one. */
+    std::array<uint8_t, MAX_RANGES> mySpan;
+
+    /** Number of ranges, 0 if the state has no run. */
+    uint32_t myNumberRanges = 0;
+
+    /** Are the characters appended to the token? */
+    bool myAppend = false;
+  };
+
+  /**
+   * Slot in the reserved word hash table.
+   */
+  class ReservedWord
+  {
+    public:
+
+    /** Reserved word, lower case, not null terminated. */
+    const char *myWord;
+
+    /** Length of myWord. */
+    uint32_t myLength;
+
+    /** Terminal of the reserved word. */
+    TerminalSymbol::Id myTerminalId;
+  };
+
+  /**
+   * The frozen tables the scan reads. They are either built by finalize or
+   * loaded from a grammar cache, and owned by the ScannerTable, or are
+   * constant data compiled into the program (see EmbeddedGrammar), which
+   * the ScannerTable points at without copying.
+   */
+  class Tables
+  {
+    public:
+
+    /**
+     * Column number for every possible character, UCHAR_MAX + 1 of them,
+     * indexed by the character as an unsigned char.
+     */
+    const uint32_t *myColumnMap;
+
+    /**
+     * Frozen scanner driver table. Mimics a 2-D array,
+     * myEntries[state * myColumns + column]. Once minimized (see minimize)
+     * its states and columns no longer correspond to those of the grammar
+     * file.
+     */
+    const PackedEntry *myEntries;
+
+    /** Number of columns in each row of myEntries. */
+    uint32_t myColumns;
+
+    /** Number of rows in myEntries. */
+    State myStates;
+
+    /** Number of columns of the frozen table before minimization. */
+    uint32_t myOriginalColumns;
+
+    /** Number of states of the frozen table before minimization. */
+    State myOriginalStates;
+
+    /** Run of each state, indexed by state. */
+    const Run *myRuns;
+
+    /** See getFingerprint. */
+    uint64_t myFingerprint;
+
+    /**
+     * Per bucket displacement of the reserved word perfect hash, see
+     * findReservedWord. There are as many buckets as reserved words.
+     */
+    const uint32_t *myReservedWordDisplacements;
+
+    /** Reserved word perfect hash table, one slot per reserved word. */
+    const ReservedWord *myReservedWordSlots;
+
+    /** Number of reserved words. */
+    uint32_t myNumberReservedWords;
+
+    /** Length of the shortest reserved word. */
+    uint32_t myReservedWordMinLength;
+
+    /** Length of the longest reserved word. */
+    uint32_t myReservedWordMaxLength;
+
+    /**
+     * Indexed by terminal id, non-zero for the terminals the frozen table
+     * can halt in on the text of a reserved word. lookupTerminal only looks
+     * up reserved words for these terminals.
+     */
+    const uint8_t *myReservedWordTerminals;
+
+    /** Number of entries of myReservedWordTerminals. */
+    uint32_t myNumberTerminalIds;
+  };
+
   /**
    * Default constructor.
    */
@@ -97,12 +333,12 @@ class ScannerTable
   /**
    * Copy constructor
    */
-  ScannerTable(const ScannerTable &) = default;
+  ScannerTable(const ScannerTable &) = delete;
 
   /**
    * Move constructor
    */
-  ScannerTable(ScannerTable &&) = default;
+  ScannerTable(ScannerTable &&) = delete;
 
   /**
    * Destructor
@@ -112,12 +348,25 @@ class ScannerTable
   /**
    * Copy assignment operator
    */
-  ScannerTable& operator=(const ScannerTable &) = default;
+  ScannerTable& operator=(const ScannerTable &) = delete;
 
   /**
    * Move assignment operator
    */
-  ScannerTable& operator=(ScannerTable &&) = default;
+  ScannerTable& operator=(ScannerTable &&) = delete;
+
+  /**
+   * Stream insertion operator. Prints the size of the table before and
+   * after minimization.
+   *
+   * @param theOS
+   *          stream to insert into
+   * @param theScannerTable
+   *          table to insert into theOS
+   * @return modified stream
+   */
+  friend std::ostream& operator<<(std::ostream &theOS,
+                                  const ScannerTable &theScannerTable);
 
   /**
    * Adds a new column to the end of the current column set. Each column
@@ -161,55 +410,138 @@ class ScannerTable
    * @return possibly updated terminal code
    */
   TerminalSymbol::Id checkExceptions(TerminalSymbol::Id theTerminalId,
-                                     std::string theTokenString)
+                                     const std::string &theTokenString)
     const noexcept;
 
   /**
-   * Returns the action for the given current state/character inputs.
+   * Builds the lookup structures used while scanning and freezes the table.
+   * Must be called once all of the columns and table entries have been
+   * added.
    *
-   * @param theCurrentState
+   * @throws std::runtime_error
+   *           if an entry cannot be packed or moves to an undefined state
+   */
+  void finalize();
+
+  /**
+   * Returns the end of the run of characters starting at theCursor on which
+   * the given state moves back to itself (see Run). Only valid after
+   * finalize has been called.
+   *
+   * @param theState
    *          current state
-   * @param theCharacter
-   *          current character
-   * @return action to take based on inputs
-   * @throws std::invalid_argument on invalid state
+   * @param theCursor
+   *          first character to check, the source must end with
+   *          SourceBuffer::SENTINEL
+   * @return first character not in the run, theCursor if the state has no
+   *         run or theCursor does not start one
    */
-  Action getAction(State theCurrentState, char theCharacter) const;
+  const char* findRunEnd(State theState, const char *theCursor)
+    const noexcept;
 
   /**
    * Returns the special EOF symbol.
    *
    * @return EOF symbol
    */
-  std::shared_ptr<Symbol> getEOF() const noexcept;
+  const std::shared_ptr<Symbol>& getEOF() const noexcept;
+
+  /**
+   * Returns a hash of the frozen table's behavior: the entry every state
+   * takes on every character. Two tables with the same fingerprint scan
+   * identically (terminal lookup aside), which is how a generated scanner
+   * (see ScannerGenerator) is matched to a grammar. Only valid after
+   * finalize has been called.
+   *
+   * @return fingerprint
+   */
+  uint64_t getFingerprint() const noexcept;
 
   /**
-   * Returns the next state given the current state/character inputs.
+   * Returns the frozen table entry for the given current state/character
+   * inputs. Only valid after finalize has been called.
    *
    * @param theCurrentState
-   *          current state
+   *          current state, must be a state of the table (all states reached
+   *          through the table are)
    * @param theCharacter
    *          current character
-   * @return state value
-   * @throws std::invalid_argument on invalid state
+   * @return table entry
    */
-  State getState(State theCurrentState, char theCharacter) const;
+  PackedEntry getEntry(State theCurrentState, char theCharacter)
+    const noexcept;
 
   /**
-   * Returns the terminal for the given state/character/token combination.
+   * Returns the number of states in the table.
    *
-   * @param theCurrentState
+   * @return number of states
+   */
+  State getNumberStates() const noexcept;
+
+  /**
+   * Returns the frozen tables, for GrammarTablesGenerator to write out.
+   * Only valid after finalize or load has been called.
+   *
+   * @return frozen tables
+   */
+  const Tables& getTables() const noexcept;
+
+  /**
+   * Returns true if the characters of the given state's run (see
+   * findRunEnd) are appended to the token.
+   *
+   * @param theState
    *          current state
-   * @param theCharacter
-   *          current character
-   * @param theTokenString
-   *          token from source file, used for reserved word checking
-   * @return terminal id
-   * @throws std::invalid_argument on invalid state
+   * @return true for a MoveAppend run, false for a MoveNoAppend run
+   */
+  bool isRunAppended(State theState) const noexcept;
+
+  /**
+   * Loads the frozen table from a grammar cache, in place of finalize. Must
+   * be called once all of the terminals have been added.
+   *
+   * @param theReader
+   *          cache reader, positioned where save wrote the table
+   * @throws std::runtime_error
+   *          if the cache is truncated or corrupt
+   */
+  void load(GrammarCache::Reader &theReader);
+
+  /**
+   * Points at the given frozen tables, in place of finalize, without
+   * copying them. Must be called once all of the terminals have been
+   * added.
+   *
+   * @param theTables
+   *          tables, which must outlive this object
+   * @throws std::runtime_error
+   *          if the tables do not fit the terminals, or are corrupt
+   */
+  void load(const Tables &theTables);
+
+  /**
+   * Returns the terminal for the given terminal id/token combination.
+   *
+   * @param theTerminalId
+   *          terminal id from a Halt* table entry
+   * @param theText
+   *          token text from source file, used for reserved word checking
+   * @param theLength
+   *          length of theText
+   * @return terminal, null for an unknown terminal id
    */
-  std::shared_ptr<Symbol> lookupTerminal(State theCurrentState,
-                                         char theCharacter,
-                                         std::string theTokenString) const;
+  const Symbol* lookupTerminal(TerminalSymbol::Id theTerminalId,
+                               const char *theText,
+                               uint32_t theLength) const noexcept;
+
+  /**
+   * Writes the frozen table to a grammar cache. Only valid after finalize
+   * has been called.
+   *
+   * @param theWriter
+   *          cache writer
+   */
+  void save(GrammarCache::Writer &theWriter) const;
 
   /** Starting state */
   static constexpr uint32_t START_STATE = 0;
@@ -225,6 +557,67 @@ class ScannerTable
   // ************************************************************
   protected:
 
+  /**
+   * Minimizes the frozen table: drops states which cannot be reached from
+   * START_STATE, merges equivalent states (Hopcroft's algorithm) and merges
+   * columns which are identical in every state.
+   */
+  void minimize() noexcept;
+
+  /**
+   * Builds the run of each state of the frozen table.
+   */
+  void buildRuns() noexcept;
+
+  /**
+   * Builds the perfect hash table of the reserved words.
+   *
+   * @throws std::runtime_error
+   *           if no perfect hash could be found
+   */
+  void buildReservedWordHash();
+
+  /**
+   * Builds myReservedWordTerminals by running every reserved word, in
+   * either case, through the frozen table.
+   */
+  void buildReservedWordTerminals() noexcept;
+
+  /**
+   * Looks up the given text in the reserved words, ignoring case.
+   *
+   * @param theText
+   *          text to look up
+   * @param theLength
+   *          length of theText
+   * @param theTerminalId
+   *          OUT parameter - terminal id of the reserved word, only set if
+   *          the text is a reserved word
+   * @return true if the text is a reserved word
+   */
+  bool findReservedWord(const char *theText, uint32_t theLength,
+                        TerminalSymbol::Id &theTerminalId) const noexcept;
+
+  /**
+   * Builds myTerminalsById from myTerminalIdMap.
+   */
+  void indexTerminals() noexcept;
+
+  /**
+   * Points myTables at the tables this object owns, as built or loaded so
+   * far.
+   */
+  void useOwnTables() noexcept;
+
+  /**
+   * Checks everything the scan indexes with the values of myTables is in
+   * range.
+   *
+   * @throws std::runtime_error
+   *          if not
+   */
+  void validate() const;
+
   /**
    * Returns the table column number based on the given character.
    *
@@ -234,16 +627,6 @@ class ScannerTable
    */
   uint32_t getColumn(char theCharacter) const noexcept;
 
-  /**
-   * Validates the given state.
-   *
-   * @param theState
-   *          state to validate
-   * @throws std::invalid_argument
-   *           on invalid state
-   */
-  void validateState(State theState) const;
-
   // ************************************************************
   // Private
   // ************************************************************
@@ -252,17 +635,47 @@ class ScannerTable
   /** Table columns character classes*/
   std::vector<std::string> myColumnCharacterClasses;
 
+  /**
+   * Column number for every possible character, built from
+   * myColumnCharacterClasses by finalize, see Tables.
+   */
+  std::array<uint32_t, UCHAR_MAX+1> myColumnMap;
+
+  /** Run of each state, see Tables. */
+  std::vector<Run> myRuns;
+
+  /** Reserved word hash displacements, see Tables. */
+  std::vector<uint32_t> myReservedWordDisplacements;
+
+  /**
+   * Reserved word hash table, see Tables. The words are the keys of
+   * myReservedWords.
+   */
+  std::vector<ReservedWord> myReservedWordSlots;
+
+  /** Terminals halting on reserved words, see Tables. */
+  std::vector<uint8_t> myReservedWordTerminals;
+
   /** Reserved words. Reserved word, terminal info*/
   std::map<std::string, TerminalSymbol::Id> myReservedWords;
 
-  /** Scanner driver table */
-  std::vector<std::vector<Entry>> myTable;
+  /** Frozen scanner driver table, see Tables. */
+  std::vector<PackedEntry> myFrozenTable;
 
-  /** Terminals from the grammar file. */
-  Symbol::SymbolSet myTerminals;
+  /**
+   * The frozen tables the scan reads: the members above or embedded ones.
+   * Also holds their sizes, which finalize works on as it builds them.
+   */
+  Tables myTables = Tables();
+
+  /** Scanner driver table, as built through addTableEntry. */
+  std::vector<std::vector<Entry>> myTable;
 
   /** Map of terminal Ids to its terminal. */
   std::map<TerminalSymbol::Id, std::shared_ptr<Symbol>> myTerminalIdMap;
+
+  /** Terminals indexed by terminal id, built from myTerminalIdMap. */
+  std::vector<const Symbol*> myTerminalsById;
 };
 
 #endif
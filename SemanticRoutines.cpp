@@ -20,6 +20,23 @@
 #include "SemanticStack.h"
 #include "SymbolTable.h"
 
+// Must be in ActionSymbol::Routine order.
+const SemanticRoutines::SemanticRoutine
+SemanticRoutines::ourSemanticRoutines[] = {
+  &SemanticRoutines::assign,
+  &SemanticRoutines::copy,
+  &SemanticRoutines::createScope,
+  &SemanticRoutines::destroyScope,
+  &SemanticRoutines::finish,
+  &SemanticRoutines::genInfix,
+  &SemanticRoutines::processId,
+  &SemanticRoutines::processLiteral,
+  &SemanticRoutines::processOp,
+  &SemanticRoutines::readId,
+  &SemanticRoutines::start,
+  &SemanticRoutines::writeExpr,
+};
+
 //*******************************************************
 // SemanticRoutines::SemanticRoutines
 //*******************************************************
@@ -43,70 +60,29 @@ SemanticRoutines::SemanticRoutines(const std::string &theGeneratedCodeFileName,
     myEWTracker.reportError(error.str());
     throw std::runtime_error{error.str()};
   }
-
-#define ADD_ROUTINE(x,y) mySemanticRoutines[#x] = &SemanticRoutines::y
-  ADD_ROUTINE(assign, assign);
-  ADD_ROUTINE(copy, copy);
-  ADD_ROUTINE(createscope, createScope);
-  ADD_ROUTINE(destroyscope, destroyScope);
-  ADD_ROUTINE(geninfix, genInfix);
-  ADD_ROUTINE(finish, finish);
-  ADD_ROUTINE(processid, processId);
-  ADD_ROUTINE(processliteral, processLiteral);
-  ADD_ROUTINE(processop, processOp);
-  ADD_ROUTINE(readid, readId);
-  ADD_ROUTINE(start, start);
-  ADD_ROUTINE(writeexpr, writeExpr);
-#undef ADD_ROUTINE
 }
 
 //*******************************************************
 // SemanticRoutines::executeSemanticRoutine
 //*******************************************************
 void SemanticRoutines::executeSemanticRoutine(
-  const std::shared_ptr<Symbol> theActionSymbol)
+  const ActionSymbol &theActionSymbol)
 {
-  const ActionSymbol *actionSymbol = dynamic_cast<const ActionSymbol*>(
-    theActionSymbol.get());
-
-  std::string actionSymbolText{actionSymbol->getName()};
-  actionSymbolText.erase(actionSymbolText.begin()); // Remove #
-
-  auto lParenPosition = actionSymbolText.find('(');
-  std::string semanticRoutine{actionSymbolText.substr(0, lParenPosition)};
-
-  std::vector<std::string> arguments;
-
-  if (lParenPosition != std::string::npos)
-  {
-    auto rParenPosition = actionSymbolText.find(')');
-    std::string argumentString{actionSymbolText.substr(
-        lParenPosition+1, rParenPosition-lParenPosition-1)};
-
-    std::string::size_type tokenStart = 0;
-    auto position = argumentString.find(',', tokenStart);
-    while (position != std::string::npos)
-    {
-      arguments.push_back(argumentString.substr(tokenStart,
-                                                position-tokenStart));
-      tokenStart = position + 1;
-      position = argumentString.find(',', tokenStart);
-    }
-    arguments.push_back(argumentString.substr(tokenStart,
-                                              position-tokenStart));
-  }
-
-  std::transform(semanticRoutine.begin(), semanticRoutine.end(),
-                 semanticRoutine.begin(), ::tolower);
-
-  auto routine = mySemanticRoutines[semanticRoutine];
-  routine(this, arguments);
+  static_assert(sizeof(ourSemanticRoutines) /
+                sizeof(ourSemanticRoutines[0]) ==
+                ActionSymbol::NUMBER_ROUTINES,
+                "Every routine needs a semantic routine.");
+
+  auto routine = ourSemanticRoutines[
+    static_cast<uint32_t>(theActionSymbol.getRoutine())];
+  (this->*routine)(theActionSymbol.getArguments());
 }
 
 //*******************************************************
 // SemanticRoutines::getCode
 //*******************************************************
-std::vector<std::string> SemanticRoutines::getCode() const noexcept
+const std::vector<std::string>& SemanticRoutines::getCode() const
+  noexcept
 {
   return myGeneratedCode;
 }
@@ -142,7 +118,7 @@ std::string SemanticRoutines::getOperand(std::string theOperand) noexcept
 //*******************************************************
 // SemanticRoutines::assign
 //*******************************************************
-void SemanticRoutines::assign(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::assign(const Arguments &theArguments) noexcept
 {
   auto &targetRecord = mySemanticStack.getRecordFromArgument(theArguments[0]);
   auto &sourceRecord = mySemanticStack.getRecordFromArgument(theArguments[1]);
@@ -153,7 +129,7 @@ void SemanticRoutines::assign(std::vector<std::string> &theArguments) noexcept
 //*******************************************************
 // SemanticRoutines::copy
 //*******************************************************
-void SemanticRoutines::copy(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::copy(const Arguments &theArguments) noexcept
 {
   auto &sourceRecord = mySemanticStack.getRecordFromArgument(theArguments[0]);
   auto &targetRecord = mySemanticStack.getRecordFromArgument(theArguments[1]);
@@ -163,7 +139,7 @@ void SemanticRoutines::copy(std::vector<std::string> &theArguments) noexcept
 //*******************************************************
 // SemanticRoutines::createScope
 //*******************************************************
-void SemanticRoutines::createScope(std::vector<std::string> &theArguments)
+void SemanticRoutines::createScope(const Arguments &theArguments)
   noexcept
 {
   mySymbolTable.createNewScope();
@@ -172,7 +148,7 @@ void SemanticRoutines::createScope(std::vector<std::string> &theArguments)
 //*******************************************************
 // SemanticRoutines::destroyScope
 //*******************************************************
-void SemanticRoutines::destroyScope(std::vector<std::string> &theArguments)
+void SemanticRoutines::destroyScope(const Arguments &theArguments)
   noexcept
 {
   try
@@ -188,7 +164,7 @@ void SemanticRoutines::destroyScope(std::vector<std::string> &theArguments)
 //*******************************************************
 // SemanticRoutines::finish
 //*******************************************************
-void SemanticRoutines::finish(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::finish(const Arguments &theArguments) noexcept
 {
   generate("HALT");
 }
@@ -260,7 +236,7 @@ void SemanticRoutines::generate(const std::string &theInstruction,
 //*******************************************************
 // SemanticRoutines::genInfix
 //*******************************************************
-void SemanticRoutines::genInfix(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::genInfix(const Arguments &theArguments) noexcept
 {
   auto &expr1 = mySemanticStack.getRecordFromArgument(theArguments[0]);
   auto &op = mySemanticStack.getRecordFromArgument(theArguments[1]);
@@ -296,7 +272,7 @@ std::string SemanticRoutines::getTupleCode() noexcept
 //*******************************************************
 // SemanticRoutines::processId
 //*******************************************************
-void SemanticRoutines::processId(std::vector<std::string> &theArguments)
+void SemanticRoutines::processId(const Arguments &theArguments)
   noexcept
 {
   auto &identifier = mySemanticStack.getRecordAtCurrentIndexMinusOne();
@@ -320,7 +296,7 @@ void SemanticRoutines::processId(std::vector<std::string> &theArguments)
 //*******************************************************
 // SemanticRoutines::processLiteral
 //*******************************************************
-void SemanticRoutines::processLiteral(std::vector<std::string> &theArguments)
+void SemanticRoutines::processLiteral(const Arguments &theArguments)
   noexcept
 {
   auto &literal = mySemanticStack.getRecordAtCurrentIndexMinusOne();
@@ -334,7 +310,7 @@ void SemanticRoutines::processLiteral(std::vector<std::string> &theArguments)
 //*******************************************************
 // SemanticRoutines::processOp
 //*******************************************************
-void SemanticRoutines::processOp(std::vector<std::string> &theArguments)
+void SemanticRoutines::processOp(const Arguments &theArguments)
   noexcept
 {
   auto &operatorData = mySemanticStack.getRecordAtCurrentIndexMinusOne();
@@ -352,7 +328,7 @@ void SemanticRoutines::processOp(std::vector<std::string> &theArguments)
 //*******************************************************
 // SemanticRoutines::readId
 //*******************************************************
-void SemanticRoutines::readId(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::readId(const Arguments &theArguments) noexcept
 {
   auto &variable = mySemanticStack.getRecordFromArgument(theArguments[0]);
   generate("READI", variable.extract());
@@ -361,7 +337,7 @@ void SemanticRoutines::readId(std::vector<std::string> &theArguments) noexcept
 //*******************************************************
 // SemanticRoutines::start
 //*******************************************************
-void SemanticRoutines::start(std::vector<std::string> &theArguments) noexcept
+void SemanticRoutines::start(const Arguments &theArguments) noexcept
 {
   myNextTemp = 0;
 }
@@ -369,7 +345,7 @@ void SemanticRoutines::start(std::vector<std::string> &theArguments) noexcept
 //*******************************************************
 // SemanticRoutines::writeExpr
 //*******************************************************
-void SemanticRoutines::writeExpr(std::vector<std::string> &theArguments)
+void SemanticRoutines::writeExpr(const Arguments &theArguments)
   noexcept
 {
   auto &expression = mySemanticStack.getRecordFromArgument(theArguments[0]);
@@ -10,15 +10,14 @@
 
 #include <cstdint>
 #include <fstream>
-#include <map>
 #include <memory>
 #include <vector>
 
+#include "ActionSymbol.h"
 #include "SemanticRecord.h"
 
 class ErrorWarningTracker;
 class SemanticStack;
-class Symbol;
 class SymbolTable;
 
 /**
@@ -88,14 +87,14 @@ class SemanticRoutines
    * @param theActionSymbol
    *          action symbol from the grammar.
    */
-  void executeSemanticRoutine(const std::shared_ptr<Symbol> theActionSymbol);
+  void executeSemanticRoutine(const ActionSymbol &theActionSymbol);
 
   /**
    * Returns all generated code.
    *
    * @return generated code
    */
-  std::vector<std::string> getCode() const noexcept;
+  const std::vector<std::string>& getCode() const noexcept;
 
   /**
    * Returns all symbols in the symbol table.
@@ -114,18 +113,23 @@ class SemanticRoutines
   // ************************************************************
   private:
 
+  /** Arguments to action symbol. */
+  using Arguments = std::vector<ActionSymbol::Argument>;
+
   /**
    * Semantic routine functions.
    */
-  using SemanticRoutine = std::function<void(SemanticRoutines*,
-                                             std::vector<std::string>&)>;
+  using SemanticRoutine = void (SemanticRoutines::*)(const Arguments&);
+
+  /** Semantic routine of each ActionSymbol::Routine, indexed by it. */
+  static const SemanticRoutine ourSemanticRoutines[];
 
   /**
    * All action symbol semantic routines.
    *
    * @param Arguments to action symbol.
    */
-#define ACTION_SYMBOL_ROUTINE(x) void x(std::vector<std::string>&) noexcept
+#define ACTION_SYMBOL_ROUTINE(x) void x(const Arguments&) noexcept
   ACTION_SYMBOL_ROUTINE(assign);
   ACTION_SYMBOL_ROUTINE(copy);
   ACTION_SYMBOL_ROUTINE(createScope);
@@ -229,9 +233,6 @@ class SemanticRoutines
   /** Temporary variable id */
   uint32_t myNextTemp = 0;
 
-  /** Map of action symbol name to actual semantic routine. */
-  std::map<std::string, SemanticRoutine> mySemanticRoutines;
-
   /** Semantic stack. */
   SemanticStack &mySemanticStack;
 
@@ -9,7 +9,7 @@
 #include <cctype>
 #include <vector>
 
-#include "EOPSymbol.h"
+#include "ActionSymbol.h"
 #include "SemanticStack.h"
 
 //*******************************************************
@@ -29,27 +29,47 @@ void SemanticStack::expand(uint32_t theNumberElementsToAdd) noexcept
   myRightIndex = myTopIndex;
   myCurrentIndex = myRightIndex;
   myTopIndex += theNumberElementsToAdd;
+  myTailProduction = false;
 }
 
 //*******************************************************
-// SemanticStack::getEOPSymbol
+// SemanticStack::expandTail
 //*******************************************************
-std::shared_ptr<Symbol> SemanticStack::getEOPSymbol() const noexcept
+void SemanticStack::expandTail(uint32_t theNumberElementsToAdd) noexcept
 {
-  return std::shared_ptr<Symbol>(new EOPSymbol(myCurrentIndex,
-                                               myLeftIndex,
-                                               myRightIndex,
-                                               myTopIndex));
+  // The new production's LHS record (at the current index, it may hold an
+  // inherited value) moves down to the first of the current production's
+  // records, or onto its LHS record if it is a tail production too. That
+  // makes a chain of tail productions reuse the same records.
+  auto leftIndex = myTailProduction ? myLeftIndex : myRightIndex;
+  if (leftIndex != myCurrentIndex)
+  {
+    mySemanticStack[leftIndex] = mySemanticStack[myCurrentIndex];
+  }
+  myCurrentIndex = leftIndex;
+  myTopIndex = leftIndex + 1;
+  mySemanticStack.resize(myTopIndex+1);
+
+  expand(theNumberElementsToAdd);
+  myTailProduction = true;
+}
+
+//*******************************************************
+// SemanticStack::getFrame
+//*******************************************************
+SemanticStack::Frame SemanticStack::getFrame() const noexcept
+{
+  return Frame{myCurrentIndex, myLeftIndex, myRightIndex, myTopIndex,
+               myTailProduction};
 }
 
 //*******************************************************
 // SemanticStack::getIndex
 //*******************************************************
-uint32_t SemanticStack::getIndex(std::string theArgument) const noexcept
+uint32_t SemanticStack::getIndex(uint32_t theArgument) const noexcept
 {
   uint32_t index = 0;
-  theArgument.erase(theArgument.begin());
-  if ('$' == theArgument[0])
+  if (ActionSymbol::LHS_ARGUMENT == theArgument)
   {
     // $$
     index = myLeftIndex;
@@ -57,7 +77,7 @@ uint32_t SemanticStack::getIndex(std::string theArgument) const noexcept
   else
   {
     // $1, $2, etc. $1 == right index, hence the -1
-    index = myRightIndex + std::stoul(theArgument) - 1;
+    index = myRightIndex + theArgument - 1;
   }
   return index;
 }
@@ -73,7 +93,7 @@ SemanticRecord& SemanticStack::getRecordAtCurrentIndexMinusOne() noexcept
 //*******************************************************
 // SemanticStack::getRecordFromArgument
 //*******************************************************
-SemanticRecord& SemanticStack::getRecordFromArgument(std::string theArgument)
+SemanticRecord& SemanticStack::getRecordFromArgument(uint32_t theArgument)
   noexcept
 {
   auto stackIndex = getIndex(theArgument);
@@ -83,7 +103,8 @@ SemanticRecord& SemanticStack::getRecordFromArgument(std::string theArgument)
 //*******************************************************
 // SemanticStack::getStack
 //*******************************************************
-std::vector<SemanticRecord> SemanticStack::getStack() const noexcept
+const std::vector<SemanticRecord>& SemanticStack::getStack() const
+  noexcept
 {
   return mySemanticStack;
 }
@@ -103,6 +124,7 @@ void SemanticStack::initialize() noexcept
   myRightIndex = 0;
   myCurrentIndex = 1;
   myTopIndex = 2;
+  myTailProduction = false;
 }
 
 //*******************************************************
@@ -118,13 +140,13 @@ void SemanticStack::replaceAtCurrentIndex(const SemanticRecord &theNewRecord)
 //*******************************************************
 // SemanticStack::restore
 //*******************************************************
-void SemanticStack::restore(std::shared_ptr<Symbol> theEOPSymbol)
-  noexcept
+void SemanticStack::restore(const Frame &theFrame) noexcept
 {
-  dynamic_cast<EOPSymbol*>(theEOPSymbol.get())->getValues(myCurrentIndex,
-                                                          myLeftIndex,
-                                                          myRightIndex,
-                                                          myTopIndex);
+  myCurrentIndex = theFrame.myCurrentIndex;
+  myLeftIndex = theFrame.myLeftIndex;
+  myRightIndex = theFrame.myRightIndex;
+  myTopIndex = theFrame.myTopIndex;
+  myTailProduction = theFrame.myTailProduction;
   // Need to add one as stack is 1-based. (So if myTopIndex == 12,
   // mySemanticStack[12] must be the first free item. And mySemanticStack[12]
   // is actually the 13th element.).
@@ -9,13 +9,10 @@
  */
 
 #include <cstdint>
-#include <memory>
 #include <vector>
 
 #include "SemanticRecord.h"
 
-class Symbol;
-
 /**
  * A semantic stack for the compiler. The semantic stack contains semantic
  * information about the tokens which have been encountered during the
@@ -29,6 +26,30 @@ class SemanticStack
   // ************************************************************
   public:
 
+  /**
+   * Indices of the stack saved when a production is predicted and restored
+   * at its end (EOP).
+   */
+  class Frame
+  {
+    public:
+
+    /** See SemanticStack::myCurrentIndex. */
+    uint32_t myCurrentIndex;
+
+    /** See SemanticStack::myLeftIndex. */
+    uint32_t myLeftIndex;
+
+    /** See SemanticStack::myRightIndex. */
+    uint32_t myRightIndex;
+
+    /** See SemanticStack::myTopIndex. */
+    uint32_t myTopIndex;
+
+    /** See SemanticStack::myTailProduction. */
+    bool myTailProduction;
+  };
+
   /**
    * Default constructor.
    */
@@ -68,11 +89,23 @@ class SemanticStack
   void expand(uint32_t theNumberElementsToAdd) noexcept;
 
   /**
-   * Returns an EOPSymbol with the current state of the semantic stack.
+   * Expands the stack for a production predicted in tail position, that is
+   * with its EOP elided as it would have been directly on top of another
+   * EOP. Nothing reads the records of the current production any more, so
+   * the new production reuses their space rather than growing the stack.
    *
-   * @return EOPSymbol with stack state.
+   * @param theNumberElementsToAdd
+   *          number of grammar symbols of the new production
+   */
+  void expandTail(uint32_t theNumberElementsToAdd) noexcept;
+
+  /**
+   * Returns the current state of the semantic stack, to be restored at the
+   * end of the production about to be predicted.
+   *
+   * @return stack state
    */
-  std::shared_ptr<Symbol> getEOPSymbol() const noexcept;
+  Frame getFrame() const noexcept;
 
   /**
    * Returns the record at currentIndex - 1. Specialty function provided for
@@ -87,17 +120,17 @@ class SemanticStack
    * "$$" or "$3")
    *
    * @param theArgument
-   *          action sybmol argument
+   *          action symbol argument, see ActionSymbol::Argument
    * @return semantic record
    */
-  SemanticRecord& getRecordFromArgument(std::string theArgument) noexcept;
+  SemanticRecord& getRecordFromArgument(uint32_t theArgument) noexcept;
 
   /**
    * Returns the semantic stack for printing out code generation steps.
    *
    * @return semantic stack
    */
-  std::vector<SemanticRecord> getStack() const noexcept;
+  const std::vector<SemanticRecord>& getStack() const noexcept;
 
   /**
    * Initializes the stack. (Essentially just code for
@@ -114,12 +147,12 @@ class SemanticStack
   void replaceAtCurrentIndex(const SemanticRecord &theNewRecord) noexcept;
 
   /**
-   * Restores state from the given EOP symbol.
+   * Restores state from the given frame, at the end of a production.
    *
-   * @param theEOPSymbol
-   *          state restoration object
+   * @param theFrame
+   *          state saved by getFrame
    */
-  void restore(std::shared_ptr<Symbol> theEOPSymbol) noexcept;
+  void restore(const Frame &theFrame) noexcept;
 
   // ************************************************************
   // Protected
@@ -135,11 +168,11 @@ class SemanticStack
    * Given an action symbol argument ($$, $1, etc.) this function returns
    * the semantic stack index.
    *
-   * @param theArguments
-   *          action symbol argument
+   * @param theArgument
+   *          action symbol argument, see ActionSymbol::Argument
    * @return semantic stack index
    */
-  uint32_t getIndex(std::string theArgument) const noexcept;
+  uint32_t getIndex(uint32_t theArgument) const noexcept;
 
   /** Top of the stack. */
   uint32_t myCurrentIndex = 0;
@@ -150,6 +183,12 @@ class SemanticStack
   /** Index of first semantic record from production RHS. */
   uint32_t myRightIndex = 0;
 
+  /**
+   * If the current production was predicted in tail position (see
+   * expandTail), and so its LHS record is no longer needed either.
+   */
+  bool myTailProduction = false;
+
   /** Next index in the stack to use. */
   uint32_t myTopIndex = 0;
 
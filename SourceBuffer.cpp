@@ -0,0 +1,200 @@
+/**
+ * @file SourceBuffer.cpp
+ * @brief Implementation of SourceBuffer class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SourceBuffer.h"
+
+constexpr char SourceBuffer::SENTINEL;
+const std::string SourceBuffer::STANDARD_INPUT{"-"};
+
+//*******************************************************
+// SourceBuffer::SourceBuffer
+//*******************************************************
+SourceBuffer::SourceBuffer(const std::string &theFile) :
+  myFile(theFile)
+{
+  int fileDescriptor = STDIN_FILENO;
+  if (myFile != STANDARD_INPUT)
+  {
+    fileDescriptor = ::open(myFile.c_str(), O_RDONLY);
+    if (fileDescriptor < 0)
+    {
+      auto localErrno = errno;
+      throw std::runtime_error("Failed to open '" + myFile + "': " +
+                               std::strerror(localErrno));
+    }
+  }
+
+  struct stat fileStatus;
+  bool mapped = false;
+  if (::fstat(fileDescriptor, &fileStatus) == 0 &&
+      S_ISREG(fileStatus.st_mode) && fileStatus.st_size > 0)
+  {
+    mapped = map(fileDescriptor, fileStatus.st_size);
+  }
+
+  try
+  {
+    if (! mapped)
+    {
+      read(fileDescriptor);
+    }
+  }
+  catch (...)
+  {
+    if (fileDescriptor != STDIN_FILENO)
+    {
+      ::close(fileDescriptor);
+    }
+    throw;
+  }
+
+  // The mapping stays valid once the file is closed.
+  if (fileDescriptor != STDIN_FILENO)
+  {
+    ::close(fileDescriptor);
+  }
+}
+
+//*******************************************************
+// SourceBuffer::~SourceBuffer
+//*******************************************************
+SourceBuffer::~SourceBuffer()
+{
+  if (myMapping != nullptr)
+  {
+    ::munmap(myMapping, myMappingSize);
+  }
+}
+
+//*******************************************************
+// SourceBuffer::getBegin
+//*******************************************************
+const char* SourceBuffer::getBegin() const noexcept
+{
+  return myBegin;
+}
+
+//*******************************************************
+// SourceBuffer::getEnd
+//*******************************************************
+const char* SourceBuffer::getEnd() const noexcept
+{
+  return myBegin + mySize;
+}
+
+//*******************************************************
+// SourceBuffer::map
+//*******************************************************
+bool SourceBuffer::map(int theFileDescriptor, std::size_t theSize) noexcept
+{
+  // Reserve room for the file plus the sentinel, then map the file over the
+  // start of the reservation. The sentinel either lands in the zero filled
+  // tail of the file's last page or, when the file is a whole number of
+  // pages, in the anonymous page after it.
+  std::size_t pageSize = ::sysconf(_SC_PAGESIZE);
+  std::size_t mappingSize = ((theSize + 1 + pageSize - 1) / pageSize) *
+    pageSize;
+
+  void *reservation = ::mmap(nullptr, mappingSize, PROT_READ | PROT_WRITE,
+                             MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (MAP_FAILED == reservation)
+  {
+    return false;
+  }
+
+  void *file = ::mmap(reservation, theSize, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_FIXED, theFileDescriptor, 0);
+  if (MAP_FAILED == file)
+  {
+    ::munmap(reservation, mappingSize);
+    return false;
+  }
+
+  char *contents = static_cast<char*>(file);
+  contents[theSize] = SENTINEL;
+  ::mprotect(reservation, mappingSize, PROT_READ);
+  ::madvise(reservation, mappingSize, MADV_SEQUENTIAL);
+
+  myMapping = reservation;
+  myMappingSize = mappingSize;
+  myBegin = contents;
+  mySize = theSize;
+  return true;
+}
+
+//*******************************************************
+// SourceBuffer::release
+//*******************************************************
+void SourceBuffer::release(const char *theBegin,
+                           const char *theEnd) const noexcept
+{
+  if (nullptr == myMapping)
+  {
+    return;
+  }
+
+  // Only pages wholly in front of theEnd, so never the sentinel's page,
+  // whose private copy could not be read back from the file.
+  std::uintptr_t pageSize = ::sysconf(_SC_PAGESIZE);
+  auto begin = reinterpret_cast<std::uintptr_t>(theBegin) & ~(pageSize - 1);
+  auto end = reinterpret_cast<std::uintptr_t>(theEnd) & ~(pageSize - 1);
+  if (begin < end)
+  {
+    ::madvise(reinterpret_cast<void*>(begin), end - begin, MADV_DONTNEED);
+  }
+}
+
+//*******************************************************
+// SourceBuffer::read
+//*******************************************************
+void SourceBuffer::read(int theFileDescriptor)
+{
+  static constexpr std::size_t BLOCK_SIZE = 16;
+  static constexpr std::size_t READ_SIZE = 1 << 20;
+
+  std::size_t size = 0;
+  while (true)
+  {
+    myBuffer.resize(size + READ_SIZE);
+    auto bytesRead = ::read(theFileDescriptor, myBuffer.data() + size,
+                            READ_SIZE);
+    if (bytesRead < 0)
+    {
+      if (EINTR == errno)
+      {
+        continue;
+      }
+      auto localErrno = errno;
+      throw std::runtime_error("Failed to read '" + myFile + "': " +
+                               std::strerror(localErrno));
+    }
+    if (0 == bytesRead)
+    {
+      break;
+    }
+    size += bytesRead;
+  }
+
+  // ScannerTable::findRunEnd reads whole aligned 16 byte blocks, so keep
+  // the rest of the block holding the sentinel (operator new aligns the
+  // storage to 16 bytes). This only ever shrinks the last read's room.
+  myBuffer.resize(((size + 1 + BLOCK_SIZE - 1) / BLOCK_SIZE) * BLOCK_SIZE);
+  myBuffer[size] = SENTINEL;
+
+  myBegin = myBuffer.data();
+  mySize = size;
+}
@@ -0,0 +1,161 @@
+#ifndef SOURCEBUFFER_H
+#define SOURCEBUFFER_H
+
+/**
+ * @file SourceBuffer.h
+ * @brief Defines the class which holds the contents of a source file.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+/**
+ * Holds the entire contents of a source file in memory for the scanner.
+ * Regular files are mapped read-only, anything else (pipes, standard input)
+ * is read in bulk into an owned buffer.
+ *
+ * The contents are always followed by SENTINEL, so a scan only needs to
+ * check its position against the end of the buffer when it sees that
+ * character. The contents do not move for the lifetime of the object.
+ *
+ * The memory holding a mapped file's contents can be given back once they
+ * have been scanned (see release), so it does not grow with the file.
+ */
+class SourceBuffer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Character following the contents of the file. Any byte can be in the
+   * file, this one included, so it only marks where the end might be.
+   */
+  static constexpr char SENTINEL = static_cast<char>(-1);
+
+  /** File name which selects standard input. */
+  static const std::string STANDARD_INPUT;
+
+  /**
+   * Default constructor.
+   */
+  SourceBuffer() = delete;
+
+  /**
+   * Copy constructor
+   */
+  SourceBuffer(const SourceBuffer &) = delete;
+
+  /**
+   * Move constructor
+   */
+  SourceBuffer(SourceBuffer &&) = delete;
+
+  /**
+   * Constructor. Loads the given file.
+   *
+   * @param theFile
+   *          file to load, STANDARD_INPUT to read standard input
+   * @throw std::runtime_error
+   *          on error opening or reading the file
+   */
+  SourceBuffer(const std::string &theFile);
+
+  /**
+   * Destructor
+   */
+  ~SourceBuffer();
+
+  /**
+   * Copy assignment operator
+   */
+  SourceBuffer& operator=(const SourceBuffer &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  SourceBuffer& operator=(SourceBuffer &&) = delete;
+
+  /**
+   * Returns the first character of the file.
+   *
+   * @return start of the file contents
+   */
+  const char* getBegin() const noexcept;
+
+  /**
+   * Returns the end of the file contents, which is where SENTINEL is
+   * stored.
+   *
+   * @return end of the file contents
+   */
+  const char* getEnd() const noexcept;
+
+  /**
+   * Gives back the memory of the whole pages of a mapped file between the
+   * given characters. The contents stay readable, pages being read back
+   * from the file if used again. Does nothing if the file was not mapped.
+   *
+   * @param theBegin
+   *          first character no longer needed
+   * @param theEnd
+   *          character after the last one no longer needed, before
+   *          getEnd
+   */
+  void release(const char *theBegin, const char *theEnd) const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Maps the given regular file into memory.
+   *
+   * @param theFileDescriptor
+   *          open file
+   * @param theSize
+   *          size of the file, in bytes
+   * @return true on success, false if the file could not be mapped
+   */
+  bool map(int theFileDescriptor, std::size_t theSize) noexcept;
+
+  /**
+   * Reads the given file into myBuffer.
+   *
+   * @param theFileDescriptor
+   *          open file
+   * @throw std::runtime_error
+   *          on read error
+   */
+  void read(int theFileDescriptor);
+
+  /** Start of the file contents. */
+  const char *myBegin = nullptr;
+
+  /** Contents when the file could not be mapped. */
+  std::vector<char> myBuffer;
+
+  /** File name, for error messages. */
+  const std::string myFile;
+
+  /** Start of the mapping, null if the file was not mapped. */
+  void *myMapping = nullptr;
+
+  /** Size of the mapping, in bytes. */
+  std::size_t myMappingSize = 0;
+
+  /** Size of the file contents, in bytes. */
+  std::size_t mySize = 0;
+};
+
+#endif
@@ -5,8 +5,12 @@
  * @author Michael Albers
  */
 
+#include <algorithm>
+
 #include "Symbol.h"
 
+constexpr Symbol::Index Symbol::NO_INDEX;
+
 //*******************************************************
 // Symbol::Symbol
 //*******************************************************
@@ -22,14 +26,6 @@ Symbol::~Symbol()
 {
 }
 
-//*******************************************************
-// Symbol::addToFirstSet
-//*******************************************************
-void Symbol::addToFirstSet(std::shared_ptr<Symbol> theSymbol) noexcept
-{
-  myFirstSet.insert(theSymbol);
-}
-
 //*******************************************************
 // Symbol::getDerivesLambda
 //*******************************************************
@@ -39,17 +35,17 @@ bool Symbol::getDerivesLambda() const noexcept
 }
 
 //*******************************************************
-// Symbol::getFirstSet
+// Symbol::getIndex
 //*******************************************************
-const Symbol::SymbolSet& Symbol::getFirstSet() const noexcept
+Symbol::Index Symbol::getIndex() const noexcept
 {
-  return myFirstSet;
+  return myIndex;
 }
 
 //*******************************************************
 // Symbol::getName
 //*******************************************************
-std::string Symbol::getName() const noexcept
+const std::string& Symbol::getName() const noexcept
 {
   return myName;
 }
@@ -59,7 +55,7 @@ std::string Symbol::getName() const noexcept
 //*******************************************************
 bool Symbol::operator<(const Symbol &theRHS) const noexcept
 {
-  return getName() < theRHS.getName();
+  return myIndex < theRHS.myIndex;
 }
 
 //*******************************************************
@@ -76,7 +72,7 @@ std::ostream& operator<<(std::ostream &theOS, const Symbol &theSymbol)
 //*******************************************************
 bool Symbol::operator==(const Symbol &theRHS) const noexcept
 {
-  return getName() == theRHS.getName();
+  return myIndex == theRHS.myIndex;
 }
 
 //*******************************************************
@@ -95,16 +91,39 @@ void Symbol::setDerivesLambda(bool theDerivesLambda) noexcept
   myDerivesLambda = theDerivesLambda;
 }
 
+//*******************************************************
+// Symbol::setIndex
+//*******************************************************
+void Symbol::setIndex(Index theIndex) noexcept
+{
+  myIndex = theIndex;
+}
+
+//*******************************************************
+// Symbol::sortByName
+//*******************************************************
+Symbol::SymbolList Symbol::sortByName(const SymbolSet &theSet)
+{
+  SymbolList symbols(theSet.begin(), theSet.end());
+  std::sort(symbols.begin(), symbols.end(),
+            [](const std::shared_ptr<Symbol> &theLHS,
+               const std::shared_ptr<Symbol> &theRHS)
+            {
+              return theLHS->getName() < theRHS->getName();
+            });
+  return symbols;
+}
+
 //*******************************************************
 // SymbolCompare::operator()
 //*******************************************************
-bool SymbolCompare::operator()(const std::shared_ptr<Symbol> theLHS,
-                               const std::shared_ptr<Symbol> theRHS)
+bool SymbolCompare::operator()(const std::shared_ptr<Symbol> &theLHS,
+                               const std::shared_ptr<Symbol> &theRHS)
   const noexcept
 {
   if (theLHS.get() && theRHS.get())
   {
-    return *theLHS < *theRHS;
+    return theLHS->getIndex() < theRHS->getIndex();
   }
   else
   {
@@ -134,9 +153,11 @@ std::ostream& operator<<(std::ostream &theOS, const Symbol::SymbolList &theList)
 //*******************************************************
 std::ostream& operator<<(std::ostream &theOS, const Symbol::SymbolSet &theSet)
 {
+  // Sets are ordered by index, but printed by name.
+  auto symbols = Symbol::sortByName(theSet);
   theOS << "{";
-  auto iter = theSet.begin();
-  for (auto ii = 0u; iter != theSet.end(); ++iter, ++ii)
+  auto iter = symbols.begin();
+  for (auto ii = 0u; iter != symbols.end(); ++iter, ++ii)
   {
     if (ii > 0)
     {
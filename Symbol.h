@@ -8,6 +8,7 @@
  * @author Michael Albers
  */
 
+#include <cstdint>
 #include <ostream>
 #include <memory>
 #include <set>
@@ -22,16 +23,18 @@ class SymbolCompare
   public:
 
   /**
-   * Comparison operator for use with shared_ptr.
+   * Comparison operator for use with shared_ptr. Orders symbols by index
+   * (see Symbol::getIndex), so only registered symbols and lambda (which
+   * has no index, so orders last) can be kept in a SymbolSet.
    *
    * @param theLHS
-   *          lhs of lhs == rhs
+   *          lhs of lhs < rhs
    * @param theRHS
-   *          rhs of lhs == rhs
-   * @param true if two Symbols are equal
+   *          rhs of lhs < rhs
+   * @param true if theLHS orders before theRHS
    */
-  bool operator()(const std::shared_ptr<Symbol> theLHS,
-                  const std::shared_ptr<Symbol> theRHS) const noexcept;
+  bool operator()(const std::shared_ptr<Symbol> &theLHS,
+                  const std::shared_ptr<Symbol> &theRHS) const noexcept;
 };
 
 /**
@@ -44,9 +47,17 @@ class Symbol
   // ************************************************************
   public:
 
+  /**
+   * Dense index of a symbol within its grammar (see SymbolRegistry).
+   */
+  using Index = uint16_t;
+
   using SymbolList = std::vector<std::shared_ptr<Symbol>>;
   using SymbolSet = std::set<std::shared_ptr<Symbol>, SymbolCompare>;
 
+  /** Index of a symbol which hasn't been registered. */
+  static constexpr Index NO_INDEX = UINT16_MAX;
+
   /**
    * Stream insertion operator.
    *
@@ -112,7 +123,7 @@ class Symbol
   Symbol& operator=(Symbol&&) = default;
 
   /**
-   * Less-than operator for use with shared_ptr.
+   * Less-than operator for use with shared_ptr. Compares indices.
    *
    * @param theRHS
    *          rhs of this < rhs
@@ -121,7 +132,7 @@ class Symbol
   virtual bool operator<(const Symbol &theRHS) const noexcept;
 
   /**
-   * Equality operator.
+   * Equality operator. Compares indices.
    *
    * @param theRHS
    *          rhs of this == rhs
@@ -129,14 +140,6 @@ class Symbol
    */
   virtual bool operator==(const Symbol &theRHS) const noexcept;
 
-  /**
-   * Adds the given symbol to the first set.
-   *
-   * @param theSymbol
-   *          symbol to add
-   */
-  virtual void addToFirstSet(std::shared_ptr<Symbol> theSymbol) noexcept;
-
   /**
    * Returns true if this symbol derives lambda
    *
@@ -145,18 +148,29 @@ class Symbol
   virtual bool getDerivesLambda() const noexcept;
 
   /**
-   * Returns the first set for this symbol
+   * Returns the symbol's index within its grammar.
    *
-   * @return the first set for this symbol
+   * @return symbol index, NO_INDEX if the symbol isn't registered or is
+   *         lambda (see SymbolRegistry::getIndex)
    */
-  virtual const SymbolSet& getFirstSet() const noexcept;
+  Index getIndex() const noexcept;
 
   /**
    * Returns the symbol's name.
    *
    * @return symbol's name
    */
-  virtual std::string getName() const noexcept;
+  virtual const std::string& getName() const noexcept;
+
+  /**
+   * Returns the given symbols sorted by name, which is the order symbols
+   * are printed in.
+   *
+   * @param theSet
+   *          symbols to sort
+   * @return symbols in name order
+   */
+  static SymbolList sortByName(const SymbolSet &theSet);
 
   /**
    * Stream insertion operator.
@@ -178,6 +192,15 @@ class Symbol
    */
   virtual void setDerivesLambda(bool theDerivesLambda) noexcept;
 
+  /**
+   * Sets the symbol's index. Called by SymbolRegistry as the symbol is
+   * registered.
+   *
+   * @param theIndex
+   *          symbol index
+   */
+  void setIndex(Index theIndex) noexcept;
+
   // ************************************************************
   // Protected
   // ************************************************************
@@ -200,8 +223,8 @@ class Symbol
   /** Does this symbol eventually derive lambda? */
   bool myDerivesLambda = false;
 
-  /** First set for this symbol. */
-  SymbolSet myFirstSet;
+  /** Index within the grammar. */
+  Index myIndex = NO_INDEX;
 
   /** Symbol name */
   const std::string myName;
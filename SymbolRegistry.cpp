@@ -0,0 +1,157 @@
+/**
+ * @file SymbolRegistry.cpp
+ * @brief Implementation of SymbolRegistry class
+ *
+ * @author Michael Albers
+ */
+
+#include <stdexcept>
+
+#include "SymbolRegistry.h"
+
+constexpr uint32_t SymbolRegistry::NUMBER_KINDS;
+
+//*******************************************************
+// SymbolRegistry::add
+//*******************************************************
+Symbol::Index SymbolRegistry::add(std::shared_ptr<Symbol> theSymbol,
+                                  Kind theKind)
+{
+  auto kind = static_cast<uint32_t>(theKind);
+  if (! myKinds.empty() && theKind < myKinds.back())
+  {
+    throw std::runtime_error{"Symbol '" + theSymbol->getName() +
+        "' registered out of order."};
+  }
+  if (mySymbols.size() >= Symbol::NO_INDEX)
+  {
+    throw std::runtime_error{"Too many grammar symbols, at most " +
+        std::to_string(Symbol::NO_INDEX) + " are supported."};
+  }
+
+  Symbol::Index index = mySymbols.size();
+  if (! myIndices.emplace(theSymbol->getName(), index).second)
+  {
+    throw std::runtime_error{"Symbol '" + theSymbol->getName() +
+        "' is defined more than once."};
+  }
+
+  // Kinds with no symbols get an empty range where they would have been.
+  auto firstNewKind = myKinds.empty() ?
+    0 : static_cast<uint32_t>(myKinds.back()) + 1;
+  for (auto ii = firstNewKind; ii <= kind; ++ii)
+  {
+    myBegins[ii] = index;
+    myEnds[ii] = index;
+  }
+  for (auto ii = kind + 1; ii < NUMBER_KINDS; ++ii)
+  {
+    myBegins[ii] = index + 1;
+    myEnds[ii] = index + 1;
+  }
+  myEnds[kind] = index + 1;
+
+  if (theKind != Kind::Lambda)
+  {
+    theSymbol->setIndex(index);
+  }
+  myKinds.push_back(theKind);
+  myNames.push_back(theSymbol->getName());
+  mySymbols.push_back(theSymbol);
+  return index;
+}
+
+//*******************************************************
+// SymbolRegistry::find
+//*******************************************************
+Symbol::Index SymbolRegistry::find(const std::string &theName) const noexcept
+{
+  auto indexIter = myIndices.find(theName);
+  return indexIter == myIndices.end() ? Symbol::NO_INDEX : indexIter->second;
+}
+
+//*******************************************************
+// SymbolRegistry::getBegin
+//*******************************************************
+Symbol::Index SymbolRegistry::getBegin(Kind theKind) const noexcept
+{
+  return myBegins[static_cast<uint32_t>(theKind)];
+}
+
+//*******************************************************
+// SymbolRegistry::getEnd
+//*******************************************************
+Symbol::Index SymbolRegistry::getEnd(Kind theKind) const noexcept
+{
+  return myEnds[static_cast<uint32_t>(theKind)];
+}
+
+//*******************************************************
+// SymbolRegistry::getIndex
+//*******************************************************
+Symbol::Index SymbolRegistry::getIndex(const Symbol &theSymbol) const noexcept
+{
+  auto lambda = getLambda();
+  if (lambda < getEnd(Kind::Lambda) && mySymbols[lambda].get() == &theSymbol)
+  {
+    return lambda;
+  }
+  return theSymbol.getIndex();
+}
+
+//*******************************************************
+// SymbolRegistry::getKind
+//*******************************************************
+SymbolRegistry::Kind SymbolRegistry::getKind(Symbol::Index theIndex)
+  const noexcept
+{
+  return myKinds[theIndex];
+}
+
+//*******************************************************
+// SymbolRegistry::getLambda
+//*******************************************************
+Symbol::Index SymbolRegistry::getLambda() const noexcept
+{
+  return getBegin(Kind::Lambda);
+}
+
+//*******************************************************
+// SymbolRegistry::getName
+//*******************************************************
+const std::string& SymbolRegistry::getName(Symbol::Index theIndex)
+  const noexcept
+{
+  return myNames[theIndex];
+}
+
+//*******************************************************
+// SymbolRegistry::getNumberSymbols
+//*******************************************************
+uint32_t SymbolRegistry::getNumberSymbols() const noexcept
+{
+  return mySymbols.size();
+}
+
+//*******************************************************
+// SymbolRegistry::getSymbol
+//*******************************************************
+const std::shared_ptr<Symbol>& SymbolRegistry::getSymbol(
+  Symbol::Index theIndex) const noexcept
+{
+  return mySymbols[theIndex];
+}
+
+//*******************************************************
+// SymbolRegistry::getSymbols
+//*******************************************************
+Symbol::SymbolSet SymbolRegistry::getSymbols(Kind theKind) const
+{
+  // Indices are in order, so each insert goes at the end.
+  Symbol::SymbolSet symbols;
+  for (auto index = getBegin(theKind); index < getEnd(theKind); ++index)
+  {
+    symbols.insert(symbols.end(), mySymbols[index]);
+  }
+  return symbols;
+}
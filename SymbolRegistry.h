@@ -0,0 +1,210 @@
+#ifndef SYMBOLREGISTRY_H
+#define SYMBOLREGISTRY_H
+
+/**
+ * @file SymbolRegistry.h
+ * @brief Defines the class which numbers the symbols of a grammar.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "Symbol.h"
+
+/**
+ * Interns the symbols of a grammar, giving each a dense index (see
+ * Symbol::getIndex) and keeping its name and kind in tables indexed by it.
+ * Symbols of one kind are registered together, so each kind covers a
+ * contiguous range of indices: terminals, lambda, non-terminals, then action
+ * symbols.
+ *
+ * Lambda is one object shared by every grammar, so its index is kept only
+ * in the registry (see getIndex and getLambda), never set in the symbol.
+ */
+class SymbolRegistry
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Kinds of symbols, in the order they are registered. */
+  enum class Kind : uint8_t
+  {
+    Terminal,
+    Lambda,
+    NonTerminal,
+    Action
+  };
+
+  /**
+   * Default constructor
+   */
+  SymbolRegistry() = default;
+
+  /**
+   * Copy constructor
+   */
+  SymbolRegistry(const SymbolRegistry&) = default;
+
+  /**
+   * Move constructor
+   */
+  SymbolRegistry(SymbolRegistry&&) = default;
+
+  /**
+   * Destructor
+   */
+  ~SymbolRegistry() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  SymbolRegistry& operator=(const SymbolRegistry&) = default;
+
+  /**
+   * Move assignment operator
+   */
+  SymbolRegistry& operator=(SymbolRegistry&&) = default;
+
+  /**
+   * Registers the given symbol, setting its index.
+   *
+   * @param theSymbol
+   *          symbol to register
+   * @param theKind
+   *          kind of symbol
+   * @return index of the symbol
+   * @throws std::runtime_error
+   *          if the name is already registered, the kind is out of order or
+   *          there are too many symbols
+   */
+  Symbol::Index add(std::shared_ptr<Symbol> theSymbol, Kind theKind);
+
+  /**
+   * Returns the index of the symbol with the given name.
+   *
+   * @param theName
+   *          symbol name
+   * @return symbol index, Symbol::NO_INDEX if there is no such symbol
+   */
+  Symbol::Index find(const std::string &theName) const noexcept;
+
+  /**
+   * Returns the first index of the given kind.
+   *
+   * @param theKind
+   *          kind of symbol
+   * @return first index of the kind
+   */
+  Symbol::Index getBegin(Kind theKind) const noexcept;
+
+  /**
+   * Returns one past the last index of the given kind.
+   *
+   * @param theKind
+   *          kind of symbol
+   * @return end index of the kind
+   */
+  Symbol::Index getEnd(Kind theKind) const noexcept;
+
+  /**
+   * Returns the index of the given registered symbol.
+   *
+   * @param theSymbol
+   *          symbol, lambda included
+   * @return symbol index
+   */
+  Symbol::Index getIndex(const Symbol &theSymbol) const noexcept;
+
+  /**
+   * Returns the kind of the given symbol.
+   *
+   * @param theIndex
+   *          symbol index
+   * @return kind of symbol
+   */
+  Kind getKind(Symbol::Index theIndex) const noexcept;
+
+  /**
+   * Returns the index of lambda, the one after the last terminal. Only
+   * valid once lambda has been registered.
+   *
+   * @return lambda's index
+   */
+  Symbol::Index getLambda() const noexcept;
+
+  /**
+   * Returns the name of the given symbol.
+   *
+   * @param theIndex
+   *          symbol index
+   * @return symbol name
+   */
+  const std::string& getName(Symbol::Index theIndex) const noexcept;
+
+  /**
+   * Returns the number of registered symbols.
+   *
+   * @return number of symbols
+   */
+  uint32_t getNumberSymbols() const noexcept;
+
+  /**
+   * Returns the given symbol.
+   *
+   * @param theIndex
+   *          symbol index
+   * @return symbol
+   */
+  const std::shared_ptr<Symbol>& getSymbol(Symbol::Index theIndex)
+    const noexcept;
+
+  /**
+   * Returns the registered symbols of the given kind.
+   *
+   * @param theKind
+   *          kind of symbol
+   * @return symbols of the kind
+   */
+  Symbol::SymbolSet getSymbols(Kind theKind) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Number of Kind values. */
+  static constexpr uint32_t NUMBER_KINDS =
+    static_cast<uint32_t>(Kind::Action) + 1;
+
+  /** First index of each kind, indexed by Kind. */
+  Symbol::Index myBegins[NUMBER_KINDS] = {0, 0, 0, 0};
+
+  /** One past the last index of each kind, indexed by Kind. */
+  Symbol::Index myEnds[NUMBER_KINDS] = {0, 0, 0, 0};
+
+  /** Symbol indices by name. */
+  std::unordered_map<std::string, Symbol::Index> myIndices;
+
+  /** Symbol kinds, by index. */
+  std::vector<Kind> myKinds;
+
+  /** Symbol names, by index. */
+  std::vector<std::string> myNames;
+
+  /** Symbols, by index. */
+  std::vector<std::shared_ptr<Symbol>> mySymbols;
+};
+
+#endif
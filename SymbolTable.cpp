@@ -8,6 +8,7 @@
 #include <exception>
 #include <cstring>
 #include <cctype>
+#include <stdexcept>
 
 #include "SymbolTable.h"
 
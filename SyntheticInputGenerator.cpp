@@ -0,0 +1,217 @@
+/**
+ * @file SyntheticInputGenerator.cpp
+ * @brief Implementation of SyntheticInputGenerator class
+ *
+ * @author Michael Albers
+ */
+
+#include <climits>
+#include <stdexcept>
+
+#include "ScannerTable.h"
+#include "SyntheticInputGenerator.h"
+
+constexpr uint32_t SyntheticInputGenerator::FIRST_KEYWORD_ID;
+
+//*******************************************************
+// SyntheticInputGenerator::SyntheticInputGenerator
+//*******************************************************
+SyntheticInputGenerator::SyntheticInputGenerator(uint32_t theSize) :
+  mySize(theSize)
+{
+  if (0 == mySize)
+  {
+    throw std::runtime_error("Size must be at least 1.");
+  }
+}
+
+//*******************************************************
+// SyntheticInputGenerator::generateByteSource
+//*******************************************************
+void SyntheticInputGenerator::generateByteSource(std::ostream &theOS) const
+{
+  static constexpr uint32_t CHARACTERS_PER_LINE = 16;
+
+  for (uint32_t ii = 0; ii < mySize; ++ii)
+  {
+    for (uint32_t character = 0; character <= UCHAR_MAX; ++character)
+    {
+      theOS << static_cast<char>(character)
+            << ((character + 1) % CHARACTERS_PER_LINE == 0 ? '\n' : ' ');
+    }
+  }
+  theOS << static_cast<char>(UCHAR_MAX);
+}
+
+//*******************************************************
+// SyntheticInputGenerator::generateGrammar
+//*******************************************************
+void SyntheticInputGenerator::generateGrammar(std::ostream &theOS,
+                                              Shape theShape) const
+{
+  if (mySize > ScannerTable::PackedEntry::MAX_TERMINAL_ID - FIRST_KEYWORD_ID)
+  {
+    throw std::runtime_error("Grammar size must be at most " +
+                             std::to_string(
+                               ScannerTable::PackedEntry::MAX_TERMINAL_ID -
+                               FIRST_KEYWORD_ID) + ".");
+  }
+
+  generateScanner(theOS);
+
+  theOS << "<system goal> -> " << getNonTerminal(0) << " $" << std::endl;
+  for (uint32_t ii = 0; ii < mySize; ++ii)
+  {
+    auto nonTerminal = getNonTerminal(ii);
+    auto next = getNonTerminal(ii + 1);
+    switch (theShape)
+    {
+      case Shape::Chain:
+        theOS << nonTerminal << " ->";
+        if (ii + 1 < mySize)
+        {
+          theOS << " " << next;
+        }
+        theOS << " " << getTerminal(ii) << std::endl;
+        break;
+
+      case Shape::Cycle:
+        theOS << nonTerminal << " -> " << next << " " << getTerminal(ii)
+              << std::endl
+              << nonTerminal << " -> " << getTerminal(ii) << " " << next
+              << std::endl;
+        break;
+
+      case Shape::Sparse:
+        theOS << nonTerminal << " -> " << getTerminal(ii);
+        if (ii + 1 < mySize)
+        {
+          theOS << " " << next;
+        }
+        theOS << std::endl;
+        break;
+    }
+    theOS << nonTerminal << " ->" << std::endl;
+  }
+
+  theOS << "-----" << std::endl
+        << "<system goal>" << std::endl;
+}
+
+//*******************************************************
+// SyntheticInputGenerator::generateMicroSource
+//*******************************************************
+void SyntheticInputGenerator::generateMicroSource(std::ostream &theOS,
+                                                  Blocks theBlocks) const
+{
+  static constexpr uint32_t NUMBER_VARIABLES = 10;
+  static constexpr uint32_t LINES_PER_GROUP = 6;
+
+  auto variable = [](uint32_t theVariable)
+  {
+    return "a" + std::to_string(theVariable % NUMBER_VARIABLES);
+  };
+
+  theOS << "begin" << std::endl
+        << "  read(";
+  for (uint32_t ii = 0; ii < NUMBER_VARIABLES; ++ii)
+  {
+    theOS << (ii > 0 ? ", " : "") << variable(ii);
+  }
+  theOS << ");" << std::endl;
+
+  // Groups of statements, then single assignments to fill the size.
+  uint32_t line = 3;
+  for (uint32_t ii = 0; line + LINES_PER_GROUP <= mySize; ++ii)
+  {
+    theOS << "  " << variable(ii) << " := " << variable(ii + 1) << " + "
+          << ii << " - (" << variable(ii + 2) << " + 1);" << std::endl
+          << "  write(" << variable(ii + 3) << " + 1, " << variable(ii)
+          << ");" << std::endl;
+    switch (theBlocks)
+    {
+      case Blocks::LineComments:
+        theOS << "  begin -- group " << ii << std::endl
+              << "    ";
+        break;
+
+      case Blocks::BlockComments:
+        // A scan starting on the second line, inside the comment, finds a
+        // stray '}'.
+        theOS << "  begin { group " << ii << ": " << variable(ii)
+              << " := 0;" << std::endl
+              << "    } ";
+        break;
+
+      case Blocks::None:
+        theOS << "  -- group " << ii << std::endl
+              << "  ";
+        break;
+    }
+    auto indent = (Blocks::None == theBlocks ? "  " : "    ");
+    theOS << variable(ii + 4) << " := " << variable(ii + 5)
+          << " - " << ii << ";" << std::endl
+          << indent << "read(" << variable(ii + 6) << ");" << std::endl
+          << (Blocks::None == theBlocks ? "  -- end" : "  end") << std::endl;
+    line += LINES_PER_GROUP;
+  }
+  for (; line < mySize; ++line)
+  {
+    theOS << "  " << variable(line) << " := " << line << ";" << std::endl;
+  }
+  theOS << "end" << std::endl;
+}
+
+//*******************************************************
+// SyntheticInputGenerator::generateScanner
+//*******************************************************
+void SyntheticInputGenerator::generateScanner(std::ostream &theOS) const
+{
+  theOS << "1 Id" << std::endl;
+  for (uint32_t ii = 0; ii < mySize; ++ii)
+  {
+    theOS << FIRST_KEYWORD_ID + ii << " " << getTerminal(ii) << " k" << ii
+          << std::endl;
+  }
+
+  // Words of letters and digits, separated by whitespace.
+  theOS << "-----" << std::endl
+        << "letter  digit   whitespace EOL     Other" << std::endl
+        << "1:MA:0  E       2:MNA:0    2:MNA:0 E" << std::endl
+        << "1:MA:0  1:MA:0  0:HR:1     0:HR:1  E" << std::endl
+        << "0:HR:98 0:HR:98 2:MNA:0    2:MNA:0 E" << std::endl
+        << "-----" << std::endl;
+}
+
+//*******************************************************
+// SyntheticInputGenerator::generateSparseSource
+//*******************************************************
+void SyntheticInputGenerator::generateSparseSource(std::ostream &theOS)
+  const
+{
+  static constexpr uint32_t KEYWORDS_PER_LINE = 10;
+
+  for (uint32_t ii = 0; ii < mySize; ++ii)
+  {
+    theOS << "k" << ii
+          << ((ii + 1) % KEYWORDS_PER_LINE == 0 || ii + 1 == mySize ?
+              "\n" : " ");
+  }
+}
+
+//*******************************************************
+// SyntheticInputGenerator::getNonTerminal
+//*******************************************************
+std::string SyntheticInputGenerator::getNonTerminal(uint32_t theNonTerminal)
+  const
+{
+  return "<n" + std::to_string(theNonTerminal % mySize) + ">";
+}
+
+//*******************************************************
+// SyntheticInputGenerator::getTerminal
+//*******************************************************
+std::string SyntheticInputGenerator::getTerminal(uint32_t theKeyword)
+{
+  return "K" + std::to_string(theKeyword);
+}
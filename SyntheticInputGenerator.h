@@ -0,0 +1,203 @@
+#ifndef SYNTHETICINPUTGENERATOR_H
+#define SYNTHETICINPUTGENERATOR_H
+
+/**
+ * @file SyntheticInputGenerator.h
+ * @brief Generates grammars and sources for benchmarking the compiler.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+/**
+ * Writes grammar files of a chosen shape and size, and sources, for
+ * benchmarks of parts of the compiler too fast to measure on the grammars
+ * in grammars/ and sources in testSrc/.
+ *
+ * The grammars share a small scanner table: words of letters and digits
+ * are Id, unless they are one of the grammar's keywords (k0, k1, ...),
+ * which are reserved words each with its own terminal.
+ */
+class SyntheticInputGenerator
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /** Blocks of generated Micro sources, see generateMicroSource. */
+  enum class Blocks
+  {
+    /** Nested blocks starting with a line comment. */
+    LineComments,
+
+    /**
+     * Nested blocks starting with a comment over two lines, for
+     * grammars/MicroGrammarBlockComments.txt.
+     */
+    BlockComments,
+
+    /**
+     * No nested blocks, their statements follow a line comment instead, for
+     * grammars/MicroGrammarNoActions.txt.
+     */
+    None
+  };
+
+  /** Shapes of generated grammar. */
+  enum class Shape
+  {
+    /**
+     * <n i> -> <n i+1> Ki, each with an empty alternative. First sets
+     * flow down a chain as long as the grammar.
+     */
+    Chain,
+
+    /**
+     * <n i> -> <n i+1> Ki and <n i> -> Ki <n i+1>, each with an empty
+     * alternative, the last non-terminal leading back to the first. All of
+     * the non-terminals are in one cycle of first and of follow sets.
+     */
+    Cycle,
+
+    /**
+     * <n i> -> Ki <n i+1>, each with an empty alternative. Each row of the
+     * predict table has two entries, see generateSparseSource.
+     */
+    Sparse
+  };
+
+  /**
+   * Default constructor
+   */
+  SyntheticInputGenerator() = delete;
+
+  /**
+   * Copy constructor
+   */
+  SyntheticInputGenerator(const SyntheticInputGenerator&) = default;
+
+  /**
+   * Move constructor
+   */
+  SyntheticInputGenerator(SyntheticInputGenerator&&) = default;
+
+  /**
+   * Constructor.
+   *
+   * @param theSize
+   *          number of non-terminals (besides the start symbol) and
+   *          keywords of the generated grammars, lines of the generated
+   *          Micro sources, or repetitions of the byte sources
+   * @throws std::runtime_error
+   *          if theSize is 0
+   */
+  SyntheticInputGenerator(uint32_t theSize);
+
+  /**
+   * Destructor
+   */
+  ~SyntheticInputGenerator() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  SyntheticInputGenerator& operator=(const SyntheticInputGenerator&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  SyntheticInputGenerator& operator=(SyntheticInputGenerator&&) = delete;
+
+  /**
+   * Writes a source of every byte, each followed by a space and sixteen to
+   * a line, the size times over, then one more 0xFF byte to end the file
+   * with the character SourceBuffer stores after it. Scanning it looks up
+   * every character class of a scanner table.
+   *
+   * @param theOS
+   *          stream to write to
+   */
+  void generateByteSource(std::ostream &theOS) const;
+
+  /**
+   * Writes a grammar file.
+   *
+   * @param theOS
+   *          stream to write to
+   * @param theShape
+   *          shape of the grammar
+   * @throws std::runtime_error
+   *          if the size is too large for the scanner's terminal ids
+   */
+  void generateGrammar(std::ostream &theOS, Shape theShape) const;
+
+  /**
+   * Writes a valid source of grammars/MicroGrammar.txt, of the size in
+   * lines (at least 3): reads, writes and assignments of ten variables,
+   * some in nested blocks unless theBlocks is Blocks::None.
+   *
+   * @param theOS
+   *          stream to write to
+   * @param theBlocks
+   *          how the nested blocks are written, if at all
+   */
+  void generateMicroSource(std::ostream &theOS,
+                           Blocks theBlocks = Blocks::LineComments) const;
+
+  /**
+   * Writes a source of the Sparse grammar, predicting each of its
+   * productions: the keywords, in order.
+   *
+   * @param theOS
+   *          stream to write to
+   */
+  void generateSparseSource(std::ostream &theOS) const;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Terminal id of the first keyword, clear of the built-in ids. */
+  static constexpr uint32_t FIRST_KEYWORD_ID = 100;
+
+  /**
+   * Returns the name of the given non-terminal.
+   *
+   * @param theNonTerminal
+   *          non-terminal number, taken modulo the size
+   * @return non-terminal name
+   */
+  std::string getNonTerminal(uint32_t theNonTerminal) const;
+
+  /**
+   * Returns the terminal name of the given keyword.
+   *
+   * @param theKeyword
+   *          keyword number
+   * @return terminal name
+   */
+  static std::string getTerminal(uint32_t theKeyword);
+
+  /**
+   * Writes the terminals and scanner table sections of a grammar file.
+   *
+   * @param theOS
+   *          stream to write to
+   */
+  void generateScanner(std::ostream &theOS) const;
+
+  /** Number of non-terminals and keywords. */
+  const uint32_t mySize;
+};
+
+#endif
@@ -0,0 +1,130 @@
+/**
+ * @file SyntheticInputGeneratorMain.cpp
+ * @brief Entry point of the synthetic benchmark input generator
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "SyntheticInputGenerator.h"
+
+static void usage(char *theProgramName);
+
+int main(int argc, char **argv)
+{
+  try
+  {
+    if (argc != 4)
+    {
+      throw std::runtime_error("No kind, size and/or output file provided.");
+    }
+
+    std::string kind(argv[1]);
+    char *sizeEnd = nullptr;
+    auto size = std::strtoul(argv[2], &sizeEnd, 10);
+    std::string outputFile(argv[3]);
+    if (sizeEnd == argv[2] || *sizeEnd != '\0')
+    {
+      throw std::runtime_error("Invalid size '" + std::string(argv[2]) +
+                               "'.");
+    }
+
+    SyntheticInputGenerator generator(size);
+
+    std::ofstream output(outputFile);
+    if (! output)
+    {
+      throw std::runtime_error("Failed to open '" + outputFile + "'.");
+    }
+
+    if ("chain" == kind)
+    {
+      generator.generateGrammar(output,
+                                SyntheticInputGenerator::Shape::Chain);
+    }
+    else if ("cycle" == kind)
+    {
+      generator.generateGrammar(output,
+                                SyntheticInputGenerator::Shape::Cycle);
+    }
+    else if ("sparse" == kind)
+    {
+      generator.generateGrammar(output,
+                                SyntheticInputGenerator::Shape::Sparse);
+    }
+    else if ("sparse-source" == kind)
+    {
+      generator.generateSparseSource(output);
+    }
+    else if ("byte-source" == kind)
+    {
+      generator.generateByteSource(output);
+    }
+    else if ("micro-source" == kind)
+    {
+      generator.generateMicroSource(output);
+    }
+    else if ("micro-block-source" == kind)
+    {
+      generator.generateMicroSource(
+        output, SyntheticInputGenerator::Blocks::BlockComments);
+    }
+    else if ("micro-flat-source" == kind)
+    {
+      generator.generateMicroSource(output,
+                                    SyntheticInputGenerator::Blocks::None);
+    }
+    else
+    {
+      throw std::runtime_error("Unknown kind '" + kind + "'.");
+    }
+
+    output.close();
+    if (! output)
+    {
+      throw std::runtime_error("Failed to write '" + outputFile + "'.");
+    }
+  }
+  catch (const std::exception &exception)
+  {
+    if (std::string(exception.what()).size() > 0)
+    {
+      std::cerr << argv[0] << ": error: " << exception.what() << std::endl;
+    }
+    usage(argv[0]);
+    return 1;
+  }
+
+  return 0;
+}
+
+void usage(char *theProgramName)
+{
+  std::cerr << "Usage: " << theProgramName
+            << " [kind] [size] [output file]" << std::endl
+            << " Writes a synthetic input for the benchmarks. Kinds:"
+            << std::endl
+            << " chain  grammar whose first sets flow down a chain of size"
+            << " non-terminals" << std::endl
+            << " cycle  grammar whose size non-terminals are in one cycle of"
+            << " first and follow sets" << std::endl
+            << " sparse grammar whose predict table has two entries in each"
+            << " of its size rows" << std::endl
+            << " sparse-source  source of the sparse grammar of the same"
+            << " size" << std::endl
+            << " micro-source  source of grammars/MicroGrammar.txt of size"
+            << " lines" << std::endl
+            << " micro-block-source  source of"
+            << " grammars/MicroGrammarBlockComments.txt of size lines"
+            << std::endl
+            << " micro-flat-source  source of"
+            << " grammars/MicroGrammarNoActions.txt of size lines"
+            << std::endl
+            << " byte-source  every byte, size times over"
+            << std::endl;
+}
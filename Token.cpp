@@ -10,9 +10,42 @@
 //*******************************************************
 // Token::append
 //*******************************************************
-void Token::append(char theCharacter) noexcept
+void Token::append(const char *theCharacter) noexcept
 {
-  myToken.push_back(theCharacter);
+  if (0 == myLength)
+  {
+    myText = theCharacter;
+  }
+  else if (myText + myLength != theCharacter || ! myOwnedText.empty())
+  {
+    // Characters were skipped, the text has to be copied from here on.
+    if (myOwnedText.empty())
+    {
+      myOwnedText.assign(myText, myLength);
+    }
+    myOwnedText.push_back(*theCharacter);
+  }
+  ++myLength;
+}
+
+//*******************************************************
+// Token::append
+//*******************************************************
+void Token::append(const char *theText, uint32_t theLength) noexcept
+{
+  if (0 == myLength)
+  {
+    myText = theText;
+  }
+  else if (myText + myLength != theText || ! myOwnedText.empty())
+  {
+    if (myOwnedText.empty())
+    {
+      myOwnedText.assign(myText, myLength);
+    }
+    myOwnedText.append(theText, theLength);
+  }
+  myLength += theLength;
 }
 
 //*******************************************************
@@ -23,7 +56,10 @@ void Token::clear() noexcept
   myColumn = 0;
   myLine = 0;
   myTerminal = nullptr;
-  myToken.clear();
+  myTerminalIndex = Symbol::NO_INDEX;
+  myLength = 0;
+  myText = nullptr;
+  myOwnedText.clear();
 }
 
 //*******************************************************
@@ -34,6 +70,14 @@ uint32_t Token::getColumn() const noexcept
   return myColumn;
 }
 
+//*******************************************************
+// Token::getLength
+//*******************************************************
+uint32_t Token::getLength() const noexcept
+{
+  return myLength;
+}
+
 //*******************************************************
 // Token::getLine
 //*******************************************************
@@ -45,17 +89,33 @@ uint32_t Token::getLine() const noexcept
 //*******************************************************
 // Token::getTerminal
 //*******************************************************
-std::shared_ptr<Symbol> Token::getTerminal() const noexcept
+const Symbol* Token::getTerminal() const noexcept
 {
   return myTerminal;
 }
 
+//*******************************************************
+// Token::getTerminalIndex
+//*******************************************************
+Symbol::Index Token::getTerminalIndex() const noexcept
+{
+  return myTerminalIndex;
+}
+
+//*******************************************************
+// Token::getText
+//*******************************************************
+const char* Token::getText() const noexcept
+{
+  return myOwnedText.empty() ? myText : myOwnedText.data();
+}
+
 //*******************************************************
 // Token::getToken
 //*******************************************************
 std::string Token::getToken() const noexcept
 {
-  return myToken;
+  return std::string(getText(), myLength);
 }
 
 //*******************************************************
@@ -70,9 +130,10 @@ void Token::setPosition(uint32_t theLine, uint32_t theColumn) noexcept
 //*******************************************************
 // Token::getToken
 //*******************************************************
-void Token::setTerminal(std::shared_ptr<Symbol> theTerminal) noexcept
+void Token::setTerminal(const Symbol *theTerminal) noexcept
 {
   myTerminal = theTerminal;
+  myTerminalIndex = theTerminal ? theTerminal->getIndex() : Symbol::NO_INDEX;
 }
 
 //*******************************************************
@@ -81,7 +142,8 @@ void Token::setTerminal(std::shared_ptr<Symbol> theTerminal) noexcept
 std::ostream& operator<<(std::ostream &theOS,
                          const Token &theToken) noexcept
 {
-  theOS << theToken.getToken() << " (" << theToken.getTerminal()->getName()
+  theOS.write(theToken.getText(), theToken.getLength());
+  theOS << " (" << theToken.getTerminal()->getName()
         << ") at " << theToken.getLine() << ":" << theToken.getColumn();
   return theOS;
 }
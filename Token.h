@@ -18,6 +18,11 @@
  * Class which defines a token. A token consists of the token which has
  * been scanned and the terminal symbol which is the grammatical representation
  * of this token.
+ *
+ * The token text is not copied, it refers to the characters in the source
+ * buffer the scanner read them from (see SourceBuffer), so that buffer must
+ * outlive the token. Only a token built from characters which are not
+ * contiguous in the source holds its own copy of the text.
  */
 class Token
 {
@@ -69,9 +74,24 @@ class Token
                                   const Token &theToken) noexcept;
 
   /**
-   * Appends the given character to the token.
+   * Appends the character at the given position to the token.
+   *
+   * @param theCharacter
+   *          character to append, must remain valid for the lifetime of the
+   *          token
+   */
+  void append(const char *theCharacter) noexcept;
+
+  /**
+   * Appends the characters at the given position to the token.
+   *
+   * @param theText
+   *          characters to append, must remain valid for the lifetime of the
+   *          token
+   * @param theLength
+   *          number of characters to append
    */
-  void append(char theCharacter) noexcept;
+  void append(const char *theText, uint32_t theLength) noexcept;
 
   /**
    * Clears the terminal (nulls it) and token (empty string).
@@ -85,6 +105,13 @@ class Token
    */
   uint32_t getColumn() const noexcept;
 
+  /**
+   * Returns the length of the token text.
+   *
+   * @return number of characters in the token
+   */
+  uint32_t getLength() const noexcept;
+
   /**
    * Returns the line on which this token appears.
    *
@@ -95,12 +122,26 @@ class Token
   /**
    * Returns the terminal symbol.
    *
-   * @return terminal symbol
+   * @return terminal symbol, null if not set
    */
-  std::shared_ptr<Symbol> getTerminal() const noexcept;
+  const Symbol* getTerminal() const noexcept;
 
   /**
-   * Returns the token.
+   * Returns the index of the terminal symbol (see Symbol::getIndex).
+   *
+   * @return terminal index, Symbol::NO_INDEX if not set
+   */
+  Symbol::Index getTerminalIndex() const noexcept;
+
+  /**
+   * Returns the token text. The text is not null terminated, see getLength.
+   *
+   * @return token text
+   */
+  const char* getText() const noexcept;
+
+  /**
+   * Returns a copy of the token.
    *
    * @return token
    */
@@ -120,9 +161,9 @@ class Token
    * Sets the terminal symbol for this token.
    *
    * @param theTerminal
-   *          terminal symbol
+   *          terminal symbol, owned by the grammar
    */
-  void setTerminal(std::shared_ptr<Symbol> theTerminal) noexcept;
+  void setTerminal(const Symbol *theTerminal) noexcept;
 
   // ************************************************************
   // Protected
@@ -141,10 +182,19 @@ class Token
   uint32_t myLine = 0;
 
   /** Terminal symbol for this token. */
-  std::shared_ptr<Symbol> myTerminal;
+  const Symbol *myTerminal = nullptr;
+
+  /** Index of myTerminal. */
+  Symbol::Index myTerminalIndex = Symbol::NO_INDEX;
+
+  /** Number of characters in the token. */
+  uint32_t myLength = 0;
+
+  /** Start of the token text, in the source buffer or myOwnedText. */
+  const char *myText = nullptr;
 
-  /** Scanned string */
-  std::string myToken;
+  /** Copy of the token text if it isn't contiguous in the source. */
+  std::string myOwnedText;
 };
 
 #endif
@@ -0,0 +1,146 @@
+/**
+ * @file TraceFile.cpp
+ * @brief Implementation of TraceFile class
+ *
+ * @author Michael Albers
+ */
+
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Grammar.h"
+#include "SymbolRegistry.h"
+#include "TraceFile.h"
+
+constexpr uint32_t TraceFile::VERSION;
+constexpr uint8_t TraceFile::EOP_ELIDED;
+constexpr uint8_t TraceFile::BEFORE_EVENT;
+const char TraceFile::MAGIC[8] = {'U', 'C', 'P', 'T', 'R', 'A', 'C', 'E'};
+
+//*******************************************************
+// TraceFile::TraceFile
+//*******************************************************
+TraceFile::TraceFile(const std::string &theFile, const Grammar &theGrammar) :
+  myFile(theFile)
+{
+  int fileDescriptor = ::open(myFile.c_str(), O_RDONLY);
+  if (fileDescriptor < 0)
+  {
+    auto localErrno = errno;
+    throw std::runtime_error("Failed to open trace file '" + myFile + "': " +
+                             std::strerror(localErrno));
+  }
+
+  struct stat fileStatus;
+  if (::fstat(fileDescriptor, &fileStatus) == 0 &&
+      static_cast<std::size_t>(fileStatus.st_size) >= sizeof(Header))
+  {
+    void *mapping = ::mmap(nullptr, fileStatus.st_size, PROT_READ,
+                           MAP_PRIVATE, fileDescriptor, 0);
+    if (MAP_FAILED != mapping)
+    {
+      myMapping = mapping;
+      myMappingSize = fileStatus.st_size;
+    }
+  }
+
+  // The mapping stays valid once the file is closed.
+  ::close(fileDescriptor);
+
+  if (nullptr == myMapping)
+  {
+    throw std::runtime_error("Failed to map trace file '" + myFile + "'.");
+  }
+
+  Header header;
+  std::memcpy(&header, myMapping, sizeof(header));
+  auto expected = getHeader(theGrammar);
+  if (std::memcmp(header.myMagic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.myVersion != VERSION ||
+      header.myRecordSize != sizeof(Record))
+  {
+    ::munmap(myMapping, myMappingSize);
+    throw std::runtime_error("File '" + myFile + "' is not a parse trace, " +
+                             "or is from another version.");
+  }
+  if (header.myGrammarHash != expected.myGrammarHash ||
+      header.myNumberSymbols != expected.myNumberSymbols ||
+      header.myNumberProductions != expected.myNumberProductions)
+  {
+    ::munmap(myMapping, myMappingSize);
+    throw std::runtime_error("Trace file '" + myFile + "' was recorded " +
+                             "with another grammar.");
+  }
+
+  // A trace is only ever written a whole record at a time.
+  if ((myMappingSize - sizeof(Header)) % sizeof(Record) != 0)
+  {
+    ::munmap(myMapping, myMappingSize);
+    throw std::runtime_error("Trace file '" + myFile + "' is corrupt, " +
+                             "it ends part way through a record.");
+  }
+  myNumberRecords = (myMappingSize - sizeof(Header)) / sizeof(Record);
+}
+
+//*******************************************************
+// TraceFile::~TraceFile
+//*******************************************************
+TraceFile::~TraceFile()
+{
+  ::munmap(myMapping, myMappingSize);
+}
+
+//*******************************************************
+// TraceFile::begin
+//*******************************************************
+const TraceFile::Record* TraceFile::begin() const noexcept
+{
+  return reinterpret_cast<const Record*>(
+    static_cast<const char*>(myMapping) + sizeof(Header));
+}
+
+//*******************************************************
+// TraceFile::end
+//*******************************************************
+const TraceFile::Record* TraceFile::end() const noexcept
+{
+  return begin() + myNumberRecords;
+}
+
+//*******************************************************
+// TraceFile::getHeader
+//*******************************************************
+TraceFile::Header TraceFile::getHeader(const Grammar &theGrammar)
+{
+  Header header{};
+  std::memcpy(header.myMagic, MAGIC, sizeof(MAGIC));
+  header.myVersion = VERSION;
+  header.myRecordSize = sizeof(Record);
+  header.myNumberSymbols =
+    theGrammar.getSymbolRegistry().getNumberSymbols();
+  header.myNumberProductions = theGrammar.getProductions().size();
+  header.myGrammarHash = theGrammar.getHash();
+  return header;
+}
+
+//*******************************************************
+// TraceFile::getNumberTextRecords
+//*******************************************************
+std::size_t TraceFile::getNumberTextRecords(const Record &theRecord) noexcept
+{
+  return (theRecord.myValue + sizeof(Record) - 1) / sizeof(Record);
+}
+
+//*******************************************************
+// TraceFile::getName
+//*******************************************************
+const std::string& TraceFile::getName() const noexcept
+{
+  return myFile;
+}
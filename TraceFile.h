@@ -0,0 +1,250 @@
+#ifndef TRACEFILE_H
+#define TRACEFILE_H
+
+/**
+ * @file TraceFile.h
+ * @brief Defines the binary file a parse is recorded in.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+#include "Symbol.h"
+
+class Grammar;
+
+/**
+ * Binary record of the steps of a parse, written by TraceRecorder and
+ * replayed by TraceRenderer.
+ *
+ * The file is a Header followed by Records, all the same size. The first
+ * record is a Source record naming the source file, then there is one
+ * record per step. Source, Match and Error records are followed by their
+ * text (file name, token text or error message) in as many Text records as
+ * it takes. Error records are placed where the parse reported them: before
+ * the first step if while scanning the first token, before the record of
+ * a step if before its event (flagged BEFORE_EVENT), otherwise after the
+ * record of the step. Values
+ * are in the host's byte order. The records are only appended, so a file
+ * cut short by a failed parse still holds every step it recorded.
+ *
+ * This class maps an existing file for reading.
+ */
+class TraceFile
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Format version. Increment on any change to Header or Record.
+   */
+  static constexpr uint32_t VERSION = 3;
+
+  /** Steps of the parse, see ParseTracer. */
+  enum class Event : uint8_t
+  {
+    /** myValue is the production, myFlags EOP_ELIDED if it was. */
+    Predict,
+    /** mySymbol is the terminal, myValue the length of the text. */
+    Match,
+    /** mySymbol is the action symbol. */
+    Action,
+    /** End of production. */
+    EOP,
+    /** mySymbol was popped after a syntax error. */
+    Skip,
+    /** Text of the previous record, the whole record is text. */
+    Text,
+    /**
+     * The parse reported an error during the previous step. myValue is the
+     * length of the message, myLine/myColumn are the error's own, 0 if it
+     * has no location.
+     */
+    Error,
+    /** myValue is the length of the source file name. */
+    Source
+  };
+
+  /**
+   * One step of the parse.
+   */
+  class Record
+  {
+    public:
+
+    /** What happened. */
+    Event myEvent;
+
+    /** Event flags. */
+    uint8_t myFlags;
+
+    /** Symbol of the event, if any. */
+    Symbol::Index mySymbol;
+
+    /** Value of the event, if any. */
+    uint32_t myValue;
+
+    /**
+     * Line of the token: the look-ahead token of the step, or for Match
+     * the matched token. For Error, the line of the error.
+     */
+    uint32_t myLine;
+
+    /** Column of the token, see myLine. */
+    uint32_t myColumn;
+  };
+
+  static_assert(sizeof(Record) == 16, "Records are written as is.");
+
+  /** Record::myFlags of a Predict whose EOP was elided. */
+  static constexpr uint8_t EOP_ELIDED = 1;
+
+  /**
+   * Record::myFlags of an Error reported during a step before the step's
+   * event, such as a syntax error before its Skip.
+   */
+  static constexpr uint8_t BEFORE_EVENT = 1;
+
+  /**
+   * Start of the trace file.
+   */
+  class Header
+  {
+    public:
+
+    /** Identifies the file as a parse trace. */
+    char myMagic[8];
+
+    /** Format version, see VERSION. */
+    uint32_t myVersion;
+
+    /** Size of a Record, in bytes. */
+    uint32_t myRecordSize;
+
+    /** Number of symbols of the grammar parsed with. */
+    uint32_t myNumberSymbols;
+
+    /** Number of productions of the grammar parsed with. */
+    uint32_t myNumberProductions;
+
+    /** Grammar::getHash of the grammar parsed with. */
+    uint64_t myGrammarHash;
+  };
+
+  static_assert(sizeof(Header) % sizeof(Record) == 0,
+                "Records follow the header aligned.");
+
+  /**
+   * Returns a header for a trace of a parse with the given grammar.
+   *
+   * @param theGrammar
+   *          grammar parsed with
+   * @return header
+   */
+  static Header getHeader(const Grammar &theGrammar);
+
+  /**
+   * Returns the number of Text records following the given record.
+   *
+   * @param theRecord
+   *          Source, Match or Error record
+   * @return number of Text records
+   */
+  static std::size_t getNumberTextRecords(const Record &theRecord) noexcept;
+
+  /**
+   * Default constructor.
+   */
+  TraceFile() = delete;
+
+  /**
+   * Copy constructor
+   */
+  TraceFile(const TraceFile &) = delete;
+
+  /**
+   * Move constructor
+   */
+  TraceFile(TraceFile &&) = delete;
+
+  /**
+   * Constructor. Maps the trace file.
+   *
+   * @param theFile
+   *          trace file
+   * @param theGrammar
+   *          grammar the trace was recorded with
+   * @throws std::runtime_error
+   *          if the file cannot be mapped, is not a trace, was recorded
+   *          with another grammar, or does not end on a whole record
+   */
+  TraceFile(const std::string &theFile, const Grammar &theGrammar);
+
+  /**
+   * Destructor
+   */
+  ~TraceFile();
+
+  /**
+   * Copy assignment operator
+   */
+  TraceFile& operator=(const TraceFile &) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  TraceFile& operator=(TraceFile &&) = delete;
+
+  /**
+   * Returns the first record.
+   *
+   * @return first record
+   */
+  const Record* begin() const noexcept;
+
+  /**
+   * Returns the end of the records.
+   *
+   * @return one past the last record
+   */
+  const Record* end() const noexcept;
+
+  /**
+   * Returns the name of the trace file.
+   *
+   * @return file name
+   */
+  const std::string& getName() const noexcept;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Value of Header::myMagic */
+  static const char MAGIC[8];
+
+  /** Name of the trace file. */
+  const std::string myFile;
+
+  /** Start of the mapping, the header. */
+  void *myMapping = nullptr;
+
+  /** Size of the mapping, in bytes. */
+  std::size_t myMappingSize = 0;
+
+  /** Number of records. */
+  std::size_t myNumberRecords = 0;
+};
+
+#endif
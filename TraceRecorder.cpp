@@ -0,0 +1,210 @@
+/**
+ * @file TraceRecorder.cpp
+ * @brief Implementation of TraceRecorder class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <stdexcept>
+
+#include "ActionSymbol.h"
+#include "ErrorWarningTracker.h"
+#include "Token.h"
+#include "TraceRecorder.h"
+
+constexpr uint32_t TraceRecorder::BUFFER_RECORDS;
+
+//*******************************************************
+// TraceRecorder::TraceRecorder
+//*******************************************************
+TraceRecorder::TraceRecorder(const std::string &theFile,
+                             const Grammar &theGrammar,
+                             const ErrorWarningTracker &theEWTracker) :
+  myEWTracker(theEWTracker),
+  myFileName(theFile)
+{
+  myFile.open(myFileName, std::ios::out | std::ios::binary | std::ios::trunc);
+  if (! myFile)
+  {
+    auto localErrno = errno;
+    throw std::runtime_error("Failed to open trace file '" + myFileName +
+                             "': " + std::strerror(localErrno));
+  }
+
+  auto header = TraceFile::getHeader(theGrammar);
+  myFile.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+  const auto &sourceFile = myEWTracker.getFile();
+  append({TraceFile::Event::Source, 0, 0,
+          static_cast<uint32_t>(sourceFile.size()), 0, 0});
+  appendText(sourceFile.data(), sourceFile.size());
+}
+
+//*******************************************************
+// TraceRecorder::~TraceRecorder
+//*******************************************************
+TraceRecorder::~TraceRecorder()
+{
+  if (myFile.is_open())
+  {
+    write();
+  }
+}
+
+//*******************************************************
+// TraceRecorder::action
+//*******************************************************
+void TraceRecorder::action(const ActionSymbol &theAction)
+{
+  recordErrors(TraceFile::BEFORE_EVENT);
+  append({TraceFile::Event::Action, 0, theAction.getIndex(), 0,
+          myLine, myColumn});
+}
+
+//*******************************************************
+// TraceRecorder::append
+//*******************************************************
+void TraceRecorder::append(const TraceFile::Record &theRecord)
+{
+  if (BUFFER_RECORDS == myNumberBuffered)
+  {
+    write();
+  }
+  myBuffer[myNumberBuffered++] = theRecord;
+}
+
+//*******************************************************
+// TraceRecorder::appendText
+//*******************************************************
+void TraceRecorder::appendText(const char *theText, uint32_t theLength)
+{
+  for (uint32_t offset = 0; offset < theLength;
+       offset += sizeof(TraceFile::Record))
+  {
+    TraceFile::Record record;
+    std::memset(&record, 0, sizeof(record));
+    std::memcpy(&record, theText + offset,
+                std::min<uint32_t>(sizeof(record), theLength - offset));
+    append(record);
+  }
+}
+
+//*******************************************************
+// TraceRecorder::begin
+//*******************************************************
+void TraceRecorder::begin(const Token &theLookAheadToken)
+{
+  beginStep(theLookAheadToken);
+  recordErrors();
+}
+
+//*******************************************************
+// TraceRecorder::beginStep
+//*******************************************************
+void TraceRecorder::beginStep(const Token &theLookAheadToken)
+{
+  myLine = theLookAheadToken.getLine();
+  myColumn = theLookAheadToken.getColumn();
+}
+
+//*******************************************************
+// TraceRecorder::endOfProduction
+//*******************************************************
+void TraceRecorder::endOfProduction(const SemanticStack::Frame &theFrame)
+{
+  recordErrors(TraceFile::BEFORE_EVENT);
+  append({TraceFile::Event::EOP, 0, 0, 0, myLine, myColumn});
+}
+
+//*******************************************************
+// TraceRecorder::endStep
+//*******************************************************
+void TraceRecorder::endStep(const Token &theLookAheadToken)
+{
+  recordErrors();
+}
+
+//*******************************************************
+// TraceRecorder::finish
+//*******************************************************
+void TraceRecorder::finish()
+{
+  recordErrors();
+  write();
+  myFile.close();
+  if (! myFile)
+  {
+    auto localErrno = errno;
+    throw std::runtime_error("Failed to write trace file '" + myFileName +
+                             "': " + std::strerror(localErrno));
+  }
+}
+
+//*******************************************************
+// TraceRecorder::match
+//*******************************************************
+void TraceRecorder::match(const Token &theToken)
+{
+  recordErrors(TraceFile::BEFORE_EVENT);
+  append({TraceFile::Event::Match, 0, theToken.getTerminalIndex(),
+          theToken.getLength(), theToken.getLine(), theToken.getColumn()});
+  appendText(theToken.getText(), theToken.getLength());
+}
+
+//*******************************************************
+// TraceRecorder::predict
+//*******************************************************
+void TraceRecorder::predict(uint32_t theProductionNumber,
+                            const SemanticStack::Frame &theFrame,
+                            bool theEOPElided)
+{
+  recordErrors(TraceFile::BEFORE_EVENT);
+  append({TraceFile::Event::Predict,
+          theEOPElided ? TraceFile::EOP_ELIDED : uint8_t(0), 0,
+          theProductionNumber, myLine, myColumn});
+}
+
+//*******************************************************
+// TraceRecorder::recordErrors
+//*******************************************************
+void TraceRecorder::recordErrors(uint8_t theFlags)
+{
+  const auto &errors = myEWTracker.getErrors();
+  for (; myNumberErrors < errors.size(); ++myNumberErrors)
+  {
+    const auto &error = errors[myNumberErrors];
+    append({TraceFile::Event::Error, theFlags, 0,
+            static_cast<uint32_t>(error.myMessage.size()),
+            error.myLine, error.myColumn});
+    appendText(error.myMessage.data(), error.myMessage.size());
+  }
+}
+
+//*******************************************************
+// TraceRecorder::skip
+//*******************************************************
+void TraceRecorder::skip(Symbol::Index theSymbol)
+{
+  recordErrors(TraceFile::BEFORE_EVENT);
+  append({TraceFile::Event::Skip, 0, theSymbol, 0, myLine, myColumn});
+}
+
+//*******************************************************
+// TraceRecorder::start
+//*******************************************************
+void TraceRecorder::start()
+{
+}
+
+//*******************************************************
+// TraceRecorder::write
+//*******************************************************
+void TraceRecorder::write()
+{
+  myFile.write(reinterpret_cast<const char*>(myBuffer),
+               myNumberBuffered * sizeof(TraceFile::Record));
+  myNumberBuffered = 0;
+}
@@ -0,0 +1,210 @@
+#ifndef TRACERECORDER_H
+#define TRACERECORDER_H
+
+/**
+ * @file TraceRecorder.h
+ * @brief Defines the tracer recording the parse in a trace file.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "ParseTracer.h"
+#include "TraceFile.h"
+
+class ErrorWarningTracker;
+class Grammar;
+
+/**
+ * Records each step of the parse as a TraceFile::Record, to be printed
+ * later by TraceRenderer. Records are gathered in a fixed buffer and
+ * written a buffer at a time. Recording is not free: in the default
+ * (unoptimized) build a record costs about 30 ns, most of it the tracer
+ * calls and filling in the record, plus writing the file.
+ */
+class TraceRecorder : public ParseTracer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  TraceRecorder() = delete;
+
+  /**
+   * Copy constructor
+   */
+  TraceRecorder(const TraceRecorder&) = delete;
+
+  /**
+   * Move constructor
+   */
+  TraceRecorder(TraceRecorder&&) = delete;
+
+  /**
+   * Constructor. Creates the trace file and writes its header.
+   *
+   * @param theFile
+   *          trace file to write
+   * @param theGrammar
+   *          language grammar
+   * @param theEWTracker
+   *          error/warning tracker of the parse
+   * @throws std::runtime_error
+   *          if the file cannot be created
+   */
+  TraceRecorder(const std::string &theFile, const Grammar &theGrammar,
+                const ErrorWarningTracker &theEWTracker);
+
+  /**
+   * Destructor. Writes any records not yet written, so a parse which
+   * failed still leaves the steps it made.
+   */
+  virtual ~TraceRecorder();
+
+  /**
+   * Copy assignment operator
+   */
+  TraceRecorder& operator=(const TraceRecorder&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  TraceRecorder& operator=(TraceRecorder&&) = delete;
+
+  /**
+   * Records the errors reported before it, then the action.
+   */
+  virtual void action(const ActionSymbol &theAction) override;
+
+  /**
+   * Records the errors from scanning the first token.
+   */
+  virtual void begin(const Token &theLookAheadToken) override;
+
+  /**
+   * Saves the position of the look-ahead token for the step's record.
+   */
+  virtual void beginStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Records the errors reported before it, then the end of production.
+   */
+  virtual void endOfProduction(const SemanticStack::Frame &theFrame)
+    override;
+
+  /**
+   * Records the errors reported during the step after its event.
+   */
+  virtual void endStep(const Token &theLookAheadToken) override;
+
+  /**
+   * Records any errors not yet recorded, writes the remaining records and
+   * closes the file.
+   *
+   * @throws std::runtime_error
+   *          if the file could not be written
+   */
+  virtual void finish() override;
+
+  /**
+   * Records the errors reported before it, then the match and the token's
+   * text.
+   */
+  virtual void match(const Token &theToken) override;
+
+  /**
+   * Records the errors reported before it, then the prediction.
+   */
+  virtual void predict(uint32_t theProductionNumber,
+                       const SemanticStack::Frame &theFrame,
+                       bool theEOPElided) override;
+
+  /**
+   * Records the errors reported before it, then the skipped symbol.
+   */
+  virtual void skip(Symbol::Index theSymbol) override;
+
+  /**
+   * Does nothing, the header is written on construction.
+   */
+  virtual void start() override;
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /** Number of records written at a time. */
+  static constexpr uint32_t BUFFER_RECORDS = 4096;
+
+  /**
+   * Adds a record, writing the buffer first if it is full.
+   *
+   * @param theRecord
+   *          record to add
+   */
+  void append(const TraceFile::Record &theRecord);
+
+  /**
+   * Adds Text records holding the given text.
+   *
+   * @param theText
+   *          text to add
+   * @param theLength
+   *          length of theText
+   */
+  void appendText(const char *theText, uint32_t theLength);
+
+  /**
+   * Adds an Error record, followed by its message, for each error the
+   * parse reported since the last call.
+   *
+   * @param theFlags
+   *          Record::myFlags of the Error records
+   */
+  void recordErrors(uint8_t theFlags = 0);
+
+  /**
+   * Writes the buffered records.
+   */
+  void write();
+
+  /** Records not yet written, the first myNumberBuffered. */
+  TraceFile::Record myBuffer[BUFFER_RECORDS];
+
+  /** Column of the look-ahead token of the current step. */
+  uint32_t myColumn = 0;
+
+  /** Number of records in myBuffer. */
+  uint32_t myNumberBuffered = 0;
+
+  /** Number of the tracker's errors which have been recorded. */
+  std::size_t myNumberErrors = 0;
+
+  /** Error/Warning tracker */
+  const ErrorWarningTracker &myEWTracker;
+
+  /** Trace file. */
+  std::ofstream myFile;
+
+  /** Name of the trace file. */
+  const std::string myFileName;
+
+  /** Line of the look-ahead token of the current step. */
+  uint32_t myLine = 0;
+};
+
+#endif
@@ -0,0 +1,324 @@
+/**
+ * @file TraceRenderer.cpp
+ * @brief Implementation of TraceRenderer class
+ *
+ * @author Michael Albers
+ */
+
+#include <algorithm>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "ActionSymbol.h"
+#include "Grammar.h"
+#include "ParseStack.h"
+#include "ParseStepPrinter.h"
+#include "ParseTablePrinter.h"
+#include "PredictTable.h"
+#include "Production.h"
+#include "SemanticRecord.h"
+#include "SymbolRegistry.h"
+#include "TraceFile.h"
+#include "TraceRenderer.h"
+
+namespace
+{
+  /** The code generated by the replay is not kept. */
+  const std::string GENERATED_CODE_FILE{"/dev/null"};
+}
+
+//*******************************************************
+// TraceRenderer::TraceRenderer
+//*******************************************************
+TraceRenderer::TraceRenderer(const TraceFile &theTraceFile,
+                             const Grammar &theGrammar,
+                             const PredictTable &thePredictTable) :
+  myEWTracker(theTraceFile.getName(), true),
+  myGrammar(theGrammar),
+  myPredictTable(thePredictTable),
+  mySemanticRoutines(GENERATED_CODE_FILE, mySemanticStack, mySymbolTable,
+                     myEWTracker),
+  myTraceFile(theTraceFile)
+{
+  const auto &symbols = myGrammar.getSymbolRegistry();
+
+  // Checks the text of a record fits in the file, returns its first record.
+  auto getText = [this](const TraceFile::Record *theRecord)
+  {
+    if (static_cast<std::size_t>(myTraceFile.end() - theRecord - 1) <
+        TraceFile::getNumberTextRecords(*theRecord))
+    {
+      throwCorrupt(theRecord - myTraceFile.begin());
+    }
+    return reinterpret_cast<const char*>(theRecord + 1);
+  };
+
+  auto source = myTraceFile.begin();
+  if (source == myTraceFile.end() ||
+      TraceFile::Event::Source != source->myEvent)
+  {
+    throwCorrupt(0);
+  }
+  mySourceFile.assign(getText(source), source->myValue);
+  mySteps = source + 1 + TraceFile::getNumberTextRecords(*source);
+
+  // The tokens are needed up front, the tables print those not yet matched.
+  for (auto record = mySteps; record != myTraceFile.end(); ++record)
+  {
+    if (TraceFile::Event::Match == record->myEvent)
+    {
+      if (record->mySymbol >= symbols.getNumberSymbols() ||
+          SymbolRegistry::Kind::Terminal !=
+            symbols.getKind(record->mySymbol))
+      {
+        throwCorrupt(record - myTraceFile.begin());
+      }
+
+      // The text stays in the mapping.
+      Token token;
+      token.setPosition(record->myLine, record->myColumn);
+      token.setTerminal(symbols.getSymbol(record->mySymbol).get());
+      token.append(getText(record), record->myValue);
+      myTokens.push_back(token);
+
+      record += TraceFile::getNumberTextRecords(*record);
+    }
+    else if (TraceFile::Event::Error == record->myEvent)
+    {
+      getText(record);
+      record += TraceFile::getNumberTextRecords(*record);
+    }
+  }
+
+  // A parse cut short before matching anything still has a look-ahead.
+  if (myTokens.empty())
+  {
+    myTokens.emplace_back();
+  }
+}
+
+//*******************************************************
+// TraceRenderer::render
+//*******************************************************
+void TraceRenderer::render(std::ostream &theOS, bool thePrintParse,
+                           bool thePrintGeneration, bool theTables,
+                           uint32_t theFirstLine, uint32_t theLastLine)
+{
+  std::unique_ptr<ParseTracer> tracer;
+  if (theTables)
+  {
+    tracer.reset(new ParseTablePrinter(theOS, myTokens, myGrammar,
+                                       myPredictTable, mySemanticStack,
+                                       mySemanticRoutines, myEWTracker,
+                                       thePrintParse, thePrintGeneration));
+  }
+  else
+  {
+    tracer.reset(new ParseStepPrinter(theOS, myGrammar, mySemanticStack,
+                                      mySemanticRoutines, thePrintParse,
+                                      thePrintGeneration));
+  }
+
+  replay(*tracer, theFirstLine, theLastLine);
+}
+
+//*******************************************************
+// TraceRenderer::replay
+//*******************************************************
+void TraceRenderer::replay(ParseTracer &theTracer, uint32_t theFirstLine,
+                           uint32_t theLastLine)
+{
+  const auto &symbols = myGrammar.getSymbolRegistry();
+  auto numberProductions = myGrammar.getProductions().size();
+
+  // The parse stack is rebuilt as the Parser had it, to check each record
+  // is a step it could have made.
+  ParseStack stack;
+  std::size_t numberMatched = 0;
+
+  auto lookAhead = [&]() -> const Token&
+  {
+    return myTokens[std::min(numberMatched, myTokens.size() - 1)];
+  };
+  auto inRange = [&](uint32_t theLine)
+  {
+    return theLine >= theFirstLine && theLine <= theLastLine;
+  };
+
+  // Error records are replayed where the parse reported them, see
+  // TraceFile. Returns the record after them.
+  auto replayErrors = [&](const TraceFile::Record *theRecord,
+                          bool theBeforeEvent)
+  {
+    while (theRecord != myTraceFile.end() &&
+           TraceFile::Event::Error == theRecord->myEvent &&
+           theBeforeEvent ==
+             ((theRecord->myFlags & TraceFile::BEFORE_EVENT) != 0))
+    {
+      reportError(theRecord);
+      theRecord += 1 + TraceFile::getNumberTextRecords(*theRecord);
+    }
+    return theRecord;
+  };
+
+  mySemanticStack.initialize();
+  stack.start(myGrammar.getStartSymbol()->getIndex());
+
+  theTracer.start();
+  auto record = replayErrors(mySteps, false);
+  if (inRange(lookAhead().getLine()))
+  {
+    theTracer.begin(lookAhead());
+  }
+
+  while (record != myTraceFile.end())
+  {
+    // The step's own record comes after the errors reported before it.
+    auto errors = record;
+    while (record != myTraceFile.end() &&
+           TraceFile::Event::Error == record->myEvent)
+    {
+      record += 1 + TraceFile::getNumberTextRecords(*record);
+    }
+    if (record == myTraceFile.end())
+    {
+      // Only a file cut short ends here, the errors still happened.
+      replayErrors(errors, true);
+      break;
+    }
+
+    auto recordNumber = record - myTraceFile.begin();
+    if (stack.empty())
+    {
+      throwCorrupt(recordNumber);
+    }
+
+    auto expected = stack.back();
+    auto expectedIndex = expected.getIndex();
+    bool print = inRange(record->myLine);
+
+    if (print)
+    {
+      theTracer.beginStep(lookAhead());
+    }
+    if (replayErrors(errors, true) != record)
+    {
+      throwCorrupt(errors - myTraceFile.begin());
+    }
+
+    switch (record->myEvent)
+    {
+      case TraceFile::Event::Predict:
+      {
+        auto productionNumber = record->myValue;
+        bool tail = (record->myFlags & TraceFile::EOP_ELIDED) != 0;
+        if (ParseStackEntry::Kind::NonTerminal != expected.getKind() ||
+            productionNumber < 1 || productionNumber > numberProductions ||
+            myGrammar.getProduction(productionNumber)->getLHS()->getIndex()
+              != expectedIndex ||
+            tail != stack.isTail())
+        {
+          throwCorrupt(recordNumber);
+        }
+
+        auto frame = stack.predict(productionNumber, myPredictTable,
+                                   mySemanticStack);
+        theTracer.predict(productionNumber, frame, tail);
+        break;
+      }
+
+      case TraceFile::Event::Match:
+      {
+        if (ParseStackEntry::Kind::Terminal != expected.getKind() ||
+            record->mySymbol != expectedIndex)
+        {
+          throwCorrupt(recordNumber);
+        }
+
+        Token token{myTokens[numberMatched]};
+        mySemanticStack.replaceAtCurrentIndex(SemanticRecord(
+                                                PlaceholderRecord(token)));
+        stack.pop();
+        theTracer.match(token);
+        ++numberMatched;
+        record += TraceFile::getNumberTextRecords(*record);
+        break;
+      }
+
+      case TraceFile::Event::Action:
+      {
+        if (ParseStackEntry::Kind::Action != expected.getKind() ||
+            record->mySymbol != expectedIndex)
+        {
+          throwCorrupt(recordNumber);
+        }
+
+        stack.pop();
+        const auto &action =
+          static_cast<const ActionSymbol&>(*symbols.getSymbol(expectedIndex));
+        mySemanticRoutines.executeSemanticRoutine(action);
+        theTracer.action(action);
+        break;
+      }
+
+      case TraceFile::Event::EOP:
+        if (ParseStackEntry::Kind::EOP != expected.getKind())
+        {
+          throwCorrupt(recordNumber);
+        }
+
+        theTracer.endOfProduction(stack.endOfProduction(mySemanticStack));
+        break;
+
+      case TraceFile::Event::Skip:
+        if (ParseStackEntry::Kind::EOP == expected.getKind() ||
+            record->mySymbol != expectedIndex)
+        {
+          throwCorrupt(recordNumber);
+        }
+
+        stack.pop();
+        theTracer.skip(expectedIndex);
+        break;
+
+      default:
+        throwCorrupt(recordNumber);
+    }
+
+    record = replayErrors(record + 1, false);
+
+    if (print)
+    {
+      theTracer.endStep(lookAhead());
+    }
+  }
+
+  theTracer.finish();
+}
+
+//*******************************************************
+// TraceRenderer::reportError
+//*******************************************************
+void TraceRenderer::reportError(const TraceFile::Record *theError)
+{
+  std::string message(reinterpret_cast<const char*>(theError + 1),
+                      theError->myValue);
+
+  // Printed as the compiler printed it. The replay's own tracker is quiet,
+  // it only needs to know of the error, and the errors the replayed
+  // semantic routines report again are already among those recorded.
+  ErrorWarningTracker sourceTracker(mySourceFile);
+  sourceTracker.reportError(theError->myLine, theError->myColumn, message);
+  myEWTracker.reportError(theError->myLine, theError->myColumn, message);
+}
+
+//*******************************************************
+// TraceRenderer::throwCorrupt
+//*******************************************************
+void TraceRenderer::throwCorrupt(std::size_t theRecord) const
+{
+  throw std::runtime_error("Trace file '" + myTraceFile.getName() +
+                           "' is corrupt at record " +
+                           std::to_string(theRecord) + ".");
+}
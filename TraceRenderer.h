@@ -0,0 +1,187 @@
+#ifndef TRACERENDERER_H
+#define TRACERENDERER_H
+
+/**
+ * @file TraceRenderer.h
+ * @brief Defines the class printing a recorded parse.
+ *
+ * @author Michael Albers
+ */
+
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "ErrorWarningTracker.h"
+#include "SemanticRoutines.h"
+#include "SemanticStack.h"
+#include "SymbolTable.h"
+#include "Token.h"
+#include "TraceFile.h"
+
+class Grammar;
+class ParseTracer;
+class PredictTable;
+
+/**
+ * Prints a parse recorded by TraceRecorder as the compiler would have
+ * printed it with --parse and --generation (see ParseStepPrinter and
+ * ParseTablePrinter).
+ *
+ * The recorded steps are replayed on a semantic stack and semantic
+ * routines of its own, as the Parser did them, so the printers see the
+ * same state they would have during the parse. Code generated by the
+ * replay is discarded.
+ */
+class TraceRenderer
+{
+  // ************************************************************
+  // Public
+  // ************************************************************
+  public:
+
+  /**
+   * Default constructor
+   */
+  TraceRenderer() = delete;
+
+  /**
+   * Copy constructor
+   */
+  TraceRenderer(const TraceRenderer&) = delete;
+
+  /**
+   * Move constructor
+   */
+  TraceRenderer(TraceRenderer&&) = delete;
+
+  /**
+   * Constructor
+   *
+   * @param theTraceFile
+   *          recorded parse
+   * @param theGrammar
+   *          grammar the parse was recorded with
+   * @param thePredictTable
+   *          predict table of the grammar
+   * @throws std::runtime_error
+   *          if the trace file is corrupt
+   */
+  TraceRenderer(const TraceFile &theTraceFile,
+                const Grammar &theGrammar,
+                const PredictTable &thePredictTable);
+
+  /**
+   * Destructor
+   */
+  ~TraceRenderer() = default;
+
+  /**
+   * Copy assignment operator
+   */
+  TraceRenderer& operator=(const TraceRenderer&) = delete;
+
+  /**
+   * Move assignment operator
+   */
+  TraceRenderer& operator=(TraceRenderer&&) = delete;
+
+  /**
+   * Prints the recorded parse. Only the steps whose look-ahead token is
+   * on the given lines are printed, the others are replayed silently.
+   *
+   * @param theOS
+   *          stream to print to
+   * @param thePrintParse
+   *          print parse steps
+   * @param thePrintGeneration
+   *          print code generation steps
+   * @param theTables
+   *          print tables of the whole parse state (ParseTablePrinter),
+   *          instead of the changes (ParseStepPrinter)
+   * @param theFirstLine
+   *          first source line to print
+   * @param theLastLine
+   *          last source line to print
+   * @throws std::runtime_error
+   *          if the trace file does not hold a parse with the grammar
+   */
+  void render(std::ostream &theOS, bool thePrintParse,
+              bool thePrintGeneration, bool theTables,
+              uint32_t theFirstLine, uint32_t theLastLine);
+
+  // ************************************************************
+  // Protected
+  // ************************************************************
+  protected:
+
+  // ************************************************************
+  // Private
+  // ************************************************************
+  private:
+
+  /**
+   * Replays the recorded parse to the given tracer.
+   *
+   * @param theTracer
+   *          tracer to print with
+   * @param theFirstLine
+   *          first source line to print
+   * @param theLastLine
+   *          last source line to print
+   * @throws std::runtime_error
+   *          if the trace file does not hold a parse with the grammar
+   */
+  void replay(ParseTracer &theTracer, uint32_t theFirstLine,
+              uint32_t theLastLine);
+
+  /**
+   * Prints a recorded error and reports it to the replay.
+   *
+   * @param theError
+   *          Error record, followed by its message
+   */
+  void reportError(const TraceFile::Record *theError);
+
+  /**
+   * Throws the error for a corrupt trace file.
+   *
+   * @param theRecord
+   *          number of the record found corrupt
+   * @throws std::runtime_error
+   *          always
+   */
+  [[noreturn]] void throwCorrupt(std::size_t theRecord) const;
+
+  /** Error/Warning tracker of the replay. */
+  ErrorWarningTracker myEWTracker;
+
+  /** Language grammar */
+  const Grammar &myGrammar;
+
+  /** Production predict table */
+  const PredictTable &myPredictTable;
+
+  /** Semantic routines of the replay. */
+  SemanticRoutines mySemanticRoutines;
+
+  /** Semantic stack of the replay. */
+  SemanticStack mySemanticStack;
+
+  /** Symbol table of the replay. */
+  SymbolTable mySymbolTable;
+
+  /** Source file of the recorded parse. */
+  std::string mySourceFile;
+
+  /** First record after the Source record and its text. */
+  const TraceFile::Record *mySteps = nullptr;
+
+  /** Matched tokens, their text is in the trace file. */
+  std::vector<Token> myTokens;
+
+  /** Recorded parse. */
+  const TraceFile &myTraceFile;
+};
+
+#endif
@@ -0,0 +1,162 @@
+/**
+ * @file TraceRendererMain.cpp
+ * @brief Entry point of the parse trace renderer
+ *
+ * @author Michael Albers
+ */
+
+#include <getopt.h>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+
+#include "ErrorWarningTracker.h"
+#include "Grammar.h"
+#include "GrammarAnalyzer.h"
+#include "PredictTable.h"
+#include "ScannerTable.h"
+#include "TraceFile.h"
+#include "TraceRenderer.h"
+
+static void usage(char *theProgramName);
+
+int main(int argc, char **argv)
+{
+  try
+  {
+    bool printGeneration = false;
+    bool printParse = false;
+    bool traceTables = false;
+    uint32_t firstLine = 0;
+    uint32_t lastLine = std::numeric_limits<uint32_t>::max();
+
+    extern int optind;
+
+    while (true)
+    {
+      enum Option
+      {
+        Generation,
+        Help,
+        Lines,
+        Parse,
+        TraceTables,
+      };
+
+      static struct option options[] = {
+        {"generation", no_argument, 0, Generation},
+        {"help", no_argument, 0, Help},
+        {"lines", required_argument, 0, Lines},
+        {"parse", no_argument, 0, Parse},
+        {"trace-tables", no_argument, 0, TraceTables},
+        {0, 0, 0,  0 }
+      };
+
+      int optionIndex = 0;
+      auto c = ::getopt_long(argc, argv, "",
+                             options, &optionIndex);
+      if (c == -1)
+        break;
+
+      switch (c) {
+        case Generation:
+          printGeneration = true;
+          break;
+
+        case Help:
+          usage(argv[0]);
+          std::exit(0);
+          break;
+
+        case Lines:
+        {
+          // FIRST-LAST, FIRST-, -LAST or LINE
+          std::string lines(optarg);
+          auto dash = lines.find('-');
+          try
+          {
+            std::string first(lines.substr(0, dash));
+            std::string last(std::string::npos == dash ?
+                             first : lines.substr(dash + 1));
+            if (! first.empty())
+            {
+              firstLine = std::stoul(first);
+            }
+            if (! last.empty())
+            {
+              lastLine = std::stoul(last);
+            }
+          }
+          catch (const std::exception&)
+          {
+            throw std::runtime_error("Invalid line range '" + lines +
+                                     "', expected FIRST-LAST.");
+          }
+          break;
+        }
+
+        case Parse:
+          printParse = true;
+          break;
+
+        case TraceTables:
+          traceTables = true;
+          break;
+
+        default:
+          throw std::runtime_error("");
+      }
+    }
+
+    if (argc - optind != 2)
+    {
+      throw std::runtime_error("No grammar and/or trace files provided.");
+    }
+
+    if (! printParse && ! printGeneration)
+    {
+      printParse = true;
+    }
+
+    std::string grammarFile(argv[optind + 0]);
+    std::string traceFile(argv[optind + 1]);
+
+    ErrorWarningTracker ewTracker(grammarFile);
+    ScannerTable scannerTable;
+    Grammar grammar(grammarFile, ewTracker, scannerTable);
+    GrammarAnalyzer grammarAnalyzer(grammar);
+    PredictTable predictTable(grammar);
+
+    TraceFile trace(traceFile, grammar);
+    TraceRenderer renderer(trace, grammar, predictTable);
+    renderer.render(std::cout, printParse, printGeneration, traceTables,
+                    firstLine, lastLine);
+  }
+  catch (const std::exception &exception)
+  {
+    if (std::string(exception.what()).size() > 0)
+    {
+      std::cerr << argv[0] << ": error: " << exception.what() << std::endl;
+    }
+    usage(argv[0]);
+    return 1;
+  }
+
+  return 0;
+}
+
+void usage(char *theProgramName)
+{
+  std::cerr << "Usage: " << theProgramName
+            << " [OPTIONS...] [grammar file] [trace file]" << std::endl
+            << " Prints a parse recorded with --trace-file, as the compiler"
+            << " prints it." << std::endl
+            << " --generation print code generation steps" << std::endl
+            << " --help print this help and exit" << std::endl
+            << " --lines=FIRST-LAST only print the steps at source lines"
+            << " FIRST to LAST" << std::endl
+            << " --parse   print each parse step (the default)" << std::endl
+            << " --trace-tables print steps as tables of the whole parse"
+            << " state" << std::endl;
+}
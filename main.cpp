@@ -7,12 +7,18 @@
 
 #include <getopt.h>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
+#include "EmbeddedGrammar.h"
 #include "ErrorWarningTracker.h"
 #include "Grammar.h"
 #include "GrammarAnalyzer.h"
+#include "GrammarCache.h"
+#include "ParseStepPrinter.h"
+#include "ParseTablePrinter.h"
 #include "Parser.h"
 #include "PredictTable.h"
 #include "Scanner.h"
@@ -20,6 +26,7 @@
 #include "SemanticRoutines.h"
 #include "SemanticStack.h"
 #include "SymbolTable.h"
+#include "TraceRecorder.h"
 
 static void usage(char *theProgramName);
 
@@ -32,6 +39,15 @@ int main(int argc, char **argv)
     bool printParse = false;
     bool printPredictTable = false;
     bool printTokens = false;
+    bool traceTables = false;
+    bool useDirectScanner = true;
+    std::size_t scanChunkSize = 0;
+    auto analyzerMode = GrammarAnalyzer::Mode::Worklist;
+    bool forceRepresentation = false;
+    auto predictRepresentation = PredictTable::Representation::Dense;
+    std::string embeddedGrammarName;
+    std::string grammarCacheFile;
+    std::string traceFile;
 
     extern int optind;
 
@@ -39,21 +55,39 @@ int main(int argc, char **argv)
     {
       enum Option
       {
+        DigraphAnalysis,
+        EmbeddedGrammarName,
         Generation,
         Grammar,
+        GrammarCacheFile,
         Help,
         Parse,
         PredictTable,
+        PredictRepresentation,
+        ScanChunkSize,
+        TableScanner,
         Tokens,
+        TraceFile,
+        TraceTables,
       };
 
       static struct option options[] = {
+        {"digraph-analysis", no_argument, 0, DigraphAnalysis},
+        {"embedded-grammar", required_argument, 0, EmbeddedGrammarName},
         {"generation", no_argument, 0, Generation},
         {"grammar", no_argument, 0, Grammar},
+        {"grammar-cache", required_argument, 0, GrammarCacheFile},
         {"help", no_argument, 0, Help},
         {"parse", no_argument, 0, Parse},
         {"predict-table", no_argument, 0, PredictTable},
+        {"predict-representation", required_argument, 0,
+         PredictRepresentation},
+        // Not in usage, for checking the parallel scan on small sources.
+        {"scan-chunk-size", required_argument, 0, ScanChunkSize},
+        {"table-scanner", no_argument, 0, TableScanner},
         {"tokens", no_argument, 0, Tokens},
+        {"trace-file", required_argument, 0, TraceFile},
+        {"trace-tables", no_argument, 0, TraceTables},
         {0, 0, 0,  0 }
       };
 
@@ -64,6 +98,14 @@ int main(int argc, char **argv)
         break;
 
       switch (c) {
+        case DigraphAnalysis:
+          analyzerMode = GrammarAnalyzer::Mode::Digraph;
+          break;
+
+        case EmbeddedGrammarName:
+          embeddedGrammarName = optarg;
+          break;
+
         case Generation:
           printGeneration = true;
           break;
@@ -72,6 +114,10 @@ int main(int argc, char **argv)
           printGrammar = true;
           break;
 
+        case GrammarCacheFile:
+          grammarCacheFile = optarg;
+          break;
+
         case Help:
           usage(argv[0]);
           std::exit(0);
@@ -85,50 +131,224 @@ int main(int argc, char **argv)
           printPredictTable = true;
           break;
 
+        case PredictRepresentation:
+          forceRepresentation = true;
+          if (std::string("dense") == optarg)
+          {
+            predictRepresentation = PredictTable::Representation::Dense;
+          }
+          else if (std::string("compressed") == optarg)
+          {
+            predictRepresentation = PredictTable::Representation::Compressed;
+          }
+          else
+          {
+            throw std::runtime_error("Unknown predict table representation "
+                                     "'" + std::string(optarg) + "'.");
+          }
+          break;
+
+        case ScanChunkSize:
+        {
+          std::size_t end = 0;
+          try
+          {
+            scanChunkSize = std::stoul(optarg, &end);
+          }
+          catch (const std::exception&)
+          {
+          }
+          if (0 == scanChunkSize || optarg[end] != '\0')
+          {
+            throw std::runtime_error("Invalid scan chunk size '" +
+                                     std::string(optarg) + "'.");
+          }
+        }
+        break;
+
+        case TableScanner:
+          useDirectScanner = false;
+          break;
+
         case Tokens:
           printTokens = true;
           break;
 
+        case TraceFile:
+          traceFile = optarg;
+          break;
+
+        case TraceTables:
+          traceTables = true;
+          break;
+
         default:
           throw std::runtime_error("");
       }
     }
 
-    if (argc - optind != 3)
+    // An embedded grammar takes the place of the grammar file.
+    const EmbeddedGrammar *embeddedGrammar = nullptr;
+    if (! embeddedGrammarName.empty())
+    {
+      embeddedGrammar = EmbeddedGrammar::find(embeddedGrammarName);
+      if (nullptr == embeddedGrammar)
+      {
+        std::string names;
+        for (const auto &name : EmbeddedGrammar::getNames())
+        {
+          names += " " + name;
+        }
+        throw std::runtime_error("Unknown embedded grammar '" +
+                                 embeddedGrammarName + "', embedded " +
+                                 "grammars are:" + names);
+      }
+    }
+
+    if (! traceFile.empty() && (printParse || printGeneration))
+    {
+      throw std::runtime_error("--trace-file records the parse steps, print "
+                               "them with TraceRenderer instead of --parse "
+                               "or --generation.");
+    }
+
+    if (argc - optind != (nullptr == embeddedGrammar ? 3 : 2))
     {
       throw std::runtime_error("No input and/or output files provided.");
     }
 
-    std::string grammarFile(argv[optind + 0]);
-    std::string sourceFile(argv[optind + 1]);
-    std::string generatedCodeFile(argv[optind + 2]);
+    std::string grammarFile(nullptr == embeddedGrammar ?
+                            argv[optind++] : embeddedGrammar->myGrammarFile);
+    std::string sourceFile(argv[optind + 0]);
+    std::string generatedCodeFile(argv[optind + 1]);
 
     ErrorWarningTracker ewTracker(sourceFile);
     ScannerTable scannerTable;
 
-    Grammar grammar(grammarFile, ewTracker, scannerTable);
-    GrammarAnalyzer grammarAnalyzer(grammar);
-    PredictTable predictTable(grammar);
+    // The tables of an embedded grammar or a valid cache replace reading
+    // and analyzing the grammar. The analyzer still runs to print the
+    // grammar, its sets aren't in the tables. An embedded grammar's
+    // scanner and predict tables are used in place.
+    std::unique_ptr<GrammarCache> grammarCache;
+    std::unique_ptr<GrammarCache::Reader> tables;
+    if (nullptr != embeddedGrammar)
+    {
+      tables.reset(new GrammarCache::Reader(
+        embeddedGrammar->myTables,
+        embeddedGrammar->myTables + embeddedGrammar->mySize));
+    }
+    else if (! grammarCacheFile.empty())
+    {
+      grammarCache.reset(new GrammarCache(grammarCacheFile, grammarFile));
+      if (grammarCache->isValid())
+      {
+        tables.reset(new GrammarCache::Reader(grammarCache->getReader()));
+      }
+    }
+
+    std::unique_ptr<Grammar> grammar;
+    std::unique_ptr<GrammarAnalyzer> grammarAnalyzer;
+    std::unique_ptr<PredictTable> predictTable;
+    if (tables)
+    {
+      if (nullptr != embeddedGrammar)
+      {
+        grammar.reset(new Grammar(grammarFile, ewTracker, scannerTable,
+                                  *tables,
+                                  &embeddedGrammar->myScannerTables));
+        predictTable.reset(new PredictTable(
+          *grammar, embeddedGrammar->myPredictTables));
+      }
+      else
+      {
+        grammar.reset(new Grammar(grammarFile, ewTracker, scannerTable,
+                                  *tables));
+        predictTable.reset(new PredictTable(*grammar, *tables));
+      }
+
+      // A loaded table in another representation is rebuilt, the cache is
+      // left as it is.
+      bool rebuildTable = forceRepresentation &&
+        predictRepresentation != predictTable->getRepresentation();
+      if (printGrammar || rebuildTable)
+      {
+        grammarAnalyzer.reset(new GrammarAnalyzer(*grammar, analyzerMode));
+      }
+      if (rebuildTable)
+      {
+        predictTable.reset(new PredictTable(*grammar, predictRepresentation));
+      }
+    }
+    else
+    {
+      grammar.reset(new Grammar(grammarFile, ewTracker, scannerTable));
+      grammarAnalyzer.reset(new GrammarAnalyzer(*grammar, analyzerMode));
+      predictTable.reset(forceRepresentation ?
+                         new PredictTable(*grammar, predictRepresentation) :
+                         new PredictTable(*grammar));
+
+      if (grammarCache)
+      {
+        GrammarCache::Writer writer;
+        grammar->save(writer);
+        predictTable->save(writer);
+        try
+        {
+          grammarCache->save(writer);
+        }
+        catch (const std::exception &exception)
+        {
+          ewTracker.reportWarning(exception.what());
+        }
+      }
+    }
 
     if (printGrammar)
     {
-      std::cout << grammar << std::endl
-                << grammarAnalyzer << std::endl;
+      std::cout << *grammar << std::endl
+                << *grammarAnalyzer << std::endl;
     }
 
     if (printPredictTable)
     {
-      std::cout << predictTable << std::endl;
+      std::cout << *predictTable << std::endl;
     }
 
-    Scanner scanner(sourceFile, scannerTable, ewTracker, printTokens);
+    Scanner scanner(sourceFile, scannerTable, ewTracker, printTokens,
+                    useDirectScanner, scanChunkSize);
 
     SemanticStack semanticStack;
     SymbolTable symbolTable;
     SemanticRoutines semanticRoutines(generatedCodeFile, semanticStack,
                                       symbolTable, ewTracker);
-    Parser parser(scanner, grammar, predictTable, semanticStack,
-                  semanticRoutines, ewTracker, printParse, printGeneration);
+
+    std::unique_ptr<ParseTracer> tracer;
+    if (! traceFile.empty())
+    {
+      tracer.reset(new TraceRecorder(traceFile, *grammar, ewTracker));
+    }
+    else if (printParse || printGeneration)
+    {
+      if (traceTables)
+      {
+        auto tokens = scanner.getRemainingTokens();
+        tracer.reset(new ParseTablePrinter(
+                       std::cout,
+                       std::vector<Token>(tokens.begin(), tokens.end()),
+                       *grammar, *predictTable, semanticStack,
+                       semanticRoutines, ewTracker, printParse,
+                       printGeneration));
+      }
+      else
+      {
+        tracer.reset(new ParseStepPrinter(std::cout, *grammar, semanticStack,
+                                          semanticRoutines, printParse,
+                                          printGeneration));
+      }
+    }
+
+    Parser parser(scanner, *grammar, *predictTable, semanticStack,
+                  semanticRoutines, ewTracker, tracer.get());
   }
   catch (const std::exception &exception)
   {
@@ -148,11 +368,30 @@ void usage(char *theProgramName)
   std::cerr << "Usage: " << theProgramName
             << " [OPTIONS...] [grammer file] [source file] "
             << "[generated code file]" << std::endl
+            << " (a source file of '-' reads standard input)" << std::endl
+            << "        " << theProgramName
+            << " [OPTIONS...] --embedded-grammar=NAME [source file] "
+            << "[generated code file]" << std::endl
             << " --tokens  print tokens in source file" << std::endl
+            << " --digraph-analysis compute first/follow sets by strongly"
+            << " connected components" << std::endl
+            << " --embedded-grammar=NAME use the grammar NAME compiled into"
+            << " the program instead of a grammar file" << std::endl
             << " --grammar print grammar information" << std::endl
+            << " --grammar-cache=FILE load the analyzed grammar from FILE,"
+            << " rebuilding it if it is missing or stale" << std::endl
             << " --help print this help and exit" << std::endl
             << " --parse   print each parse step" << std::endl
             << " --predict-table print predict table" << std::endl
-            << " --generation print code generation steps (WARNING: Slow!)"
-            << std::endl;
+            << " --predict-representation=dense|compressed store the predict"
+            << " table as a 2-D array or a comb vector, instead of choosing"
+            << " by its density" << std::endl
+            << " --table-scanner scan with the scanner table, not a generated"
+            << " scanner" << std::endl
+            << " --trace-file=FILE record the parse steps in FILE, see"
+            << " TraceRenderer" << std::endl
+            << " --trace-tables print --parse and --generation steps as"
+            << " tables of the whole parse state (WARNING: Slow!)"
+            << std::endl
+            << " --generation print code generation steps" << std::endl;
 }